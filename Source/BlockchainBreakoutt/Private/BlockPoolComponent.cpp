@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BlockPoolComponent.h"
+#include "BoardMemoryTags.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+UBlockPoolComponent::UBlockPoolComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+}
+
+AActor* UBlockPoolComponent::Acquire(TSubclassOf<AActor> Class, const FVector& Location, const FRotator& Rotation)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+
+    if (!Class)
+    {
+        return nullptr;
+    }
+
+    FPooledBlockList* FreeList = FreeBlocks.Find(Class);
+    while (FreeList && FreeList->Actors.Num() > 0)
+    {
+        AActor* Actor = FreeList->Actors.Pop(false);
+        if (!IsValid(Actor))
+        {
+            continue;
+        }
+
+        Actor->Tags = Class->GetDefaultObject<AActor>()->Tags;
+        if (const FVector* Scale = SpawnScales.Find(Class))
+        {
+            Actor->SetActorScale3D(*Scale);
+        }
+        Actor->SetActorLocationAndRotation(Location, Rotation);
+        Actor->SetActorHiddenInGame(false);
+        Actor->SetActorEnableCollision(true);
+        Actor->SetActorTickEnabled(true);
+
+        ++NumReused;
+        return Actor;
+    }
+
+    // Blocks are placed by the grid, never nudged out of each other's way
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, Location, Rotation, SpawnParams);
+    if (Actor)
+    {
+        // Blocks are local visuals on every machine; boards replicate their cells instead
+        Actor->SetReplicates(false);
+        ++NumSpawned;
+        SpawnScales.FindOrAdd(Class, Actor->GetActorScale3D());
+    }
+    return Actor;
+}
+
+void UBlockPoolComponent::Release(AActor* Actor)
+{
+    if (!IsValid(Actor))
+    {
+        return;
+    }
+
+    PendingRelease.RemoveSingleSwap(Actor, false);
+    Deactivate(Actor);
+
+    TArray<AActor*>& FreeList = FreeBlocks.FindOrAdd(Actor->GetClass()).Actors;
+    FreeList.AddUnique(Actor);
+}
+
+void UBlockPoolComponent::ReleaseGradually(const TArray<AActor*>& Actors)
+{
+    for (AActor* Actor : Actors)
+    {
+        if (IsValid(Actor))
+        {
+            Actor->SetActorHiddenInGame(true);
+            PendingRelease.AddUnique(Actor);
+        }
+    }
+}
+
+void UBlockPoolComponent::Prewarm(TSubclassOf<AActor> Class, int32 Count)
+{
+    if (Class)
+    {
+        int32& Target = PrewarmTargets.FindOrAdd(Class.Get());
+        Target = FMath::Max(Target, Count);
+    }
+}
+
+int32 UBlockPoolComponent::GetNumFree() const
+{
+    int32 Count = 0;
+    for (const TPair<UClass*, FPooledBlockList>& Pair : FreeBlocks)
+    {
+        Count += Pair.Value.Actors.Num();
+    }
+    return Count;
+}
+
+void UBlockPoolComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    for (int32 Budget = ReleaseBudgetPerFrame; Budget > 0 && PendingRelease.Num() > 0; --Budget)
+    {
+        AActor* Actor = PendingRelease.Pop(false);
+        if (IsValid(Actor))
+        {
+            Deactivate(Actor);
+            FreeBlocks.FindOrAdd(Actor->GetClass()).Actors.AddUnique(Actor);
+        }
+    }
+
+    int32 Budget = PrewarmBudgetPerFrame;
+    for (auto It = PrewarmTargets.CreateIterator(); It && Budget > 0; ++It)
+    {
+        TArray<AActor*>& FreeList = FreeBlocks.FindOrAdd(It.Key()).Actors;
+        while (Budget > 0 && FreeList.Num() < It.Value())
+        {
+            AActor* Actor = SpawnHidden(It.Key());
+            if (!Actor)
+            {
+                break;
+            }
+            FreeList.Add(Actor);
+            --Budget;
+        }
+
+        if (FreeList.Num() >= It.Value())
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+AActor* UBlockPoolComponent::SpawnHidden(TSubclassOf<AActor> Class)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AActor* Owner = GetOwner();
+    AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, Owner->GetActorLocation(), Owner->GetActorRotation(), SpawnParams);
+    if (Actor)
+    {
+        // Blocks are local visuals on every machine; boards replicate their cells instead
+        Actor->SetReplicates(false);
+        ++NumSpawned;
+        SpawnScales.FindOrAdd(Class, Actor->GetActorScale3D());
+        Deactivate(Actor);
+    }
+    return Actor;
+}
+
+void UBlockPoolComponent::Deactivate(AActor* Actor)
+{
+    Actor->SetActorHiddenInGame(true);
+    Actor->SetActorEnableCollision(false);
+    Actor->SetActorTickEnabled(false);
+
+    // Glow and blink effects swap in dynamic materials; put the originals back so the block looks new next time
+    Actor->ForEachComponent<UPrimitiveComponent>(false, [](UPrimitiveComponent* Primitive)
+    {
+        for (int32 i = 0; i < Primitive->GetNumMaterials(); i++)
+        {
+            if (UMaterialInstanceDynamic* Dynamic = Cast<UMaterialInstanceDynamic>(Primitive->GetMaterial(i)))
+            {
+                Primitive->SetMaterial(i, Dynamic->Parent);
+            }
+        }
+    });
+}
+
+void UBlockPoolComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    PendingRelease.Empty();
+    PrewarmTargets.Empty();
+    FreeBlocks.Empty();
+
+    Super::EndPlay(EndPlayReason);
+}
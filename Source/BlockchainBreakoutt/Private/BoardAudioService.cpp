@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardAudioService.h"
+#include "GameFramework/Actor.h"
+
+UBoardAudioService::UBoardAudioService()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UBoardAudioService::RegisterCue(USoundBase* Cue, int32 MaxVoices)
+{
+    if (!Cue || !GetOwner())
+    {
+        return;
+    }
+
+    FCueVoices& Entry = CueVoices.FindOrAdd(Cue);
+    while (Entry.Voices.Num() < FMath::Max(MaxVoices, 1))
+    {
+        if (UAudioComponent* Voice = CreateVoice(Cue))
+        {
+            Entry.Voices.Add(Voice);
+            AllVoices.Add(Voice);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to create audio voice for %s"), *Cue->GetName());
+            break;
+        }
+    }
+}
+
+UAudioComponent* UBoardAudioService::CreateVoice(USoundBase* Cue)
+{
+    AActor* Owner = GetOwner();
+    UAudioComponent* Voice = NewObject<UAudioComponent>(Owner);
+    if (!Voice)
+    {
+        return nullptr;
+    }
+
+    Voice->bAutoActivate = false;
+    Voice->bAutoDestroy = false;
+    Voice->SetSound(Cue);
+
+    if (USceneComponent* Root = Owner->GetRootComponent())
+    {
+        Voice->SetupAttachment(Root);
+    }
+    Voice->RegisterComponent();
+    return Voice;
+}
+
+void UBoardAudioService::PlayCue(USoundBase* Cue)
+{
+    if (Cue && CueVoices.Contains(Cue))
+    {
+        PendingCues.AddUnique(Cue);
+    }
+}
+
+void UBoardAudioService::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    if (PendingCues.Num() == 0)
+    {
+        return;
+    }
+
+    const AActor* Owner = GetOwner();
+    for (USoundBase* Cue : PendingCues)
+    {
+        FCueVoices* Entry = CueVoices.Find(Cue);
+        if (!Entry || Entry->Voices.Num() == 0)
+        {
+            continue;
+        }
+
+        // Prefer an idle voice; otherwise restart the oldest one
+        UAudioComponent* Voice = nullptr;
+        for (int32 i = 0; i < Entry->Voices.Num(); i++)
+        {
+            UAudioComponent* Candidate = Entry->Voices[(Entry->NextVoice + i) % Entry->Voices.Num()];
+            if (Candidate && !Candidate->IsPlaying())
+            {
+                Voice = Candidate;
+                break;
+            }
+        }
+        if (!Voice)
+        {
+            Voice = Entry->Voices[Entry->NextVoice];
+        }
+        Entry->NextVoice = (Entry->Voices.IndexOfByKey(Voice) + 1) % Entry->Voices.Num();
+
+        if (Voice)
+        {
+            if (!Voice->GetAttachParent() && Owner)
+            {
+                Voice->SetWorldLocation(Owner->GetActorLocation());
+            }
+            Voice->Play();
+        }
+    }
+
+    PendingCues.Reset();
+}
+
+void UBoardAudioService::StopAll()
+{
+    PendingCues.Reset();
+    for (UAudioComponent* Voice : AllVoices)
+    {
+        if (Voice)
+        {
+            Voice->Stop();
+        }
+    }
+}
+
+void UBoardAudioService::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    StopAll();
+    CueVoices.Empty();
+    AllVoices.Empty();
+
+    Super::EndPlay(EndPlayReason);
+}
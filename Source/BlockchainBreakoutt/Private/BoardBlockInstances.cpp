@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardBlockInstances.h"
+#include "BoardMemoryTags.h"
+#include "BoardNetState.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Texture2DArray.h"
+#include "GameFramework/Actor.h"
+#include "Materials/MaterialInstanceDynamic.h"
+
+namespace
+{
+    // Empty cells keep their instance, scaled away to nothing
+    const FTransform EmptyCellTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+}
+
+UBoardBlockInstances::UBoardBlockInstances()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetMobility(EComponentMobility::Movable);
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+    NumCustomDataFloats = NumCustomData;
+}
+
+void UBoardBlockInstances::Initialize(int32 Width, int32 Height, int32 InNumTokens)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+
+    // Blocks hidden for the previous board get their meshes back before the instances go
+    for (const TWeakObjectPtr<AActor>& Block : CellBlocks)
+    {
+        SetBlockMeshHidden(Block.Get(), false);
+    }
+
+    GridHeight = Height;
+    NumTokens = InNumTokens;
+
+    const int32 NumCells = Width * Height;
+    CellBlocks.Init(nullptr, NumCells);
+    CellMeshes.Init(nullptr, NumCells);
+    CellTransforms.Init(EmptyCellTransform, NumCells);
+    CellData.Init(0.0f, NumCells * NumCustomData);
+
+    ClearInstances();
+    SetNumCustomDataFloats(NumCustomData);
+    AddInstances(CellTransforms, false, true);
+
+    if (TokenArt && GetMaterial(0))
+    {
+        // A board initializes again for every registry load; the slot already holds the instance made the first time
+        if (!TokenArtMaterial)
+        {
+            TokenArtMaterial = CreateDynamicMaterialInstance(0);
+        }
+        if (TokenArtMaterial)
+        {
+            TokenArtMaterial->SetTextureParameterValue(TEXT("TokenArt"), TokenArt);
+        }
+    }
+    else if (bRenderSettledBlocks)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: instanced blocks have no token art or master material"), *GetName());
+    }
+}
+
+int32 UBoardBlockInstances::GetSlice(uint16 CellCode, int32 InNumTokens)
+{
+    const int32 Token = BoardNetCell::GetToken(CellCode);
+    switch (BoardNetCell::GetKind(CellCode))
+    {
+    case EBoardNetCellKind::Block:
+        return Token;
+    case EBoardNetCellKind::SuperBlock:
+        return InNumTokens + Token;
+    case EBoardNetCellKind::Officer:
+        return InNumTokens * 2;
+    case EBoardNetCellKind::Bomb:
+        return InNumTokens * 2 + 1;
+    default:
+        return 0;
+    }
+}
+
+void UBoardBlockInstances::Sync(const TArray<TArray<AActor*>>& Grid, TFunctionRef<uint16(int32, int32)> GetCellCode, float GlowFactor, float GlowPower)
+{
+    // Blocks that left their cell get their meshes back first, so one that only moved is hidden again below
+    for (int32 x = 0; x < Grid.Num(); ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            AActor* Block = IsValid(Grid[x][y]) ? Grid[x][y] : nullptr;
+            AActor* Drawn = CellBlocks[x * GridHeight + y].Get();
+            if (Drawn && Drawn != Block)
+            {
+                SetBlockMeshHidden(Drawn, false);
+            }
+        }
+    }
+
+    bool bChanged = false;
+    for (int32 x = 0; x < Grid.Num(); ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            const int32 Index = x * GridHeight + y;
+            AActor* Block = IsValid(Grid[x][y]) ? Grid[x][y] : nullptr;
+            if (CellBlocks[Index].Get() != Block)
+            {
+                SetBlockMeshHidden(Block, true);
+                CellBlocks[Index] = Block;
+                CellMeshes[Index] = Block ? Block->FindComponentByClass<UStaticMeshComponent>() : nullptr;
+            }
+
+            FTransform Transform = EmptyCellTransform;
+            float Data[NumCustomData] = { 0.0f, 0.0f, 1.0f, 0.0f };
+            if (Block)
+            {
+                // Follows the actor, so glow and drop animations still move the instance
+                const UStaticMeshComponent* Mesh = CellMeshes[Index].Get();
+                Transform = Mesh ? Mesh->GetComponentTransform() : Block->GetActorTransform();
+
+                const uint16 Code = GetCellCode(x, y);
+                const bool bGlow = (Code & BoardNetCell::Glow) != 0;
+                Data[0] = (float)GetSlice(Code, NumTokens);
+                Data[1] = bGlow ? GlowFactor : 0.0f;
+                Data[2] = bGlow ? GlowPower : 1.0f;
+                Data[3] = bGlow ? 1.0f : 0.0f;
+            }
+
+            if (!Transform.Equals(CellTransforms[Index]))
+            {
+                CellTransforms[Index] = Transform;
+                UpdateInstanceTransform(Index, Transform, true, false, true);
+                bChanged = true;
+            }
+
+            float* Drawn = &CellData[Index * NumCustomData];
+            if (FMemory::Memcmp(Drawn, Data, sizeof(Data)) != 0)
+            {
+                FMemory::Memcpy(Drawn, Data, sizeof(Data));
+                SetCustomData(Index, MakeArrayView(Data), false);
+                bChanged = true;
+            }
+        }
+    }
+
+    if (bChanged)
+    {
+        MarkRenderStateDirty();
+    }
+}
+
+void UBoardBlockInstances::SetBlockMeshHidden(AActor* Block, bool bHidden)
+{
+    if (!IsValid(Block))
+    {
+        return;
+    }
+
+    if (UStaticMeshComponent* Mesh = Block->FindComponentByClass<UStaticMeshComponent>())
+    {
+        Mesh->SetHiddenInGame(bHidden);
+    }
+}
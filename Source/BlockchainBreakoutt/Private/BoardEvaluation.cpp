@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardEvaluation.h"
+#include "BoardFrameArena.h"
+
+FBoardEvaluation FBoardSnapshot::Evaluate() const
+{
+    FBoardEvaluation Result;
+    Result.Generation = Generation;
+
+    for (int32 X = 0; X < Width - 1; ++X)
+    {
+        for (int32 Y = 0; Y < Height - 1; ++Y)
+        {
+            const EBoardCellFlags Cell = GetFlags(X, Y);
+            if (EnumHasAnyFlags(Cell, EBoardCellFlags::TetrisBlock))
+            {
+                if (EnumHasAnyFlags(Cell, EBoardCellFlags::CanClearThreeRows) && !EnumHasAnyFlags(Cell, EBoardCellFlags::CannotBlowUpYet))
+                {
+                    Result.Blasts.Add({ FIntPoint(X, Y), false });
+                }
+            }
+            else if (EnumHasAnyFlags(Cell, EBoardCellFlags::Bomb))
+            {
+                Result.Blasts.Add({ FIntPoint(X, Y), true });
+            }
+        }
+    }
+
+    // Blasts empty whole rows; clusters and pairs are found on the board they leave behind, in the next pass
+    if (Result.Blasts.Num() > 0)
+    {
+        return Result;
+    }
+
+    FBoardArenaMark ArenaMark;
+
+    TBoardArenaArray<bool> Glowing;
+    Glowing.SetNumUninitialized(Width * Height);
+    for (int32 Index = 0; Index < Flags.Num(); ++Index)
+    {
+        Glowing[Index] = EnumHasAnyFlags(Flags[Index], EBoardCellFlags::Glow);
+    }
+
+    const int32 WordsPerRow = Tokens.GetWordsPerRow();
+    TBoardArenaArray<uint64> PairCandidateRows;
+    PairCandidateRows.SetNumZeroed(Height * WordsPerRow);
+
+    for (int32 X = 0; X < Width; ++X)
+    {
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            if (!EnumHasAnyFlags(GetFlags(X, Y), EBoardCellFlags::Occupied))
+            {
+                continue;
+            }
+
+            FBoardCluster Cluster;
+            if ((BlockPairingSet <= 4 && FindCluster(X, Y, 4, Glowing, Cluster)) ||
+                (BlockPairingSet <= 3 && FindCluster(X, Y, 3, Glowing, Cluster)))
+            {
+                for (const FIntPoint& Member : Cluster.Cells)
+                {
+                    Glowing[Member.X * Height + Member.Y] = true;
+                }
+                Result.Clusters.Add(MoveTemp(Cluster));
+                continue;
+            }
+
+            PairCandidateRows[Y * WordsPerRow + X / 64] |= 1ull << (X % 64);
+        }
+    }
+
+    if (BlockPairingSet <= 2)
+    {
+        // Glowing blocks are about to merge and can't start a pair
+        for (int32 X = 0; X < Width; ++X)
+        {
+            for (int32 Y = 0; Y < Height; ++Y)
+            {
+                if (Glowing[X * Height + Y])
+                {
+                    PairCandidateRows[Y * WordsPerRow + X / 64] &= ~(1ull << (X % 64));
+                }
+            }
+        }
+
+        uint64 PairedTokens = 0;
+        Tokens.FindPairs(PairCandidateRows, Result.Pairs, PairedTokens);
+    }
+
+    return Result;
+}
+
+bool FBoardSnapshot::FindCluster(int32 X, int32 Y, int32 Size, TConstArrayView<bool> Glowing, FBoardCluster& OutCluster) const
+{
+    const int32 Token = Tokens.GetCell(X, Y);
+    if (Token == INDEX_NONE || Glowing[X * Height + Y])
+    {
+        return false;
+    }
+
+    // Called for every occupied cell, so its scratch goes back to the arena as soon as it returns
+    FBoardArenaMark ArenaMark;
+    TBoardArenaArray<bool> Visited;
+    Visited.SetNumZeroed(Width * Height);
+    TArray<FIntPoint, TInlineAllocator<16, TBoardArenaAllocator<>>> Matching;
+
+    // Depth first, right, left, up, down, so the first Size cells are the ones nearest the start in that order
+    auto Visit = [&](int32 CellX, int32 CellY, auto&& VisitRef) -> void
+    {
+        Visited[CellX * Height + CellY] = true;
+        Matching.Add(FIntPoint(CellX, CellY));
+
+        static const FIntPoint Directions[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+        for (const FIntPoint& Direction : Directions)
+        {
+            const int32 NeighborX = CellX + Direction.X;
+            const int32 NeighborY = CellY + Direction.Y;
+            if (NeighborX < 0 || NeighborX >= Width || NeighborY < 0 || NeighborY >= Height)
+            {
+                continue;
+            }
+
+            const int32 NeighborIndex = NeighborX * Height + NeighborY;
+            if (!Visited[NeighborIndex] && !Glowing[NeighborIndex] && Tokens.GetCell(NeighborX, NeighborY) == Token)
+            {
+                VisitRef(NeighborX, NeighborY, VisitRef);
+            }
+        }
+    };
+    Visit(X, Y, Visit);
+
+    if (Matching.Num() < Size)
+    {
+        return false;
+    }
+
+    OutCluster.Cells.Append(Matching.GetData(), Size);
+    return true;
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardFrameArena.h"
+
+std::atomic<int64> FBoardFrameArena::TotalAllocations{ 0 };
+std::atomic<int64> FBoardFrameArena::TotalBytes{ 0 };
+std::atomic<int64> FBoardFrameArena::TotalHeapAllocations{ 0 };
+
+FBoardFrameArena::~FBoardFrameArena()
+{
+    for (const FBlock& Block : Blocks)
+    {
+        FMemory::Free(Block.Data);
+    }
+}
+
+void* FBoardFrameArena::Allocate(SIZE_T Size, uint32 Alignment)
+{
+    Alignment = FMath::Max<uint32>(Alignment, 16);
+    TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+    TotalBytes.fetch_add(Size, std::memory_order_relaxed);
+
+    // The first block with room from the current one on; a block too small for this request is skipped, not split
+    while (CurrentBlock < Blocks.Num())
+    {
+        const FBlock& Block = Blocks[CurrentBlock];
+        const SIZE_T Start = Align(Block.Data + Offset, Alignment) - Block.Data;
+        if (Start + Size <= Block.Size)
+        {
+            Offset = Start + Size;
+            return Block.Data + Start;
+        }
+        CurrentBlock++;
+        Offset = 0;
+    }
+
+    // Blocks stay with the arena, so this only happens while it warms up or for an unusually big pass
+    TotalHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    FBlock& Block = Blocks.AddDefaulted_GetRef();
+    Block.Size = FMath::Max(BlockSize, Align(Size, Alignment));
+    Block.Data = (uint8*)FMemory::Malloc(Block.Size, Alignment);
+    CurrentBlock = Blocks.Num() - 1;
+    Offset = Size;
+    return Block.Data;
+}
+
+FBoardArenaStats FBoardFrameArena::GetStats()
+{
+    FBoardArenaStats Stats;
+    Stats.Allocations = TotalAllocations.load(std::memory_order_relaxed);
+    Stats.Bytes = TotalBytes.load(std::memory_order_relaxed);
+    Stats.HeapAllocations = TotalHeapAllocations.load(std::memory_order_relaxed);
+    return Stats;
+}
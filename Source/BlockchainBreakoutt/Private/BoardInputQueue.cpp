@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardInputQueue.h"
+
+void FBoardInputQueue::Push(EBoardCommand Command, double Timestamp)
+{
+    Pending.Add({ Command, Timestamp });
+}
+
+void FBoardInputQueue::PressDirection(EBoardCommand Direction, double Timestamp)
+{
+    (Direction == EBoardCommand::MoveLeft ? bLeftHeld : bRightHeld) = true;
+
+    bShifting = true;
+    ShiftDirection = Direction;
+    ShiftPressedTime = Timestamp;
+    NextRepeatTime = 0.0;
+
+    Push(Direction, Timestamp);
+}
+
+void FBoardInputQueue::ReleaseDirection(EBoardCommand Direction, double Timestamp)
+{
+    (Direction == EBoardCommand::MoveLeft ? bLeftHeld : bRightHeld) = false;
+
+    if (!bShifting || ShiftDirection != Direction)
+    {
+        return;
+    }
+
+    // The other direction is still down: it takes over as if pressed now, without the extra first step
+    const bool bOtherHeld = Direction == EBoardCommand::MoveLeft ? bRightHeld : bLeftHeld;
+    bShifting = bOtherHeld;
+    ShiftDirection = Direction == EBoardCommand::MoveLeft ? EBoardCommand::MoveRight : EBoardCommand::MoveLeft;
+    ShiftPressedTime = Timestamp;
+    NextRepeatTime = 0.0;
+}
+
+void FBoardInputQueue::Update(double Now, float AutoShiftDelay, float AutoRepeatRate, int32 MaxInstantShift)
+{
+    if (!bShifting)
+    {
+        return;
+    }
+
+    if (NextRepeatTime == 0.0)
+    {
+        if (Now < ShiftPressedTime + AutoShiftDelay)
+        {
+            return;
+        }
+        NextRepeatTime = ShiftPressedTime + AutoShiftDelay;
+    }
+
+    if (AutoRepeatRate <= 0.0f)
+    {
+        for (int32 i = 0; i < MaxInstantShift; i++)
+        {
+            Push(ShiftDirection, NextRepeatTime);
+        }
+        NextRepeatTime = Now;
+        return;
+    }
+
+    // A long frame can owe several repeats; each keeps the time it was due so its latency is honest
+    while (NextRepeatTime <= Now)
+    {
+        Push(ShiftDirection, NextRepeatTime);
+        NextRepeatTime += AutoRepeatRate;
+    }
+}
+
+void FBoardInputQueue::Drain(TArray<FBoardInputCommand>& OutCommands, uint64 Step)
+{
+    const int32 First = OutCommands.Num();
+    OutCommands.Append(Pending);
+    Pending.Reset();
+
+    for (int32 i = First; i < OutCommands.Num(); i++)
+    {
+        OutCommands[i].Step = Step;
+    }
+}
+
+void FBoardInputQueue::Reset()
+{
+    bLeftHeld = false;
+    bRightHeld = false;
+    bShifting = false;
+    NextRepeatTime = 0.0;
+    Pending.Reset();
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardMemoryTags.h"
+#include "HAL/IConsoleManager.h"
+
+LLM_DEFINE_TAG(BlockchainBreakout);
+LLM_DEFINE_TAG(BlockchainBreakout_Board);
+LLM_DEFINE_TAG(BlockchainBreakout_Blocks);
+LLM_DEFINE_TAG(BlockchainBreakout_Glow);
+LLM_DEFINE_TAG(BlockchainBreakout_Effects);
+LLM_DEFINE_TAG(BlockchainBreakout_Market);
+LLM_DEFINE_TAG(BlockchainBreakout_UI);
+LLM_DEFINE_TAG(BlockchainBreakout_Rewind);
+
+namespace
+{
+    TAutoConsoleVariable<float> CVarBudgetBoard(TEXT("BlockchainBreakout.MemBudget.Board"), 4.0f, TEXT("MB for board state"));
+    TAutoConsoleVariable<float> CVarBudgetBlocks(TEXT("BlockchainBreakout.MemBudget.Blocks"), 32.0f, TEXT("MB for block actors and components"));
+    TAutoConsoleVariable<float> CVarBudgetGlow(TEXT("BlockchainBreakout.MemBudget.Glow"), 4.0f, TEXT("MB for glow material instances"));
+    TAutoConsoleVariable<float> CVarBudgetEffects(TEXT("BlockchainBreakout.MemBudget.Effects"), 32.0f, TEXT("MB for Niagara effects"));
+    TAutoConsoleVariable<float> CVarBudgetMarket(TEXT("BlockchainBreakout.MemBudget.Market"), 4.0f, TEXT("MB for the market and price streams"));
+    TAutoConsoleVariable<float> CVarBudgetUI(TEXT("BlockchainBreakout.MemBudget.UI"), 16.0f, TEXT("MB for widgets"));
+    TAutoConsoleVariable<float> CVarBudgetRewind(TEXT("BlockchainBreakout.MemBudget.Rewind"), 8.0f, TEXT("MB for rewind frames"));
+
+    FAutoConsoleCommandWithOutputDevice MemReportCommand(
+        TEXT("BlockchainBreakout.MemReport"),
+        TEXT("Current and peak memory per BlockchainBreakout LLM tag against its BlockchainBreakout.MemBudget.* budget; needs -llm"),
+        FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FBoardMemoryReport::Print));
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    struct FTagBudget
+    {
+        const TCHAR* Name;
+        FName TagName;
+        TAutoConsoleVariable<float>& BudgetMB;
+        int64 PeakBytes = 0;
+        bool bWarned = false;
+    };
+
+    // Sampled and printed on the game thread only
+    TArrayView<FTagBudget> GetTagBudgets()
+    {
+        static FTagBudget Budgets[] = {
+            { TEXT("Board"), LLM_TAG_NAME(BlockchainBreakout_Board), CVarBudgetBoard },
+            { TEXT("Blocks"), LLM_TAG_NAME(BlockchainBreakout_Blocks), CVarBudgetBlocks },
+            { TEXT("Glow"), LLM_TAG_NAME(BlockchainBreakout_Glow), CVarBudgetGlow },
+            { TEXT("Effects"), LLM_TAG_NAME(BlockchainBreakout_Effects), CVarBudgetEffects },
+            { TEXT("Market"), LLM_TAG_NAME(BlockchainBreakout_Market), CVarBudgetMarket },
+            { TEXT("UI"), LLM_TAG_NAME(BlockchainBreakout_UI), CVarBudgetUI },
+            { TEXT("Rewind"), LLM_TAG_NAME(BlockchainBreakout_Rewind), CVarBudgetRewind },
+        };
+        return MakeArrayView(Budgets);
+    }
+
+    int64 GetTagBytes(FName TagName)
+    {
+        return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, TagName, ELLMTagSet::None);
+    }
+
+    double ToMB(int64 Bytes)
+    {
+        return (double)Bytes / (1024.0 * 1024.0);
+    }
+#endif
+}
+
+void FBoardMemoryReport::Sample()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    if (!FLowLevelMemTracker::IsEnabled())
+    {
+        return;
+    }
+
+    for (FTagBudget& Budget : GetTagBudgets())
+    {
+        const int64 Bytes = GetTagBytes(Budget.TagName);
+        Budget.PeakBytes = FMath::Max(Budget.PeakBytes, Bytes);
+
+        const float BudgetMB = Budget.BudgetMB.GetValueOnGameThread();
+        if (!Budget.bWarned && BudgetMB > 0.0f && ToMB(Bytes) > BudgetMB)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("BlockchainBreakout/%s uses %.2f MB, over its %.2f MB budget"), Budget.Name, ToMB(Bytes), BudgetMB);
+            Budget.bWarned = true;
+        }
+    }
+#endif
+}
+
+void FBoardMemoryReport::Print(FOutputDevice& Ar)
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    if (!FLowLevelMemTracker::IsEnabled())
+    {
+        Ar.Logf(TEXT("BlockchainBreakout.MemReport: LLM is off; run with -llm"));
+        return;
+    }
+
+    Sample();
+
+    Ar.Logf(TEXT("%-10s %10s %10s %10s"), TEXT("tag (MB)"), TEXT("current"), TEXT("peak"), TEXT("budget"));
+    int64 TotalBytes = 0;
+    int64 TotalPeakBytes = 0;
+    float TotalBudgetMB = 0.0f;
+    for (const FTagBudget& Budget : GetTagBudgets())
+    {
+        const int64 Bytes = GetTagBytes(Budget.TagName);
+        const float BudgetMB = Budget.BudgetMB.GetValueOnGameThread();
+        Ar.Logf(TEXT("%-10s %10.2f %10.2f %10.2f%s"), Budget.Name, ToMB(Bytes), ToMB(Budget.PeakBytes), BudgetMB,
+            BudgetMB > 0.0f && ToMB(Bytes) > BudgetMB ? TEXT("  OVER") : TEXT(""));
+
+        TotalBytes += Bytes;
+        TotalPeakBytes += Budget.PeakBytes;
+        TotalBudgetMB += BudgetMB;
+    }
+    // Peaks of different tags need not coincide, so the summed peak is an upper bound
+    Ar.Logf(TEXT("%-10s %10.2f %10.2f %10.2f"), TEXT("total"), ToMB(TotalBytes), ToMB(TotalPeakBytes), TotalBudgetMB);
+#else
+    Ar.Logf(TEXT("BlockchainBreakout.MemReport: this build has no LLM"));
+#endif
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardNetState.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+void FBoardNetCodec::Encode(const TArray<uint16>& Base, const TArray<uint16>& Cells, TArray<uint8>& OutBits)
+{
+    check(Base.Num() == Cells.Num());
+
+    uint32 Count = 0;
+    for (int32 Index = 0; Index < Cells.Num(); Index++)
+    {
+        Count += Cells[Index] != Base[Index] ? 1 : 0;
+    }
+
+    FBitWriter Writer(0, true);
+    Writer.SerializeIntPacked(Count);
+
+    int32 LastIndex = -1;
+    for (int32 Index = 0; Index < Cells.Num(); Index++)
+    {
+        if (Cells[Index] == Base[Index])
+        {
+            continue;
+        }
+
+        uint32 Skipped = Index - LastIndex - 1;
+        uint32 Code = Cells[Index];
+        Writer.SerializeIntPacked(Skipped);
+        Writer.SerializeInt(Code, BoardNetCell::NumCodes);
+        LastIndex = Index;
+    }
+
+    OutBits = *Writer.GetBuffer();
+    OutBits.SetNum(Writer.GetNumBytes());
+}
+
+bool FBoardNetCodec::Decode(const TArray<uint16>& Base, const TArray<uint8>& Bits, TArray<uint16>& OutCells)
+{
+    if (Bits.Num() == 0)
+    {
+        OutCells = Base;
+        return true;
+    }
+
+    FBitReader Reader(const_cast<uint8*>(Bits.GetData()), Bits.Num() * 8);
+
+    uint32 Count = 0;
+    Reader.SerializeIntPacked(Count);
+
+    TArray<uint16> Cells = Base;
+    int64 Index = -1;
+    for (uint32 i = 0; i < Count && !Reader.IsError(); i++)
+    {
+        uint32 Skipped = 0;
+        uint32 Code = 0;
+        Reader.SerializeIntPacked(Skipped);
+        Reader.SerializeInt(Code, BoardNetCell::NumCodes);
+
+        // In 64 bits a hostile skip can't wrap the index back into the board
+        Index += (int64)Skipped + 1;
+        if (Index >= Cells.Num())
+        {
+            return false;
+        }
+        Cells[Index] = (uint16)Code;
+    }
+
+    if (Reader.IsError())
+    {
+        return false;
+    }
+
+    OutCells = MoveTemp(Cells);
+    return true;
+}
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardPerfCounters.h"
+#include "Algo/Sort.h"
+
+void FBoardPerfCounters::BeginStage(EBoardStage Stage)
+{
+    const uint64 Now = FPlatformTime::Cycles64();
+
+    if (OpenStages.Num() > 0)
+    {
+        FOpenStage& Outer = OpenStages.Last();
+        FrameCycles[(int32)Outer.Stage] += Now - Outer.StartCycles;
+    }
+
+    OpenStages.Add({ Stage, Now });
+}
+
+void FBoardPerfCounters::EndStage()
+{
+    if (OpenStages.Num() == 0)
+    {
+        return;
+    }
+
+    const uint64 Now = FPlatformTime::Cycles64();
+    const FOpenStage Closed = OpenStages.Pop(false);
+    FrameCycles[(int32)Closed.Stage] += Now - Closed.StartCycles;
+
+    // Resume the outer stage from here
+    if (OpenStages.Num() > 0)
+    {
+        OpenStages.Last().StartCycles = Now;
+    }
+}
+
+void FBoardPerfCounters::EndFrame()
+{
+    for (int32 i = 0; i < NumStages; i++)
+    {
+        LastFrameMs[i] = (float)FPlatformTime::ToMilliseconds64(FrameCycles[i]);
+        Window[i][WindowNext] = LastFrameMs[i];
+        FrameCycles[i] = 0;
+    }
+
+    WindowNext = (WindowNext + 1) % WindowSize;
+    WindowCount = FMath::Min(WindowCount + 1, WindowSize);
+}
+
+void FBoardPerfCounters::AddInputLatency(double InputTimestamp, double AppliedTimestamp)
+{
+    LastInputLatencyMs = (float)FMath::Max(0.0, (AppliedTimestamp - InputTimestamp) * 1000.0);
+    InputWindow[InputWindowNext] = LastInputLatencyMs;
+    InputWindowNext = (InputWindowNext + 1) % InputWindowSize;
+    InputWindowCount = FMath::Min(InputWindowCount + 1, InputWindowSize);
+}
+
+void FBoardPerfCounters::FillSnapshot(FBoardPerfSnapshot& OutSnapshot) const
+{
+    float Sorted[WindowSize];
+
+    for (int32 i = 0; i < NumStages; i++)
+    {
+        OutSnapshot.LastFrameMs[i] = LastFrameMs[i];
+
+        if (WindowCount == 0)
+        {
+            OutSnapshot.P50Ms[i] = 0.0f;
+            OutSnapshot.P99Ms[i] = 0.0f;
+            continue;
+        }
+
+        FMemory::Memcpy(Sorted, Window[i], WindowCount * sizeof(float));
+        Algo::Sort(MakeArrayView(Sorted, WindowCount));
+
+        OutSnapshot.P50Ms[i] = Sorted[(WindowCount - 1) / 2];
+        OutSnapshot.P99Ms[i] = Sorted[FMath::Min(WindowCount - 1, (WindowCount * 99) / 100)];
+    }
+
+    OutSnapshot.InputLatencyLastMs = LastInputLatencyMs;
+    OutSnapshot.InputSamples = InputWindowCount;
+    if (InputWindowCount > 0)
+    {
+        FMemory::Memcpy(Sorted, InputWindow, InputWindowCount * sizeof(float));
+        Algo::Sort(MakeArrayView(Sorted, InputWindowCount));
+
+        OutSnapshot.InputLatencyP50Ms = Sorted[(InputWindowCount - 1) / 2];
+        OutSnapshot.InputLatencyP99Ms = Sorted[FMath::Min(InputWindowCount - 1, (InputWindowCount * 99) / 100)];
+    }
+
+    OutSnapshot.SpawnedBlocks = SpawnedBlocks;
+    OutSnapshot.PooledBlocks = PooledBlocks;
+    OutSnapshot.DynamicMaterialInstances = DynamicMaterialInstances;
+    OutSnapshot.Serial++;
+}
+
+const TCHAR* FBoardPerfCounters::GetStageName(EBoardStage Stage)
+{
+    switch (Stage)
+    {
+    case EBoardStage::Fall: return TEXT("Fall");
+    case EBoardStage::Lock: return TEXT("Lock");
+    case EBoardStage::Clears: return TEXT("Clears");
+    case EBoardStage::Combos: return TEXT("Combos");
+    case EBoardStage::Clusters: return TEXT("Clusters");
+    case EBoardStage::Drops: return TEXT("Drops");
+    case EBoardStage::Market: return TEXT("Market");
+    case EBoardStage::Effects: return TEXT("Effects");
+    default: return TEXT("Unknown");
+    }
+}
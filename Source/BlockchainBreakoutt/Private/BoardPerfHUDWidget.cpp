@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardPerfHUDWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/TextBlock.h"
+#include "TetrisGrid.h"
+
+void UBoardPerfHUDWidget::SetGrid(ATetrisGrid* InGrid)
+{
+    Grid = InGrid;
+    LastSerial = MAX_uint32;
+}
+
+void UBoardPerfHUDWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    if (!StatsText && WidgetTree)
+    {
+        StatsText = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("StatsText"));
+        StatsText->SetColorAndOpacity(FSlateColor(FLinearColor::Green));
+        WidgetTree->RootWidget = StatsText;
+    }
+}
+
+void UBoardPerfHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+    Super::NativeTick(MyGeometry, InDeltaTime);
+
+    const ATetrisGrid* GridPtr = Grid.Get();
+    if (!GridPtr || !StatsText)
+    {
+        return;
+    }
+
+    const FBoardPerfSnapshot& Snapshot = GridPtr->GetPerfSnapshot();
+    if (Snapshot.Serial == LastSerial)
+    {
+        return;
+    }
+    LastSerial = Snapshot.Serial;
+
+    TStringBuilder<1024> Text;
+    Text.Appendf(TEXT("%-9s %7s %7s %7s\n"), TEXT("stage"), TEXT("ms"), TEXT("p50"), TEXT("p99"));
+    for (int32 i = 0; i < FBoardPerfSnapshot::NumStages; i++)
+    {
+        Text.Appendf(TEXT("%-9s %7.3f %7.3f %7.3f\n"), FBoardPerfCounters::GetStageName((EBoardStage)i), Snapshot.LastFrameMs[i], Snapshot.P50Ms[i], Snapshot.P99Ms[i]);
+    }
+    Text.Appendf(TEXT("%-9s %7.3f %7.3f %7.3f\n"), TEXT("Input"), Snapshot.InputLatencyLastMs, Snapshot.InputLatencyP50Ms, Snapshot.InputLatencyP99Ms);
+    Text.Appendf(TEXT("\nblock actors %d\n"), Snapshot.LiveBlockActors);
+    Text.Appendf(TEXT("spawned %d / pooled %d\n"), Snapshot.SpawnedBlocks, Snapshot.PooledBlocks);
+    Text.Appendf(TEXT("niagara %d\n"), Snapshot.ActiveNiagaraComponents);
+    Text.Appendf(TEXT("dynamic materials %d\n"), Snapshot.DynamicMaterialInstances);
+    Text.Appendf(TEXT("timers %d\n"), Snapshot.ActiveTimers);
+    Text.Appendf(TEXT("rewind %d frames / %d KB\n"), Snapshot.RewindFrames, Snapshot.RewindBytes / 1024);
+    Text.Appendf(TEXT("net %.0f B/update, keyframe %d B\n"), Snapshot.NetBytesPerUpdate, Snapshot.NetKeyframeBytes);
+    Text.Appendf(TEXT("arena %d allocs / %lld KB, heap %d\n"), Snapshot.ArenaAllocations, Snapshot.ArenaBytes / 1024, Snapshot.ArenaHeapAllocations);
+
+    StatsText->SetText(FText::FromString(FString(Text.ToView())));
+}
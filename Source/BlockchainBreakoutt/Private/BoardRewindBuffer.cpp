@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardRewindBuffer.h"
+
+namespace
+{
+    void WriteVarInt(TArray<uint8>& Out, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Out.Add((uint8)(Value | 0x80));
+            Value >>= 7;
+        }
+        Out.Add((uint8)Value);
+    }
+
+    uint32 ReadVarInt(const TArray<uint8>& In, int32& Pos)
+    {
+        uint32 Value = 0;
+        for (int32 Shift = 0; Pos < In.Num() && Shift < 32; Shift += 7)
+        {
+            const uint8 Byte = In[Pos++];
+            Value |= (uint32)(Byte & 0x7f) << Shift;
+            if ((Byte & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        return Value;
+    }
+
+    // First byte of a delta
+    constexpr uint8 DeltaXor = 0; // same size: (zero run, literal count, literal bytes)*
+    constexpr uint8 DeltaRaw = 1; // size changed (new level layout, tokens added): the whole older frame
+}
+
+void FBoardRewindBuffer::SetCapacity(int32 InCapacity)
+{
+    Reset();
+    Capacity = FMath::Max(InCapacity, 1);
+}
+
+void FBoardRewindBuffer::Push(TArray<uint8>&& Frame, double Time)
+{
+    if (Latest.Num() > 0)
+    {
+        if (Deltas.Num() < Capacity)
+        {
+            Deltas.SetNum(Capacity);
+        }
+
+        NewestDelta = (NewestDelta + 1) % Capacity;
+        NumDeltas = FMath::Min(NumDeltas + 1, Capacity);
+
+        FDelta& Delta = Deltas[NewestDelta];
+        EncodeDelta(Frame, Latest, Delta.Bytes);
+        Delta.Time = LatestTime;
+    }
+
+    Latest = MoveTemp(Frame);
+    LatestTime = Time;
+}
+
+bool FBoardRewindBuffer::GetFrame(int32 StepsBack, TArray<uint8>& OutFrame) const
+{
+    if (StepsBack < 0 || StepsBack >= Num())
+    {
+        return false;
+    }
+
+    OutFrame = Latest;
+    for (int32 Step = 1; Step <= StepsBack; Step++)
+    {
+        ApplyDelta(OutFrame, Deltas[DeltaIndex(Step)].Bytes);
+    }
+    return true;
+}
+
+double FBoardRewindBuffer::GetTime(int32 StepsBack) const
+{
+    return StepsBack == 0 ? LatestTime : Deltas[DeltaIndex(StepsBack)].Time;
+}
+
+int32 FBoardRewindBuffer::FindStepsBack(double Now, double Seconds) const
+{
+    int32 StepsBack = 0;
+    while (StepsBack + 1 < Num() && Now - GetTime(StepsBack) < Seconds)
+    {
+        StepsBack++;
+    }
+    return StepsBack;
+}
+
+void FBoardRewindBuffer::DiscardNewest(int32 Count)
+{
+    if (Count <= 0)
+    {
+        return;
+    }
+    if (Count >= Num())
+    {
+        Reset();
+        return;
+    }
+
+    TArray<uint8> Frame;
+    GetFrame(Count, Frame);
+    LatestTime = GetTime(Count);
+    Latest = MoveTemp(Frame);
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        Deltas[NewestDelta].Bytes.Empty();
+        NewestDelta = (NewestDelta - 1 + Capacity) % Capacity;
+    }
+    NumDeltas -= Count;
+}
+
+void FBoardRewindBuffer::Reset()
+{
+    Latest.Empty();
+    Deltas.Empty();
+    NewestDelta = -1;
+    NumDeltas = 0;
+}
+
+SIZE_T FBoardRewindBuffer::GetAllocatedSize() const
+{
+    SIZE_T Size = Latest.GetAllocatedSize() + Deltas.GetAllocatedSize();
+    for (const FDelta& Delta : Deltas)
+    {
+        Size += Delta.Bytes.GetAllocatedSize();
+    }
+    return Size;
+}
+
+void FBoardRewindBuffer::EncodeDelta(const TArray<uint8>& From, const TArray<uint8>& To, TArray<uint8>& OutDelta)
+{
+    OutDelta.Reset();
+
+    if (From.Num() != To.Num())
+    {
+        OutDelta.Add(DeltaRaw);
+        OutDelta.Append(To);
+        OutDelta.Shrink();
+        return;
+    }
+
+    OutDelta.Add(DeltaXor);
+
+    int32 Pos = 0;
+    while (Pos < To.Num())
+    {
+        const int32 RunStart = Pos;
+        while (Pos < To.Num() && From[Pos] == To[Pos])
+        {
+            Pos++;
+        }
+        const int32 LiteralStart = Pos;
+        while (Pos < To.Num() && From[Pos] != To[Pos])
+        {
+            Pos++;
+        }
+
+        WriteVarInt(OutDelta, LiteralStart - RunStart);
+        WriteVarInt(OutDelta, Pos - LiteralStart);
+        for (int32 i = LiteralStart; i < Pos; i++)
+        {
+            OutDelta.Add(From[i] ^ To[i]);
+        }
+    }
+
+    // Deltas live for minutes; don't keep the slack
+    OutDelta.Shrink();
+}
+
+void FBoardRewindBuffer::ApplyDelta(TArray<uint8>& InOutFrame, const TArray<uint8>& Delta)
+{
+    if (Delta.Num() == 0)
+    {
+        return;
+    }
+
+    if (Delta[0] == DeltaRaw)
+    {
+        InOutFrame = TArray<uint8>(Delta.GetData() + 1, Delta.Num() - 1);
+        return;
+    }
+
+    int32 Read = 1;
+    int32 Pos = 0;
+    while (Read < Delta.Num())
+    {
+        Pos += ReadVarInt(Delta, Read);
+        const int32 LiteralCount = ReadVarInt(Delta, Read);
+        for (int32 i = 0; i < LiteralCount && Pos < InOutFrame.Num() && Read < Delta.Num(); i++)
+        {
+            InOutFrame[Pos++] ^= Delta[Read++];
+        }
+    }
+}
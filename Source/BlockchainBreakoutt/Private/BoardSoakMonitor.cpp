@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardSoakMonitor.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "NiagaraComponent.h"
+#include "UObject/UObjectIterator.h"
+
+void FBoardSoakMonitor::Start(int32 InTargetPieces, int32 InWarmupPieces, int32 InSampleEveryPieces)
+{
+    bRunning = true;
+    TargetPieces = FMath::Max(InTargetPieces, 1);
+    WarmupPieces = FMath::Clamp(InWarmupPieces, 0, TargetPieces - 1);
+    SampleEveryPieces = FMath::Max(InSampleEveryPieces, 1);
+    Pieces = 0;
+    Samples.Reset();
+    bSamplePending = false;
+    bFinalPending = false;
+
+    UE_LOG(LogTemp, Display, TEXT("Board soak: %d pieces, baseline after %d, sampling every %d"), TargetPieces, WarmupPieces, SampleEveryPieces);
+}
+
+bool FBoardSoakMonitor::OnPieceSpawned()
+{
+    if (!bRunning)
+    {
+        return false;
+    }
+
+    ++Pieces;
+
+    if (Pieces >= WarmupPieces && (Pieces - WarmupPieces) % SampleEveryPieces == 0)
+    {
+        RequestSample();
+    }
+
+    return Pieces >= TargetPieces;
+}
+
+void FBoardSoakMonitor::RequestFinish()
+{
+    bRunning = false;
+    bFinalPending = true;
+    RequestSample();
+}
+
+void FBoardSoakMonitor::RequestSample()
+{
+    // Let anything already unreferenced go first so only live objects are counted
+    GEngine->ForceGarbageCollection(true);
+    bSamplePending = true;
+    SampleRequestFrame = GFrameCounter;
+}
+
+bool FBoardSoakMonitor::Tick(UWorld* World, bool& bOutPassed)
+{
+    if (!bSamplePending || GFrameCounter <= SampleRequestFrame)
+    {
+        return false;
+    }
+    bSamplePending = false;
+
+    Samples.Add(TakeSample(World));
+    if (!bFinalPending)
+    {
+        LogSample(Samples.Num() == 1 ? TEXT("baseline") : TEXT("sample"), Samples.Last());
+        return false;
+    }
+
+    bFinalPending = false;
+    LogSample(TEXT("final"), Samples.Last());
+    bOutPassed = Judge();
+    return true;
+}
+
+bool FBoardSoakMonitor::Judge() const
+{
+    if (Samples.Num() < 3)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Board soak: too few samples to judge growth"));
+        return true;
+    }
+
+    const FBoardSoakSample& Baseline = Samples[0];
+    const FBoardSoakSample& Final = Samples.Last();
+    const int32 SecondHalf = Samples.Num() / 2;
+    bool bPassed = true;
+
+    auto Check = [&](const TCHAR* Name, auto Getter, int64 Tolerance)
+    {
+        const int64 Growth = (int64)Getter(Final) - (int64)Getter(Baseline);
+
+        bool bAlwaysRising = true;
+        for (int32 i = SecondHalf + 1; i < Samples.Num(); i++)
+        {
+            bAlwaysRising &= Getter(Samples[i]) > Getter(Samples[i - 1]);
+        }
+
+        if (Growth > Tolerance && bAlwaysRising)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Board soak: %s grew by %lld (tolerance %lld) and never levelled off"), Name, Growth, Tolerance);
+            bPassed = false;
+        }
+    };
+
+    Check(TEXT("UObjects"), [](const FBoardSoakSample& S) { return (int64)S.UObjects; }, FMath::Max<int64>(500, Baseline.UObjects / 20));
+    Check(TEXT("actors"), [](const FBoardSoakSample& S) { return (int64)S.Actors; }, 64);
+    Check(TEXT("widgets"), [](const FBoardSoakSample& S) { return (int64)S.Widgets; }, 4);
+    Check(TEXT("dynamic materials"), [](const FBoardSoakSample& S) { return (int64)S.DynamicMaterials; }, 16);
+    Check(TEXT("Niagara components"), [](const FBoardSoakSample& S) { return (int64)S.NiagaraComponents; }, 16);
+    Check(TEXT("audio components"), [](const FBoardSoakSample& S) { return (int64)S.AudioComponents; }, 8);
+    Check(TEXT("used physical MB"), [](const FBoardSoakSample& S) { return (int64)S.UsedPhysicalMB; }, 128);
+
+    if (bPassed)
+    {
+        UE_LOG(LogTemp, Display, TEXT("Board soak passed after %d pieces"), Pieces);
+    }
+    return bPassed;
+}
+
+FBoardSoakSample FBoardSoakMonitor::TakeSample(UWorld* World) const
+{
+    FBoardSoakSample Sample;
+    Sample.Pieces = Pieces;
+    Sample.UObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+    Sample.Actors = World ? World->GetActorCount() : 0;
+    Sample.UsedPhysicalMB = FPlatformMemory::GetStats().UsedPhysical / (1024 * 1024);
+
+    for (TObjectIterator<UUserWidget> It; It; ++It)
+    {
+        Sample.Widgets += It->GetWorld() == World ? 1 : 0;
+    }
+    for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It)
+    {
+        Sample.DynamicMaterials++;
+    }
+    for (TObjectIterator<UNiagaraComponent> It; It; ++It)
+    {
+        Sample.NiagaraComponents += It->GetWorld() == World ? 1 : 0;
+    }
+    for (TObjectIterator<UAudioComponent> It; It; ++It)
+    {
+        Sample.AudioComponents += It->GetWorld() == World ? 1 : 0;
+    }
+
+    return Sample;
+}
+
+void FBoardSoakMonitor::LogSample(const TCHAR* Label, const FBoardSoakSample& Sample)
+{
+    UE_LOG(LogTemp, Display, TEXT("Board soak %s @%d pieces: objects %d, actors %d, widgets %d, MIDs %d, niagara %d, audio %d, memory %llu MB"),
+        Label, Sample.Pieces, Sample.UObjects, Sample.Actors, Sample.Widgets, Sample.DynamicMaterials, Sample.NiagaraComponents, Sample.AudioComponents, Sample.UsedPhysicalMB);
+}
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardStateQuad.h"
+#include "BoardBlockInstances.h"
+#include "BoardMemoryTags.h"
+#include "BoardNetState.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/ConstructorHelpers.h"
+
+UBoardStateQuad::UBoardStateQuad()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetMobility(EComponentMobility::Movable);
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+    SetCastShadow(false);
+
+    // Stays out of sight until Initialize finds it has something to draw with
+    SetHiddenInGame(true);
+
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> PlaneBase(TEXT("/Engine/BasicShapes/Plane"));
+    if (PlaneBase.Succeeded())
+    {
+        SetStaticMesh(PlaneBase.Object);
+    }
+
+    // The plane lies in XY; the board stands in XZ
+    SetRelativeRotation(FRotator(0.0f, 0.0f, 90.0f));
+}
+
+void UBoardStateQuad::Initialize(int32 InWidth, int32 InHeight, int32 InNumTokens, const FVector& BottomLeftCell, const FVector& TopRightCell, float CellSize)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+
+    // Blocks hidden for the previous board get their meshes back
+    for (const TWeakObjectPtr<AActor>& Block : HiddenBlocks)
+    {
+        UBoardBlockInstances::SetBlockMeshHidden(Block.Get(), false);
+    }
+
+    Width = InWidth;
+    Height = InHeight;
+    NumTokens = InNumTokens;
+
+    Cells.Init(0, Width * Height * BytesPerCell);
+    DirtyRows.Init(true, Height);
+    bAnyDirty = true;
+    CellBlocks.Init(nullptr, Width * Height);
+    HiddenBlocks.Init(nullptr, Width * Height);
+    LastGlowFactor = -1.0f;
+    LastGlowPower = -1.0f;
+
+    // A board the same size keeps its texture; every row is dirty, so the next Flush rewrites all of it
+    if (!BoardState || BoardState->GetSizeX() != Width || BoardState->GetSizeY() != Height)
+    {
+        BoardState = UTexture2D::CreateTransient(Width, Height, PF_R8G8);
+        if (BoardState)
+        {
+            BoardState->Filter = TF_Nearest;
+            BoardState->SRGB = false;
+            BoardState->NeverStream = true;
+            BoardState->UpdateResource();
+        }
+    }
+
+    if (!BoardMaterial && BoardState && GetMaterial(0))
+    {
+        BoardMaterial = CreateDynamicMaterialInstance(0);
+    }
+    if (BoardState && BoardMaterial)
+    {
+        BoardMaterial->SetTextureParameterValue(TEXT("BoardState"), BoardState);
+        BoardMaterial->SetScalarParameterValue(TEXT("BoardWidth"), (float)Width);
+        BoardMaterial->SetScalarParameterValue(TEXT("BoardHeight"), (float)Height);
+    }
+    else if (bRenderBoardTexture)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: board texture has no material to draw with"), *GetName());
+    }
+
+    // Cover the cells edge to edge, not centre to centre
+    const FVector MeshSize = GetStaticMesh() ? GetStaticMesh()->GetBounds().BoxExtent * 2.0f : FVector(100.0f);
+    SetWorldLocation((BottomLeftCell + TopRightCell) * 0.5f);
+    SetRelativeScale3D(FVector(Width * CellSize / FMath::Max(MeshSize.X, 1.0f), Height * CellSize / FMath::Max(MeshSize.Y, 1.0f), 1.0f));
+    SetHiddenInGame(!IsRenderingBoard());
+}
+
+void UBoardStateQuad::SetCell(int32 X, int32 Y, AActor* Block, uint16 CellCode)
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+    {
+        return;
+    }
+
+    const bool bEmpty = BoardNetCell::GetKind(CellCode) == EBoardNetCellKind::Empty;
+    uint8 Flags = 0;
+    Flags |= (CellCode & BoardNetCell::CanClearThreeRows) ? 1 : 0;
+    Flags |= (CellCode & BoardNetCell::CannotBlowUpYet) ? 2 : 0;
+    Flags |= (CellCode & BoardNetCell::Glow) ? 4 : 0;
+
+    const int32 Index = Y * Width + X;
+    const uint8 Slice = bEmpty ? 0 : (uint8)(UBoardBlockInstances::GetSlice(CellCode, NumTokens) + 1);
+    uint8* Texel = &Cells[Index * BytesPerCell];
+    if (Texel[0] != Slice || Texel[1] != Flags || CellBlocks[Index].Get() != Block)
+    {
+        Texel[0] = Slice;
+        Texel[1] = Flags;
+        CellBlocks[Index] = Block;
+        DirtyRows[Y] = true;
+        bAnyDirty = true;
+    }
+}
+
+void UBoardStateQuad::Flush(float GlowFactor, float GlowPower)
+{
+    if (!IsRenderingBoard())
+    {
+        return;
+    }
+
+    if (GlowFactor != LastGlowFactor || GlowPower != LastGlowPower)
+    {
+        LastGlowFactor = GlowFactor;
+        LastGlowPower = GlowPower;
+        BoardMaterial->SetScalarParameterValue(TEXT("GlowFactor"), GlowFactor);
+        BoardMaterial->SetScalarParameterValue(TEXT("GlowPower"), GlowPower);
+    }
+
+    if (!bAnyDirty)
+    {
+        return;
+    }
+    bAnyDirty = false;
+
+    // Blocks that left a changed cell get their meshes back first, so one that only moved is hidden again below
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; DirtyRows[Y] && X < Width; ++X)
+        {
+            AActor* Hidden = HiddenBlocks[Y * Width + X].Get();
+            if (Hidden && Hidden != CellBlocks[Y * Width + X].Get())
+            {
+                UBoardBlockInstances::SetBlockMeshHidden(Hidden, false);
+            }
+        }
+    }
+
+    const int32 Pitch = Width * BytesPerCell;
+    int32 NumDirtyRows = 0;
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        for (int32 X = 0; DirtyRows[Y] && X < Width; ++X)
+        {
+            const int32 Index = Y * Width + X;
+            AActor* Block = CellBlocks[Index].Get();
+            if (Block != HiddenBlocks[Index].Get())
+            {
+                UBoardBlockInstances::SetBlockMeshHidden(Block, true);
+                HiddenBlocks[Index] = Block;
+            }
+        }
+        NumDirtyRows += DirtyRows[Y] ? 1 : 0;
+    }
+
+    // Changed rows are packed together; runs of neighbouring rows go up as one region. The render thread frees both.
+    uint8* Data = (uint8*)FMemory::Malloc(NumDirtyRows * Pitch);
+    FUpdateTextureRegion2D* Regions = new FUpdateTextureRegion2D[NumDirtyRows];
+    int32 NumRegions = 0;
+    int32 Packed = 0;
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        if (!DirtyRows[Y])
+        {
+            continue;
+        }
+        DirtyRows[Y] = false;
+
+        FMemory::Memcpy(Data + Packed * Pitch, &Cells[Y * Pitch], Pitch);
+        if (NumRegions > 0 && Regions[NumRegions - 1].DestY + Regions[NumRegions - 1].Height == (uint32)Y)
+        {
+            Regions[NumRegions - 1].Height++;
+        }
+        else
+        {
+            Regions[NumRegions++] = FUpdateTextureRegion2D(0, Y, 0, Packed, Width, 1);
+        }
+        Packed++;
+    }
+
+    UploadedBytes += NumDirtyRows * Pitch;
+    BoardState->UpdateTextureRegions(0, NumRegions, Regions, Pitch, BytesPerCell, Data,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* SrcRegions)
+        {
+            FMemory::Free(SrcData);
+            delete[] SrcRegions;
+        });
+}
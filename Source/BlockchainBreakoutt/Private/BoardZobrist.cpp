@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BoardZobrist.h"
+#include "MarketEngine.h"
+
+namespace
+{
+    enum class EZobristFeature : uint64
+    {
+        Cell = 1,
+        Placed,
+        PieceShape,
+        PieceRotation,
+        PieceX,
+        PieceY,
+        PieceToken,
+        Price,
+        MarketEvent,
+    };
+
+    // SplitMix64 of a feature id; changing the seed changes every hash ever recorded
+    uint64 MakeKey(EZobristFeature Feature, uint64 Id)
+    {
+        uint64 Z = 0x42424242DEADBEEFull + (((uint64)Feature << 40) | Id) * 0x9E3779B97F4A7C15ull;
+        Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+        return Z ^ (Z >> 31);
+    }
+}
+
+void FBoardZobrist::Reset(int32 InWidth, int32 InHeight)
+{
+    Width = InWidth;
+    Height = InHeight;
+    CellsHash = 0;
+
+    const int32 NumCells = Width * Height;
+    Cells.Init(0, NumCells);
+
+    CellKeys.SetNumUninitialized(NumCells * KeysPerCell);
+    PlacedKeys.SetNumUninitialized(NumCells);
+    for (int32 Index = 0; Index < NumCells; Index++)
+    {
+        for (int32 Key = 0; Key < KeysPerCell; Key++)
+        {
+            CellKeys[Index * KeysPerCell + Key] = MakeKey(EZobristFeature::Cell, Index * KeysPerCell + Key);
+        }
+        PlacedKeys[Index] = MakeKey(EZobristFeature::Placed, Index);
+    }
+}
+
+uint64 FBoardZobrist::GetCellKey(int32 Index, uint16 Code) const
+{
+    const EBoardNetCellKind Kind = BoardNetCell::GetKind(Code);
+    if (Kind == EBoardNetCellKind::Empty)
+    {
+        return 0;
+    }
+
+    const uint64* Keys = &CellKeys[Index * KeysPerCell];
+    uint64 Key = Keys[(int32)Kind] ^ Keys[NumKinds + BoardNetCell::GetToken(Code)];
+    Key ^= (Code & BoardNetCell::CanClearThreeRows) ? Keys[NumKinds + NumTokens] : 0;
+    Key ^= (Code & BoardNetCell::CannotBlowUpYet) ? Keys[NumKinds + NumTokens + 1] : 0;
+    return Key;
+}
+
+void FBoardZobrist::SetCell(int32 X, int32 Y, uint16 Code)
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+    {
+        return;
+    }
+
+    const int32 Index = X * Height + Y;
+    Code = (uint16)(Code & ~BoardNetCell::Glow);
+    if (Cells[Index] != Code)
+    {
+        CellsHash ^= GetCellKey(Index, Cells[Index]) ^ GetCellKey(Index, Code);
+        Cells[Index] = Code;
+    }
+}
+
+uint64 FBoardZobrist::HashCells(const TArray<uint16>& Codes) const
+{
+    check(Codes.Num() == Cells.Num());
+
+    uint64 Hash = 0;
+    for (int32 Index = 0; Index < Codes.Num(); Index++)
+    {
+        Hash ^= GetCellKey(Index, (uint16)(Codes[Index] & ~BoardNetCell::Glow));
+    }
+    return Hash;
+}
+
+uint64 FBoardZobrist::GetPieceKey(const FBoardNetPiece& Piece) const
+{
+    if (Piece.Shape == FBoardNetPiece::NoPiece)
+    {
+        return 0;
+    }
+
+    uint64 Key = MakeKey(EZobristFeature::PieceShape, Piece.Shape)
+        ^ MakeKey(EZobristFeature::PieceRotation, Piece.Rotation)
+        ^ MakeKey(EZobristFeature::PieceX, (uint8)Piece.X)
+        ^ MakeKey(EZobristFeature::PieceY, (uint8)Piece.Y);
+    for (int32 Block = 0; Block < Piece.Tokens.Num(); Block++)
+    {
+        Key ^= MakeKey(EZobristFeature::PieceToken, Block * NumTokens + (Piece.Tokens[Block] % NumTokens));
+    }
+    return Key;
+}
+
+uint64 FBoardZobrist::GetMarketKey(const FMarketEngine& Market, int32 Event) const
+{
+    uint64 Key = MakeKey(EZobristFeature::MarketEvent, (uint64)(uint32)Event);
+
+    // Half-octave buckets: block values follow prices, but a tick's worth of drift shouldn't make a new position
+    const int32 NumMarketTokens = FMath::Min(Market.Num(), MaxTokens);
+    for (int32 Token = 0; Token < NumMarketTokens; Token++)
+    {
+        const int32 Bucket = FMath::Clamp(FMath::FloorToInt(FMath::Log2(Market.GetPrice(Token)) * 2.0f), 0, NumPriceBuckets - 1);
+        Key ^= MakeKey(EZobristFeature::Price, Token * NumPriceBuckets + Bucket);
+    }
+    return Key;
+}
@@ -0,0 +1,332 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BreakoutSimCommandlet.h"
+#include "BreakoutSimulation.h"
+#include "TetrisGrid.h"
+#include "TokenRegistry.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    struct FSimPolicy
+    {
+        const TCHAR* Name;
+        EBreakoutBotPolicy Policy;
+    };
+
+    const FSimPolicy Policies[] = {
+        { TEXT("greedy"), EBreakoutBotPolicy::Greedy },
+        { TEXT("token"), EBreakoutBotPolicy::TokenGreedy },
+        { TEXT("random"), EBreakoutBotPolicy::Random },
+    };
+
+    const TCHAR* GetEndName(EBreakoutSimEnd End)
+    {
+        switch (End)
+        {
+        case EBreakoutSimEnd::Target: return TEXT("target");
+        case EBreakoutSimEnd::TopOut: return TEXT("top_out");
+        case EBreakoutSimEnd::OfficerTopOut: return TEXT("officer_top_out");
+        default: return TEXT("limit");
+        }
+    }
+
+    // Nearest-rank percentile of a sorted array; 0 when empty
+    float Percentile(const TArray<float>& Sorted, float P)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.0f;
+        }
+        return Sorted[FMath::Clamp(FMath::RoundToInt(P * (Sorted.Num() - 1)), 0, Sorted.Num() - 1)];
+    }
+
+    float Mean(const TArray<float>& Values)
+    {
+        double Sum = 0.0;
+        for (float Value : Values)
+        {
+            Sum += Value;
+        }
+        return Values.Num() > 0 ? (float)(Sum / Values.Num()) : 0.0f;
+    }
+
+    // Plays one piece onto a board whose rightmost column is full to two rows below the top, so the bot weighs
+    // placements that reach past the top row at the board's edge. Returns false if it didn't get to lock it.
+    bool CheckEdgePlacement(FBreakoutSimConfig Config, int32 Seed)
+    {
+        Config.MaxPieces = 1;
+        Config.bClearOfficers = false;
+
+        const int32 NumTokens = FMath::Max(Config.BasePrices.Num(), 1);
+        TArray<uint16> Codes;
+        Codes.Init(BoardNetCell::Make(EBoardNetCellKind::Empty, INDEX_NONE, 0), Config.Width * Config.Height);
+        for (int32 Y = 0; Y < Config.Height - 2; Y++)
+        {
+            // Neighbours differ, so nothing in the column pairs off on its own
+            Codes[(Config.Width - 1) * Config.Height + Y] = BoardNetCell::Make(EBoardNetCellKind::Block, Y % FMath::Min(NumTokens, 2), 0);
+        }
+
+        FBreakoutSimulation Simulation(Config, Seed);
+        Simulation.SetCells(Codes);
+        const FBreakoutSimResult Result = Simulation.Run();
+        return Result.Pieces == 1;
+    }
+}
+
+UBreakoutSimCommandlet::UBreakoutSimCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UBreakoutSimCommandlet::Main(const FString& Params)
+{
+    const TCHAR* Usage = TEXT("Usage: -run=BreakoutSim [-games=<n>] [-levels=1,2,..|all] [-policy=greedy,token,random|all] [-seed=<n>] [-out=<file>] [-edgecheck]");
+
+    int32 Games = 10000;
+    int32 BaseSeed = 1;
+    FParse::Value(*Params, TEXT("games="), Games);
+    FParse::Value(*Params, TEXT("seed="), BaseSeed);
+    if (Games <= 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), Usage);
+        return 1;
+    }
+
+    UClass* GridClass = ATetrisGrid::StaticClass();
+    FString GridPath;
+    if (FParse::Value(*Params, TEXT("grid="), GridPath))
+    {
+        GridClass = LoadClass<ATetrisGrid>(nullptr, *GridPath);
+        if (!GridClass)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s is not a board class"), *GridPath);
+            return 1;
+        }
+    }
+    const ATetrisGrid* GridDefaults = GridClass->GetDefaultObject<ATetrisGrid>();
+
+    // Only prices and market classes are read, so nothing the registry points at is loaded
+    UTokenRegistry* Registry = nullptr;
+    FString RegistryPath;
+    if (FParse::Value(*Params, TEXT("registry="), RegistryPath))
+    {
+        Registry = LoadObject<UTokenRegistry>(nullptr, *RegistryPath);
+    }
+    else if (!GridDefaults->TokenRegistryAsset.IsNull())
+    {
+        Registry = GridDefaults->TokenRegistryAsset.LoadSynchronous();
+    }
+    if (!Registry || Registry->Tokens.Num() == 0)
+    {
+        Registry = NewObject<UTokenRegistry>();
+        Registry->FillWithDefaults();
+    }
+
+    TArray<int32> Levels;
+    FString LevelList = TEXT("all");
+    FParse::Value(*Params, TEXT("levels="), LevelList, false);
+    if (LevelList.Equals(TEXT("all"), ESearchCase::IgnoreCase))
+    {
+        for (int32 Level = 0; Level < GridDefaults->LevelsDataTable.Num(); Level++)
+        {
+            Levels.Add(Level);
+        }
+    }
+    else
+    {
+        TArray<FString> Names;
+        LevelList.ParseIntoArray(Names, TEXT(","));
+        for (const FString& Name : Names)
+        {
+            const int32 Level = FCString::Atoi(*Name) - 1;
+            if (!GridDefaults->LevelsDataTable.IsValidIndex(Level))
+            {
+                UE_LOG(LogTemp, Error, TEXT("No level %s; the table has %d"), *Name, GridDefaults->LevelsDataTable.Num());
+                return 1;
+            }
+            Levels.Add(Level);
+        }
+    }
+
+    TArray<const FSimPolicy*> SelectedPolicies;
+    FString PolicyList = TEXT("greedy");
+    FParse::Value(*Params, TEXT("policy="), PolicyList, false);
+    for (const FSimPolicy& Policy : Policies)
+    {
+        if (PolicyList.Equals(TEXT("all"), ESearchCase::IgnoreCase) || PolicyList.Contains(Policy.Name))
+        {
+            SelectedPolicies.Add(&Policy);
+        }
+    }
+    if (Levels.Num() == 0 || SelectedPolicies.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s"), Usage);
+        return 1;
+    }
+
+    // -edgecheck: one piece per level and policy against a nearly full right-hand column, instead of a balance run
+    if (FParse::Param(*Params, TEXT("edgecheck")))
+    {
+        int32 Failed = 0;
+        for (int32 LevelIndex : Levels)
+        {
+            FBreakoutSimConfig Config;
+            GridDefaults->FillSimulationConfig(LevelIndex, *Registry, Config);
+            for (const FSimPolicy* Policy : SelectedPolicies)
+            {
+                Config.Policy = Policy->Policy;
+                if (!CheckEdgePlacement(Config, BaseSeed))
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Level %d, %s: edge placement check failed"), LevelIndex + 1, Policy->Name);
+                    Failed++;
+                }
+            }
+        }
+        UE_LOG(LogTemp, Display, TEXT("Edge placement check: %d failed"), Failed);
+        return Failed > 0 ? 1 : 0;
+    }
+
+    FString OutPath;
+    if (!FParse::Value(*Params, TEXT("out="), OutPath))
+    {
+        OutPath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("BreakoutSim-%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutPath));
+    if (!Writer.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create %s"), *OutPath);
+        return 1;
+    }
+
+    TUniquePtr<FArchive> GamesWriter;
+    FString GamesOutPath;
+    if (FParse::Value(*Params, TEXT("gamesout="), GamesOutPath))
+    {
+        GamesWriter.Reset(IFileManager::Get().CreateFileWriter(*GamesOutPath));
+        if (!GamesWriter.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to create %s"), *GamesOutPath);
+            return 1;
+        }
+    }
+
+    auto WriteLine = [](FArchive& Archive, const FString& Line)
+    {
+        const FTCHARToUTF8 Utf8(*Line);
+        Archive.Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+    };
+
+    WriteLine(*Writer, TEXT("level,policy,games,pairing_set,target_score,fall_interval,")
+        TEXT("reached_target,top_out,officer_top_out,limit,")
+        TEXT("score_per_min_p10,score_per_min_p50,score_per_min_p90,score_per_min_mean,")
+        TEXT("time_to_target_p10,time_to_target_p50,time_to_target_p90,time_to_target_mean,")
+        TEXT("chain_depth_mean,max_chain_p50,max_chain_p90,max_chain_p99,max_chain_max,")
+        TEXT("sec_raids_per_min_p50,sec_raids_per_min_mean,officer_clears_mean,pieces_p50,seconds_p50\n"));
+    if (GamesWriter.IsValid())
+    {
+        WriteLine(*GamesWriter, TEXT("level,policy,game,seed,end,score,seconds,time_to_target,pieces,rows,sec_raids,officer_clears,chains,max_chain\n"));
+    }
+
+    for (int32 LevelIndex : Levels)
+    {
+        FBreakoutSimConfig Config;
+        GridDefaults->FillSimulationConfig(LevelIndex, *Registry, Config);
+
+        FParse::Value(*Params, TEXT("target="), Config.Level.TargetScore);
+        FParse::Value(*Params, TEXT("fall="), Config.Level.FallingSpeed);
+        FParse::Value(*Params, TEXT("pairing="), Config.Level.BlockPairingSet);
+        FParse::Value(*Params, TEXT("maxpieces="), Config.MaxPieces);
+        FParse::Value(*Params, TEXT("maxseconds="), Config.MaxSeconds);
+        Config.bSoftDrop = !FParse::Param(*Params, TEXT("nosoftdrop"));
+        Config.bClearOfficers = !FParse::Param(*Params, TEXT("noofficerclear"));
+
+        auto GameSeed = [BaseSeed, LevelIndex](int32 Game)
+        {
+            return (int32)HashCombine(HashCombine(GetTypeHash(BaseSeed), GetTypeHash(LevelIndex)), GetTypeHash(Game));
+        };
+
+        for (const FSimPolicy* Policy : SelectedPolicies)
+        {
+            Config.Policy = Policy->Policy;
+
+            TArray<FBreakoutSimResult> Results;
+            Results.SetNum(Games);
+
+            const double StartSeconds = FPlatformTime::Seconds();
+            ParallelFor(Games, [&](int32 Game)
+            {
+                FBreakoutSimulation Simulation(Config, GameSeed(Game));
+                Results[Game] = Simulation.Run();
+            });
+            const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+            int32 Ends[(int32)EBreakoutSimEnd::Num] = {};
+            TArray<float> ScoreRates, TimesToTarget, MaxChains, RaidRates, OfficerClears, Pieces, Seconds;
+            int64 Chains = 0;
+            int64 TotalChainDepth = 0;
+
+            for (int32 Game = 0; Game < Games; Game++)
+            {
+                const FBreakoutSimResult& Result = Results[Game];
+                const float Minutes = FMath::Max(Result.Seconds, 1.0f) / 60.0f;
+
+                Ends[(int32)Result.End]++;
+                ScoreRates.Add(Result.Score / Minutes);
+                if (Result.SecondsToTarget >= 0.0f)
+                {
+                    TimesToTarget.Add(Result.SecondsToTarget);
+                }
+                MaxChains.Add(Result.MaxChainDepth);
+                RaidRates.Add(Result.SecRaids / Minutes);
+                OfficerClears.Add(Result.OfficerClears);
+                Pieces.Add(Result.Pieces);
+                Seconds.Add(Result.Seconds);
+                Chains += Result.Chains;
+                TotalChainDepth += Result.TotalChainDepth;
+
+                if (GamesWriter.IsValid())
+                {
+                    WriteLine(*GamesWriter, FString::Printf(TEXT("%d,%s,%d,%d,%s,%lld,%.1f,%.1f,%d,%d,%d,%d,%d,%d\n"),
+                        LevelIndex + 1, Policy->Name, Game, GameSeed(Game), GetEndName(Result.End), Result.Score, Result.Seconds, Result.SecondsToTarget,
+                        Result.Pieces, Result.RowsCleared, Result.SecRaids, Result.OfficerClears, Result.Chains, Result.MaxChainDepth));
+                }
+            }
+
+            for (TArray<float>* Values : { &ScoreRates, &TimesToTarget, &MaxChains, &RaidRates, &Pieces, &Seconds })
+            {
+                Values->Sort();
+            }
+
+            auto Share = [Games](int32 Count) { return (float)Count / Games; };
+
+            WriteLine(*Writer, FString::Printf(TEXT("%d,%s,%d,%d,%d,%.3f,%.4f,%.4f,%.4f,%.4f,%.0f,%.0f,%.0f,%.0f,%.1f,%.1f,%.1f,%.1f,%.3f,%.0f,%.0f,%.0f,%.0f,%.3f,%.3f,%.3f,%.0f,%.1f\n"),
+                LevelIndex + 1, Policy->Name, Games, Config.Level.BlockPairingSet, Config.Level.TargetScore, Config.Level.FallingSpeed,
+                Share(Ends[(int32)EBreakoutSimEnd::Target]), Share(Ends[(int32)EBreakoutSimEnd::TopOut]),
+                Share(Ends[(int32)EBreakoutSimEnd::OfficerTopOut]), Share(Ends[(int32)EBreakoutSimEnd::Limit]),
+                Percentile(ScoreRates, 0.1f), Percentile(ScoreRates, 0.5f), Percentile(ScoreRates, 0.9f), Mean(ScoreRates),
+                Percentile(TimesToTarget, 0.1f), Percentile(TimesToTarget, 0.5f), Percentile(TimesToTarget, 0.9f), Mean(TimesToTarget),
+                Chains > 0 ? (float)TotalChainDepth / Chains : 0.0f,
+                Percentile(MaxChains, 0.5f), Percentile(MaxChains, 0.9f), Percentile(MaxChains, 0.99f), Percentile(MaxChains, 1.0f),
+                Percentile(RaidRates, 0.5f), Mean(RaidRates), Mean(OfficerClears), Percentile(Pieces, 0.5f), Percentile(Seconds, 0.5f)));
+
+            UE_LOG(LogTemp, Display, TEXT("Level %d, %s: %d games in %.1f s (%.0f games/s), %.1f%% reached %d"),
+                LevelIndex + 1, Policy->Name, Games, ElapsedSeconds, Games / FMath::Max(ElapsedSeconds, 0.001),
+                100.0f * Share(Ends[(int32)EBreakoutSimEnd::Target]), Config.Level.TargetScore);
+        }
+    }
+
+    if (GamesWriter.IsValid())
+    {
+        GamesWriter->Close();
+    }
+    Writer->Close();
+    UE_LOG(LogTemp, Display, TEXT("Wrote %s"), *OutPath);
+    return 0;
+}
@@ -0,0 +1,740 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BreakoutSimulation.h"
+
+FBreakoutSimulation::FBreakoutSimulation(const FBreakoutSimConfig& InConfig, int32 Seed)
+    : Config(InConfig)
+    , Random(Seed)
+{
+    const int32 NumCells = Config.Width * Config.Height;
+    Cells.Init(ECell::Empty, NumCells);
+    CellTokens.Init(INDEX_NONE, NumCells);
+    CannotBlowUpYet.Init(false, NumCells);
+    Zobrist.Reset(Config.Width, Config.Height);
+
+    // Same draws as the board: the event interval (kept in an int there), then the market's seed
+    MarketEventInterval = FMath::FloorToFloat(Random.FRandRange(Config.MinMarketEventInterval, Config.MaxMarketEventInterval));
+    MarketRandom.Initialize(Random.RandHelper(MAX_int32));
+    for (int32 Token = 0; Token < Config.BasePrices.Num(); Token++)
+    {
+        Market.AddToken(Config.BasePrices[Token], 0.0f, Config.MarketVolatility, Config.Betas[Token]);
+    }
+
+    FallInterval = Config.Level.FallingSpeed;
+    NextMarketTick = Config.MarketTickInterval;
+    NextMarketEvent = MarketEventInterval;
+    RoundsLeftBeforeSecSpawn = Config.RoundsBeforeSecSpawn;
+}
+
+FBreakoutSimResult FBreakoutSimulation::Run()
+{
+    TArray<FPlacement> Placements;
+
+    while (Result.End == EBreakoutSimEnd::Limit && Result.Pieces < Config.MaxPieces && Time < Config.MaxSeconds)
+    {
+        const FPiece Piece = bOfficerNext ? MakeOfficerPiece() : MakeRandomPiece();
+        Result.SecRaids += Piece.bOfficer ? 1 : 0;
+        Result.Pieces++;
+
+        FindPlacements(Piece, Placements);
+        if (Placements.Num() == 0)
+        {
+            Result.End = Piece.bOfficer ? EBreakoutSimEnd::OfficerTopOut : EBreakoutSimEnd::TopOut;
+            break;
+        }
+
+        const FPlacement& Placement = Placements[ChoosePlacement(Piece, Placements)];
+        AdvanceTime(Placement.RowsFallen * (Config.bSoftDrop ? Config.FastFallInterval : FallInterval));
+
+        // Same rule as MoveTetrominoDown: locking anything in the top row ends the game
+        for (const FIntPoint& Cell : Placement.Cells)
+        {
+            if (Cell.Y >= Config.Height - 1)
+            {
+                Result.End = Piece.bOfficer ? EBreakoutSimEnd::OfficerTopOut : EBreakoutSimEnd::TopOut;
+            }
+        }
+        if (Result.End != EBreakoutSimEnd::Limit)
+        {
+            break;
+        }
+
+        Lock(Piece, Placement);
+        AdvanceTime(Config.LockDelay);
+
+        if (Config.bClearOfficers && OfficerCells > 0 && Combos >= Config.MaxComboNotches)
+        {
+            ClearOfficers();
+        }
+    }
+
+    Result.Seconds = (float)Time;
+    return Result;
+}
+
+bool FBreakoutSimulation::IsFree(int32 X, int32 Y) const
+{
+    // Above the board is open air while a piece enters
+    return X >= 0 && X < Config.Width && Y >= 0 && (Y >= Config.Height || Cells[Index(X, Y)] == ECell::Empty);
+}
+
+FBreakoutSimulation::FPiece FBreakoutSimulation::MakeRandomPiece()
+{
+    FPiece Piece;
+    const TArray<FIntPoint>& Shape = Config.Shapes[Random.RandRange(0, Config.Shapes.Num() - 1)];
+    for (const FIntPoint& Offset : Shape)
+    {
+        Piece.Offsets.Add(Offset);
+        Piece.Tokens.Add(Random.RandRange(0, Config.BasePrices.Num() - 1));
+    }
+    return Piece;
+}
+
+FBreakoutSimulation::FPiece FBreakoutSimulation::MakeOfficerPiece() const
+{
+    FPiece Piece;
+    Piece.bOfficer = true;
+    for (int32 X = 0; X < Config.Width; X++)
+    {
+        Piece.Offsets.Add(FIntPoint(X - Config.SpawnX, 0));
+        Piece.Tokens.Add(INDEX_NONE);
+    }
+    return Piece;
+}
+
+void FBreakoutSimulation::FindPlacements(const FPiece& Piece, TArray<FPlacement>& OutPlacements) const
+{
+    OutPlacements.Reset();
+
+    // SEC rows can't rotate and come straight down
+    if (Piece.bOfficer)
+    {
+        FPlacement Placement;
+        if (DropFrom(Piece.Offsets, Config.SpawnX, Placement))
+        {
+            OutPlacements.Add(MoveTemp(Placement));
+        }
+        return;
+    }
+
+    TArray<FIntPoint, TInlineAllocator<16>> Offsets = Piece.Offsets;
+    for (int32 Rotation = 0; Rotation < 4; Rotation++)
+    {
+        for (int32 PivotX = 0; PivotX < Config.Width; PivotX++)
+        {
+            FPlacement Placement;
+            if (DropFrom(Offsets, PivotX, Placement))
+            {
+                OutPlacements.Add(MoveTemp(Placement));
+            }
+        }
+
+        // Same turn as CanRotateTetromino
+        for (FIntPoint& Offset : Offsets)
+        {
+            Offset = FIntPoint(-Offset.Y, Offset.X);
+        }
+    }
+}
+
+bool FBreakoutSimulation::DropFrom(const TArray<FIntPoint, TInlineAllocator<16>>& Offsets, int32 PivotX, FPlacement& OutPlacement) const
+{
+    auto Fits = [&](int32 PivotY)
+    {
+        for (const FIntPoint& Offset : Offsets)
+        {
+            if (!IsFree(PivotX + Offset.X, PivotY + Offset.Y))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    int32 PivotY = Config.Height;
+    if (!Fits(PivotY))
+    {
+        return false;
+    }
+    while (Fits(PivotY - 1))
+    {
+        PivotY--;
+    }
+
+    OutPlacement.RowsFallen = Config.Height - PivotY;
+    for (const FIntPoint& Offset : Offsets)
+    {
+        OutPlacement.Cells.Add(FIntPoint(PivotX + Offset.X, PivotY + Offset.Y));
+    }
+    return true;
+}
+
+int32 FBreakoutSimulation::ChoosePlacement(const FPiece& Piece, const TArray<FPlacement>& Placements)
+{
+    if (Placements.Num() == 1)
+    {
+        return 0;
+    }
+
+    if (Config.Policy == EBreakoutBotPolicy::Random)
+    {
+        return Random.RandRange(0, Placements.Num() - 1);
+    }
+
+    const uint64 BoardHash = GetCellsHash();
+
+    int32 Best = 0;
+    float BestRating = -MAX_flt;
+    for (int32 i = 0; i < Placements.Num(); i++)
+    {
+        // Cells in or above the top row have no Zobrist keys, and would read the next column's; RatePlacement
+        // turns such a placement down anyway
+        bool bInBoard = true;
+        for (const FIntPoint& Cell : Placements[i].Cells)
+        {
+            bInBoard &= Cell.Y < Config.Height - 1;
+        }
+        if (!bInBoard)
+        {
+            continue;
+        }
+
+        uint64 Hash = BoardHash;
+        for (int32 Block = 0; Block < Placements[i].Cells.Num(); Block++)
+        {
+            const int32 CellIndex = Index(Placements[i].Cells[Block].X, Placements[i].Cells[Block].Y);
+            const uint16 Code = Piece.bOfficer ? BoardNetCell::Make(EBoardNetCellKind::Officer, INDEX_NONE, 0)
+                : BoardNetCell::Make(EBoardNetCellKind::Block, Piece.Tokens[Block], 0);
+            Hash ^= Zobrist.GetCellKey(CellIndex, Code) ^ Zobrist.GetPlacedKey(CellIndex);
+        }
+
+        float Rating;
+        if (const float* CachedRating = RatingCache.Find(Hash))
+        {
+            Rating = *CachedRating;
+        }
+        else
+        {
+            Rating = RatePlacement(Piece, Placements[i]);
+            RatingCache.Add(Hash, Rating);
+        }
+
+        if (Rating > BestRating)
+        {
+            BestRating = Rating;
+            Best = i;
+        }
+    }
+    return Best;
+}
+
+uint16 FBreakoutSimulation::GetCellCode(int32 CellIndex) const
+{
+    // As the board tags them: super blocks keep CanClearThreeRows, SEC blocks have no token
+    switch (Cells[CellIndex])
+    {
+    case ECell::Token:
+        return BoardNetCell::Make(EBoardNetCellKind::Block, CellTokens[CellIndex], CannotBlowUpYet[CellIndex] ? BoardNetCell::CannotBlowUpYet : 0);
+    case ECell::Super:
+        return BoardNetCell::Make(EBoardNetCellKind::SuperBlock, CellTokens[CellIndex],
+            BoardNetCell::CanClearThreeRows | (CannotBlowUpYet[CellIndex] ? BoardNetCell::CannotBlowUpYet : 0));
+    case ECell::Sec:
+        return BoardNetCell::Make(EBoardNetCellKind::Officer, INDEX_NONE, 0);
+    default:
+        return 0;
+    }
+}
+
+void FBreakoutSimulation::SetCells(TConstArrayView<uint16> Codes)
+{
+    check(Codes.Num() == Cells.Num());
+
+    OfficerCells = 0;
+    for (int32 CellIndex = 0; CellIndex < Codes.Num(); CellIndex++)
+    {
+        const uint16 Code = Codes[CellIndex];
+        const EBoardNetCellKind Kind = BoardNetCell::GetKind(Code);
+        Cells[CellIndex] = Kind == EBoardNetCellKind::Block ? ECell::Token
+            : Kind == EBoardNetCellKind::SuperBlock ? ECell::Super
+            : Kind == EBoardNetCellKind::Officer ? ECell::Sec
+            : ECell::Empty;
+        CellTokens[CellIndex] = Cells[CellIndex] == ECell::Token || Cells[CellIndex] == ECell::Super ? (int8)BoardNetCell::GetToken(Code) : INDEX_NONE;
+        CannotBlowUpYet[CellIndex] = (Code & BoardNetCell::CannotBlowUpYet) != 0;
+        OfficerCells += Cells[CellIndex] == ECell::Sec ? 1 : 0;
+    }
+}
+
+void FBreakoutSimulation::LockCells(TConstArrayView<FIntPoint> PieceCells, TConstArrayView<int32> Tokens, bool bOfficer)
+{
+    check(PieceCells.Num() == Tokens.Num());
+
+    FPiece Piece;
+    FPlacement Placement;
+    Piece.bOfficer = bOfficer;
+    Piece.Tokens.Append(Tokens.GetData(), Tokens.Num());
+    Placement.Cells.Append(PieceCells.GetData(), PieceCells.Num());
+    Lock(Piece, Placement);
+}
+
+uint64 FBreakoutSimulation::GetCellsHash() const
+{
+    uint64 Hash = 0;
+    for (int32 CellIndex = 0; CellIndex < Cells.Num(); CellIndex++)
+    {
+        Hash ^= Zobrist.GetCellKey(CellIndex, GetCellCode(CellIndex));
+    }
+    return Hash;
+}
+
+float FBreakoutSimulation::RatePlacement(const FPiece& Piece, const FPlacement& Placement) const
+{
+    TArray<bool, TInlineAllocator<512>> Occupied;
+    Occupied.SetNumUninitialized(Cells.Num());
+    for (int32 i = 0; i < Cells.Num(); i++)
+    {
+        Occupied[i] = Cells[i] != ECell::Empty;
+    }
+
+    for (const FIntPoint& Cell : Placement.Cells)
+    {
+        if (Cell.Y >= Config.Height - 1)
+        {
+            return -MAX_flt;
+        }
+        Occupied[Index(Cell.X, Cell.Y)] = true;
+    }
+
+    // Rows this lock fills; a row with an SEC block never clears
+    int32 Lines = 0;
+    for (int32 Y = 0; Y < Config.Height; Y++)
+    {
+        bool bFull = true;
+        for (int32 X = 0; X < Config.Width && bFull; X++)
+        {
+            bFull = Occupied[Index(X, Y)] && Cells[Index(X, Y)] != ECell::Sec;
+        }
+        Lines += bFull ? 1 : 0;
+    }
+
+    int32 AggregateHeight = 0;
+    int32 Holes = 0;
+    int32 Bumpiness = 0;
+    int32 PreviousHeight = INDEX_NONE;
+    for (int32 X = 0; X < Config.Width; X++)
+    {
+        int32 Height = 0;
+        for (int32 Y = Config.Height - 1; Y >= 0; Y--)
+        {
+            if (Occupied[Index(X, Y)])
+            {
+                Height = Y + 1;
+                break;
+            }
+        }
+        for (int32 Y = 0; Y < Height; Y++)
+        {
+            Holes += Occupied[Index(X, Y)] ? 0 : 1;
+        }
+
+        AggregateHeight += Height;
+        Bumpiness += PreviousHeight != INDEX_NONE ? FMath::Abs(Height - PreviousHeight) : 0;
+        PreviousHeight = Height;
+    }
+
+    float Rating = -0.51f * AggregateHeight + 0.76f * Lines - 0.36f * Holes - 0.18f * Bumpiness;
+
+    if (Config.Policy == EBreakoutBotPolicy::TokenGreedy)
+    {
+        // Same-token neighbours on the board become pairs or clusters once the piece locks
+        int32 Matches = 0;
+        for (int32 i = 0; i < Placement.Cells.Num(); i++)
+        {
+            static const FIntPoint Directions[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+            for (const FIntPoint& Direction : Directions)
+            {
+                const FIntPoint Neighbour = Placement.Cells[i] + Direction;
+                if (Neighbour.X >= 0 && Neighbour.X < Config.Width && Neighbour.Y >= 0 && Neighbour.Y < Config.Height &&
+                    Cells[Index(Neighbour.X, Neighbour.Y)] == ECell::Token && CellTokens[Index(Neighbour.X, Neighbour.Y)] == Piece.Tokens[i])
+                {
+                    Matches++;
+                }
+            }
+        }
+        Rating += 0.5f * Matches;
+    }
+
+    return Rating;
+}
+
+void FBreakoutSimulation::Lock(const FPiece& Piece, const FPlacement& Placement)
+{
+    for (int32 i = 0; i < Placement.Cells.Num(); i++)
+    {
+        const int32 CellIndex = Index(Placement.Cells[i].X, Placement.Cells[i].Y);
+        Cells[CellIndex] = Piece.bOfficer ? ECell::Sec : ECell::Token;
+        CellTokens[CellIndex] = (int8)Piece.Tokens[i];
+        OfficerCells += Piece.bOfficer ? 1 : 0;
+    }
+
+    for (bool& bCannotBlowUpYet : CannotBlowUpYet)
+    {
+        bCannotBlowUpYet = false;
+    }
+
+    ClearFullRows();
+    ResolveCombos();
+
+    RoundsLeftBeforeSecSpawn--;
+    if (RoundsLeftBeforeSecSpawn <= 0)
+    {
+        bOfficerNext = true;
+        RoundsLeftBeforeSecSpawn = Config.RoundsBeforeSecSpawn;
+    }
+    if (Piece.bOfficer)
+    {
+        bOfficerNext = false;
+    }
+}
+
+void FBreakoutSimulation::ClearFullRows()
+{
+    for (int32 Y = 0; Y < Config.Height; Y++)
+    {
+        bool bFull = true;
+        int64 RowScore = 0;
+        for (int32 X = 0; X < Config.Width && bFull; X++)
+        {
+            const ECell Cell = Cells[Index(X, Y)];
+            bFull = Cell == ECell::Token || Cell == ECell::Super;
+            RowScore += bFull ? GetBlockScoreValue(CellTokens[Index(X, Y)]) : 0;
+        }
+
+        if (!bFull)
+        {
+            continue;
+        }
+
+        // Everything above moves down a row, SEC blocks included
+        for (int32 X = 0; X < Config.Width; X++)
+        {
+            for (int32 Above = Y; Above < Config.Height - 1; Above++)
+            {
+                Cells[Index(X, Above)] = Cells[Index(X, Above + 1)];
+                CellTokens[Index(X, Above)] = CellTokens[Index(X, Above + 1)];
+                CannotBlowUpYet[Index(X, Above)] = CannotBlowUpYet[Index(X, Above + 1)];
+            }
+            Cells[Index(X, Config.Height - 1)] = ECell::Empty;
+            CellTokens[Index(X, Config.Height - 1)] = INDEX_NONE;
+            CannotBlowUpYet[Index(X, Config.Height - 1)] = false;
+        }
+
+        Combos = FMath::Clamp(Combos + 1, 0, Config.MaxComboNotches);
+        Result.RowsCleared++;
+        AddScore(FMath::Min<int64>(RowScore, MAX_int32 - 1));
+        Y--;
+    }
+}
+
+void FBreakoutSimulation::ResolveCombos()
+{
+    // One pass per evaluation that found something; the game runs them back to back as drops land
+    int32 Depth = 0;
+    for (;;)
+    {
+        const FBoardEvaluation Evaluation = MakeSnapshot().Evaluate();
+
+        if (Evaluation.Blasts.Num() > 0)
+        {
+            for (const FBoardBlast& Blast : Evaluation.Blasts)
+            {
+                if (Cells[Index(Blast.Cell.X, Blast.Cell.Y)] == ECell::Super)
+                {
+                    ClearThreeRows(Blast.Cell.Y);
+                }
+            }
+            Depth++;
+            continue;
+        }
+
+        bool bFound = false;
+
+        // One super block per pass, as on the board, which animates one cluster at a time; any other cluster is
+        // still there for the next pass
+        if (Evaluation.Clusters.Num() > 0)
+        {
+            const FBoardCluster& Cluster = Evaluation.Clusters[0];
+            const FIntPoint First = Cluster.Cells[0];
+            const int8 Token = CellTokens[Index(First.X, First.Y)];
+            for (const FIntPoint& Cell : Cluster.Cells)
+            {
+                DestroyCell(Cell, true);
+            }
+
+            const int32 SuperIndex = Index(First.X, First.Y);
+            Cells[SuperIndex] = ECell::Super;
+            CellTokens[SuperIndex] = Token;
+            CannotBlowUpYet[SuperIndex] = true;
+            bFound = true;
+        }
+
+        uint64 ExplodedTokens = 0;
+        for (const FTokenPair& Pair : Evaluation.Pairs)
+        {
+            const int32 A = Index(Pair.A.X, Pair.A.Y);
+            const int32 B = Index(Pair.B.X, Pair.B.Y);
+            if (Cells[A] != ECell::Token || CellTokens[A] != Pair.Token || Cells[B] != ECell::Token || CellTokens[B] != Pair.Token)
+            {
+                continue;
+            }
+
+            DestroyCell(Pair.A, true);
+            DestroyCell(Pair.B, true);
+            BlastNeighbours(Pair.A);
+            BlastNeighbours(Pair.B);
+            ExplodedTokens |= 1ull << Pair.Token;
+        }
+
+        if (ExplodedTokens & Config.HighRiskMask)
+        {
+            Market.ForceAllDown();
+        }
+        else if (ExplodedTokens & Config.StablecoinMask)
+        {
+            Market.ForceAllUp();
+        }
+        bFound |= ExplodedTokens != 0;
+
+        if (bFound || Depth > 0)
+        {
+            AdvanceTime(ApplyGravity() * Config.DropStepInterval);
+        }
+        ClearFullRows();
+
+        if (!bFound)
+        {
+            break;
+        }
+        Depth++;
+    }
+
+    if (Depth > 0)
+    {
+        Result.Chains++;
+        Result.TotalChainDepth += Depth;
+        Result.MaxChainDepth = FMath::Max(Result.MaxChainDepth, Depth);
+    }
+}
+
+void FBreakoutSimulation::ClearThreeRows(int32 RowIndex)
+{
+    if (RowIndex < 0 || RowIndex >= Config.Height - 1)
+    {
+        return;
+    }
+
+    for (int32 Y = FMath::Max(RowIndex - 1, 0); Y <= RowIndex + 1; Y++)
+    {
+        for (int32 X = 0; X < Config.Width; X++)
+        {
+            DestroyCell(FIntPoint(X, Y), true);
+        }
+    }
+}
+
+void FBreakoutSimulation::BlastNeighbours(const FIntPoint& Cell)
+{
+    // UpdateGridAtLocation: plain blocks around an explosion go without scoring; super and SEC blocks stay
+    for (int32 DX = -1; DX <= 1; DX++)
+    {
+        for (int32 DY = -1; DY <= 1; DY++)
+        {
+            const int32 X = Cell.X + DX;
+            const int32 Y = Cell.Y + DY;
+            if (X >= 0 && X < Config.Width && Y >= 0 && Y < Config.Height && Cells[Index(X, Y)] == ECell::Token)
+            {
+                DestroyCell(FIntPoint(X, Y), false);
+            }
+        }
+    }
+}
+
+void FBreakoutSimulation::DestroyCell(const FIntPoint& Cell, bool bScore)
+{
+    const int32 CellIndex = Index(Cell.X, Cell.Y);
+    if (Cells[CellIndex] != ECell::Token && Cells[CellIndex] != ECell::Super)
+    {
+        return;
+    }
+
+    if (bScore)
+    {
+        AddScore(GetBlockScoreValue(CellTokens[CellIndex]));
+    }
+
+    Cells[CellIndex] = ECell::Empty;
+    CellTokens[CellIndex] = INDEX_NONE;
+    CannotBlowUpYet[CellIndex] = false;
+}
+
+int32 FBreakoutSimulation::ApplyGravity()
+{
+    // CheckForBlocksToDrop: blocks fall into the gaps below them, down to the nearest SEC block
+    int32 LongestDrop = 0;
+    for (int32 X = 0; X < Config.Width; X++)
+    {
+        int32 EmptySpacesBelow = 0;
+        for (int32 Y = 0; Y < Config.Height; Y++)
+        {
+            const int32 From = Index(X, Y);
+            if (Cells[From] == ECell::Empty)
+            {
+                EmptySpacesBelow++;
+            }
+            else if (Cells[From] == ECell::Sec)
+            {
+                EmptySpacesBelow = 0;
+            }
+            else if (EmptySpacesBelow > 0)
+            {
+                const int32 To = Index(X, Y - EmptySpacesBelow);
+                Cells[To] = Cells[From];
+                CellTokens[To] = CellTokens[From];
+                CannotBlowUpYet[To] = CannotBlowUpYet[From];
+                Cells[From] = ECell::Empty;
+                CellTokens[From] = INDEX_NONE;
+                CannotBlowUpYet[From] = false;
+                LongestDrop = FMath::Max(LongestDrop, EmptySpacesBelow);
+            }
+        }
+    }
+    return LongestDrop;
+}
+
+void FBreakoutSimulation::ClearOfficers()
+{
+    for (int32 CellIndex = 0; CellIndex < Cells.Num(); CellIndex++)
+    {
+        if (Cells[CellIndex] == ECell::Sec)
+        {
+            Cells[CellIndex] = ECell::Empty;
+        }
+    }
+
+    OfficerCells = 0;
+    Combos = 0;
+    Result.OfficerClears++;
+
+    AdvanceTime(ApplyGravity() * Config.DropStepInterval);
+    ResolveCombos();
+}
+
+void FBreakoutSimulation::AdvanceTime(float DeltaSeconds)
+{
+    Time += DeltaSeconds;
+
+    // Timers fire in due order, as FSimTimerManager would run them
+    for (;;)
+    {
+        if (NextMarketTick <= NextMarketEvent && NextMarketTick <= Time)
+        {
+            Market.Tick(MarketRandom);
+            NextMarketTick += Config.MarketTickInterval;
+        }
+        else if (NextMarketEvent <= Time)
+        {
+            MarketEvent();
+            NextMarketEvent += MarketEventInterval;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+void FBreakoutSimulation::MarketEvent()
+{
+    // UpdateMarketEvents; the event stays until the next one replaces it
+    if (Random.RandRange(0, 1) == 0)
+    {
+        CurrentEvent = 1;
+        Market.SetMarketDrift(Config.MarketEventDrift);
+        FallInterval = Config.BullRunFallInterval;
+    }
+    else
+    {
+        CurrentEvent = -1;
+        Market.SetMarketDrift(-Config.MarketEventDrift);
+        FallInterval = Config.CryptoCrashFallInterval;
+    }
+}
+
+int32 FBreakoutSimulation::GetBlockScoreValue(int32 Token) const
+{
+    if (Token == INDEX_NONE)
+    {
+        return 0;
+    }
+
+    int32 Value = Market.GetPriceAsInt(Token);
+    if (CurrentEvent > 0)
+    {
+        Value = (int32)FMath::Min<int64>((int64)Value * 2, MAX_int32 - 1);
+    }
+    else if (CurrentEvent < 0)
+    {
+        Value /= 2;
+    }
+    return Value;
+}
+
+void FBreakoutSimulation::AddScore(int64 Points)
+{
+    Result.Score += Points;
+
+    if (Result.End == EBreakoutSimEnd::Limit && Result.Score >= Config.Level.TargetScore)
+    {
+        Result.End = EBreakoutSimEnd::Target;
+        Result.SecondsToTarget = (float)Time;
+    }
+}
+
+FBoardSnapshot FBreakoutSimulation::MakeSnapshot() const
+{
+    FBoardSnapshot Snapshot;
+    Snapshot.Width = Config.Width;
+    Snapshot.Height = Config.Height;
+    Snapshot.BlockPairingSet = Config.Level.BlockPairingSet;
+    Snapshot.Flags.SetNumZeroed(Cells.Num());
+    Snapshot.Tokens.Reset(Config.BasePrices.Num(), Config.Width, Config.Height);
+
+    for (int32 X = 0; X < Config.Width; X++)
+    {
+        for (int32 Y = 0; Y < Config.Height; Y++)
+        {
+            const int32 CellIndex = Index(X, Y);
+            EBoardCellFlags& Flags = Snapshot.Flags[CellIndex];
+            switch (Cells[CellIndex])
+            {
+            case ECell::Token:
+                Flags = EBoardCellFlags::Occupied | EBoardCellFlags::TetrisBlock;
+                Snapshot.Tokens.SetCell(X, Y, CellTokens[CellIndex]);
+                break;
+            case ECell::Super:
+                Flags = EBoardCellFlags::Occupied | EBoardCellFlags::TetrisBlock | EBoardCellFlags::SuperBlock | EBoardCellFlags::CanClearThreeRows;
+                if (CannotBlowUpYet[CellIndex])
+                {
+                    Flags |= EBoardCellFlags::CannotBlowUpYet;
+                }
+                break;
+            case ECell::Sec:
+                Flags = EBoardCellFlags::Occupied;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return Snapshot;
+}
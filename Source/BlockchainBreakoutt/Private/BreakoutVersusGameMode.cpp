@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BreakoutVersusGameMode.h"
+#include "TetrisGrid.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+
+ABreakoutVersusGameMode::ABreakoutVersusGameMode()
+{
+    // Players possess the boards spawned for them
+    DefaultPawnClass = nullptr;
+    BoardClass = ATetrisGrid::StaticClass();
+}
+
+void ABreakoutVersusGameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
+{
+    if (Players.Num() >= 2 || Boards.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Versus: match already full, %s watches"), *GetNameSafe(NewPlayer));
+        return;
+    }
+
+    Players.Add(NewPlayer);
+    UE_LOG(LogTemp, Log, TEXT("Versus: player %d joined"), Players.Num());
+
+    if (Players.Num() == 2)
+    {
+        StartMatch();
+    }
+}
+
+void ABreakoutVersusGameMode::StartMatch()
+{
+    UWorld* World = GetWorld();
+    const int32 Seed = FMath::Max(1, (int32)(FPlatformTime::Cycles() & 0x7fffffff));
+
+    for (int32 Index = 0; Index < Players.Num(); Index++)
+    {
+        const FTransform Transform(FirstBoardLocation + BoardSpacing * Index);
+        ATetrisGrid* Board = World->SpawnActorDeferred<ATetrisGrid>(BoardClass, Transform, nullptr, nullptr,
+            ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (!Board)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Versus: could not spawn board %d"), Index);
+            continue;
+        }
+
+        Board->bPossessFirstPlayer = false;
+        Board->RandomSeed = Seed;
+        Board->FinishSpawning(Transform);
+        Players[Index]->Possess(Board);
+        Boards.Add(Board);
+    }
+
+    if (Boards.Num() == 2)
+    {
+        Boards[0]->VersusOpponent = Boards[1];
+        Boards[1]->VersusOpponent = Boards[0];
+    }
+
+    TArray<AActor*> Cameras;
+    UGameplayStatics::GetAllActorsWithTag(World, CameraTag, Cameras);
+    if (Cameras.Num() > 0)
+    {
+        for (APlayerController* Player : Players)
+        {
+            Player->SetViewTarget(Cameras[0]);
+        }
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Versus: no actor tagged %s, players view their own boards"), *CameraTag.ToString());
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Versus: match started, seed %d"), Seed);
+}
+
+void ABreakoutVersusGameMode::Logout(AController* Exiting)
+{
+    const int32 Index = Players.IndexOfByKey(Cast<APlayerController>(Exiting));
+    if (Index != INDEX_NONE)
+    {
+        if (Boards.IsValidIndex(Index))
+        {
+            OnBoardLost(Boards[Index]);
+        }
+        Players.RemoveAt(Index);
+    }
+
+    Super::Logout(Exiting);
+}
+
+void ABreakoutVersusGameMode::OnBoardLost(ATetrisGrid* Board)
+{
+    if (bMatchOver)
+    {
+        return;
+    }
+    bMatchOver = true;
+
+    const int32 Loser = Boards.IndexOfByKey(Board);
+    UE_LOG(LogTemp, Log, TEXT("Versus: board %d lost, board %d wins"), Loser, Loser == 0 ? 1 : 0);
+
+    // Freeze both games where they ended
+    for (ATetrisGrid* Each : Boards)
+    {
+        if (Each)
+        {
+            Each->SetSimulationSpeed(0.0f);
+        }
+    }
+
+    GetWorldTimerManager().SetTimer(RestartTimer, this, &ABreakoutVersusGameMode::RestartMatch, RestartDelay, false);
+}
+
+void ABreakoutVersusGameMode::RestartMatch()
+{
+    GetWorld()->ServerTravel(TEXT("?Restart"));
+}
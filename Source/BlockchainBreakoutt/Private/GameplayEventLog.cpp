@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GameplayEventLog.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+FGameplayEventLog& FGameplayEventLog::Get()
+{
+    static FGameplayEventLog Instance;
+    return Instance;
+}
+
+bool FGameplayEventLog::Start(const FString& FilePath)
+{
+    FScopeLock Lock(&StartLock);
+
+    if (StartCount++ > 0)
+    {
+        return true;
+    }
+
+    File.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+    if (!File.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to open gameplay event log %s"), *FilePath);
+        StartCount = 0;
+        return false;
+    }
+
+    FGameplayEventLogHeader Header;
+    Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+    Header.StartCycles = FPlatformTime::Cycles64();
+    File->Serialize(&Header, sizeof(Header));
+
+    bStopRequested.store(false);
+    bRunning.store(true);
+    WriterThread = FRunnableThread::Create(this, TEXT("GameplayEventLogWriter"), 0, TPri_BelowNormal);
+
+    UE_LOG(LogTemp, Log, TEXT("Recording gameplay events to %s"), *FilePath);
+    return true;
+}
+
+void FGameplayEventLog::Stop()
+{
+    FScopeLock Lock(&StartLock);
+
+    if (StartCount == 0 || --StartCount > 0)
+    {
+        return;
+    }
+
+    bRunning.store(false);
+    bStopRequested.store(true);
+    if (WriterThread)
+    {
+        WriterThread->WaitForCompletion();
+        delete WriterThread;
+        WriterThread = nullptr;
+    }
+
+    // Anything recorded between the writer's last pass and bRunning going false
+    Drain();
+    File->Close();
+    File.Reset();
+}
+
+uint32 FGameplayEventLog::Run()
+{
+    while (!bStopRequested.load())
+    {
+        Drain();
+        FPlatformProcess::Sleep(FlushInterval);
+    }
+    return 0;
+}
+
+void FGameplayEventLog::RecordSlow(EGameplayEventType Type, uint16 Board, int32 X, int32 Y, int64 Value)
+{
+    FThreadRing& Ring = GetThreadRing();
+
+    const uint32 Head = Ring.Head.load(std::memory_order_relaxed);
+    if (Head - Ring.Tail.load(std::memory_order_acquire) >= RingCapacity)
+    {
+        Ring.Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    FGameplayEvent& Event = Ring.Events[Head & (RingCapacity - 1)];
+    Event.Cycles = FPlatformTime::Cycles64();
+    Event.ThreadId = Ring.ThreadId;
+    Event.Type = (uint8)Type;
+    Event.Reserved = 0;
+    Event.Board = Board;
+    Event.X = X;
+    Event.Y = Y;
+    Event.Value = Value;
+
+    Ring.Head.store(Head + 1, std::memory_order_release);
+}
+
+FGameplayEventLog::FThreadRing& FGameplayEventLog::GetThreadRing()
+{
+    static thread_local FThreadRing* ThreadRing = nullptr;
+    if (!ThreadRing)
+    {
+        // Rings outlive their threads and are reused across sessions, so the pointer never dangles
+        TUniquePtr<FThreadRing> NewRing = MakeUnique<FThreadRing>();
+        NewRing->ThreadId = FPlatformTLS::GetCurrentThreadId();
+        ThreadRing = NewRing.Get();
+
+        FScopeLock Lock(&RingsLock);
+        Rings.Add(MoveTemp(NewRing));
+    }
+    return *ThreadRing;
+}
+
+void FGameplayEventLog::Drain()
+{
+    if (!File.IsValid())
+    {
+        return;
+    }
+
+    WriteBuffer.Reset();
+    {
+        FScopeLock Lock(&RingsLock);
+        for (const TUniquePtr<FThreadRing>& Ring : Rings)
+        {
+            const uint32 Tail = Ring->Tail.load(std::memory_order_relaxed);
+            const uint32 Head = Ring->Head.load(std::memory_order_acquire);
+            for (uint32 i = Tail; i != Head; ++i)
+            {
+                WriteBuffer.Add(Ring->Events[i & (RingCapacity - 1)]);
+            }
+            Ring->Tail.store(Head, std::memory_order_release);
+
+            if (const uint32 Dropped = Ring->Dropped.exchange(0, std::memory_order_relaxed))
+            {
+                FGameplayEvent& Event = WriteBuffer.AddZeroed_GetRef();
+                Event.Cycles = FPlatformTime::Cycles64();
+                Event.ThreadId = Ring->ThreadId;
+                Event.Type = (uint8)EGameplayEventType::EventsDropped;
+                Event.Value = Dropped;
+            }
+        }
+    }
+
+    if (WriteBuffer.Num() > 0)
+    {
+        File->Serialize(WriteBuffer.GetData(), WriteBuffer.Num() * sizeof(FGameplayEvent));
+        File->Flush();
+    }
+}
+
+const TCHAR* FGameplayEventLog::GetTypeName(EGameplayEventType Type)
+{
+    switch (Type)
+    {
+    case EGameplayEventType::Spawn: return TEXT("Spawn");
+    case EGameplayEventType::Move: return TEXT("Move");
+    case EGameplayEventType::Rotate: return TEXT("Rotate");
+    case EGameplayEventType::Lock: return TEXT("Lock");
+    case EGameplayEventType::Clear: return TEXT("Clear");
+    case EGameplayEventType::Explosion: return TEXT("Explosion");
+    case EGameplayEventType::SuperBlock: return TEXT("SuperBlock");
+    case EGameplayEventType::MarketTick: return TEXT("MarketTick");
+    case EGameplayEventType::LevelChange: return TEXT("LevelChange");
+    case EGameplayEventType::Drop: return TEXT("Drop");
+    case EGameplayEventType::EventsDropped: return TEXT("EventsDropped");
+    case EGameplayEventType::BoardHash: return TEXT("BoardHash");
+    default: return TEXT("Unknown");
+    }
+}
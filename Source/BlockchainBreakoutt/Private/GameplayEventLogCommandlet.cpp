@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GameplayEventLogCommandlet.h"
+#include "GameplayEventLog.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UGameplayEventLogCommandlet::UGameplayEventLogCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGameplayEventLogCommandlet::Main(const FString& Params)
+{
+    FString InPath;
+    if (!FParse::Value(*Params, TEXT("in="), InPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Usage: -run=GameplayEventLog -in=<file> [-out=<file>] [-format=csv|trace]"));
+        return 1;
+    }
+
+    FString Format = TEXT("csv");
+    FParse::Value(*Params, TEXT("format="), Format);
+    const bool bTrace = Format.Equals(TEXT("trace"), ESearchCase::IgnoreCase);
+
+    FString OutPath;
+    if (!FParse::Value(*Params, TEXT("out="), OutPath))
+    {
+        OutPath = FPaths::ChangeExtension(InPath, bTrace ? TEXT("json") : TEXT("csv"));
+    }
+
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InPath));
+    if (!Reader.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to open %s"), *InPath);
+        return 1;
+    }
+
+    FGameplayEventLogHeader Header;
+    const uint32 ExpectedMagic = Header.Magic;
+    Reader->Serialize(&Header, sizeof(Header));
+    if (Reader->IsError() || Header.Magic != ExpectedMagic)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s is not a gameplay event log"), *InPath);
+        return 1;
+    }
+
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutPath));
+    if (!Writer.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to create %s"), *OutPath);
+        return 1;
+    }
+
+    auto WriteLine = [&Writer](const FString& Line)
+    {
+        const FTCHARToUTF8 Utf8(*Line);
+        Writer->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+    };
+
+    WriteLine(bTrace ? TEXT("{\"traceEvents\":[\n") : TEXT("time_us,thread,board,type,x,y,value\n"));
+
+    // Events from different threads arrive interleaved per flush, so the output is in file order rather than strictly by time
+    int64 Count = 0;
+    FGameplayEvent Event;
+    while (Reader->Tell() + (int64)sizeof(FGameplayEvent) <= Reader->TotalSize())
+    {
+        Reader->Serialize(&Event, sizeof(Event));
+
+        const double TimeUs = (double)(Event.Cycles - Header.StartCycles) * Header.SecondsPerCycle * 1000000.0;
+        const TCHAR* TypeName = FGameplayEventLog::GetTypeName((EGameplayEventType)Event.Type);
+
+        if (bTrace)
+        {
+            WriteLine(FString::Printf(TEXT("%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"x\":%d,\"y\":%d,\"value\":%lld}}\n"),
+                Count > 0 ? TEXT(",") : TEXT(""), TypeName, TimeUs, Event.Board, Event.ThreadId, Event.X, Event.Y, Event.Value));
+        }
+        else
+        {
+            WriteLine(FString::Printf(TEXT("%.3f,%u,%u,%s,%d,%d,%lld\n"), TimeUs, Event.ThreadId, Event.Board, TypeName, Event.X, Event.Y, Event.Value));
+        }
+        ++Count;
+    }
+
+    if (bTrace)
+    {
+        WriteLine(TEXT("]}\n"));
+    }
+
+    Writer->Close();
+    UE_LOG(LogTemp, Display, TEXT("Wrote %lld events to %s"), Count, *OutPath);
+    return 0;
+}
@@ -0,0 +1,316 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HistoricalPriceStream.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/Paths.h"
+
+bool FHistoricalPriceStream::Open(const FString& FilePath, int32 InRingCapacity)
+{
+    Close();
+
+    File.Reset(IFileManager::Get().CreateFileReader(*FilePath));
+    if (!File.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to open historical price file %s"), *FilePath);
+        return false;
+    }
+
+    FileSize = File->TotalSize();
+    bBinary = FPaths::GetExtension(FilePath).Equals(TEXT("bin"), ESearchCase::IgnoreCase);
+    Ring.SetNum(FMath::Max(InRingCapacity, 64));
+    Chunk.SetNumUninitialized(ChunkSize);
+
+    if (bBinary)
+    {
+        const int64 NumRecords = FileSize / sizeof(FHistoricalPriceSample);
+        FHistoricalPriceSample First;
+        FHistoricalPriceSample Last;
+        if (NumRecords == 0 || !ReadBinaryRecord(0, First) || !ReadBinaryRecord(NumRecords - 1, Last))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Historical price file %s has no records"), *FilePath);
+            Close();
+            return false;
+        }
+        StartTime = First.Timestamp;
+        EndTime = Last.Timestamp;
+        ResetRing(0);
+    }
+    else
+    {
+        if (!BuildCsvIndex())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Historical price file %s has no valid rows"), *FilePath);
+            Close();
+            return false;
+        }
+        ResetRing(TimeIndex[0].Offset);
+    }
+
+    return true;
+}
+
+void FHistoricalPriceStream::Close()
+{
+    File.Reset();
+    TimeIndex.Empty();
+    Chunk.Empty();
+    Ring.Empty();
+    RingHead = 0;
+    RingCount = 0;
+    ReadOffset = 0;
+    FileSize = 0;
+    bHasCurrent = false;
+}
+
+bool FHistoricalPriceStream::Seek(int64 Timestamp)
+{
+    if (!File.IsValid())
+    {
+        return false;
+    }
+
+    if (bBinary)
+    {
+        // Binary search for the last record at or before Timestamp
+        int64 Low = 0;
+        int64 High = FileSize / sizeof(FHistoricalPriceSample) - 1;
+        int64 Found = 0;
+        while (Low <= High)
+        {
+            const int64 Mid = Low + (High - Low) / 2;
+            FHistoricalPriceSample Sample;
+            if (!ReadBinaryRecord(Mid, Sample))
+            {
+                return false;
+            }
+
+            if (Sample.Timestamp <= Timestamp)
+            {
+                Found = Mid;
+                Low = Mid + 1;
+            }
+            else
+            {
+                High = Mid - 1;
+            }
+        }
+        ResetRing(Found * sizeof(FHistoricalPriceSample));
+    }
+    else
+    {
+        // The index is sparse, so SampleAt scans forward at most IndexStride rows from here
+        const int32 Upper = Algo::UpperBoundBy(TimeIndex, Timestamp, &FIndexEntry::Timestamp);
+        ResetRing(TimeIndex[FMath::Max(Upper - 1, 0)].Offset);
+    }
+
+    return true;
+}
+
+bool FHistoricalPriceStream::SampleAt(int64 Timestamp, double& OutPrice)
+{
+    if (!File.IsValid())
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        if (RingCount == 0 && !FillRing())
+        {
+            break;
+        }
+
+        if (RingCount == 0)
+        {
+            continue;
+        }
+
+        const FHistoricalPriceSample& Next = PeekSample(0);
+        if (Next.Timestamp > Timestamp)
+        {
+            break;
+        }
+
+        Current = Next;
+        bHasCurrent = true;
+        PopSample();
+    }
+
+    if (bHasCurrent)
+    {
+        OutPrice = Current.Price;
+    }
+    return bHasCurrent;
+}
+
+bool FHistoricalPriceStream::BuildCsvIndex()
+{
+    TimeIndex.Reset();
+
+    int64 RowCount = 0;
+    int64 Offset = 0;
+    while (Offset < FileSize)
+    {
+        const int32 BytesToRead = (int32)FMath::Min<int64>(ChunkSize, FileSize - Offset);
+        File->Seek(Offset);
+        File->Serialize(Chunk.GetData(), BytesToRead);
+
+        const int32 Consumed = ScanCsvChunk(BytesToRead, Offset + BytesToRead >= FileSize, [&](const FHistoricalPriceSample& Sample, int32 LineStart)
+        {
+            if (RowCount % IndexStride == 0)
+            {
+                TimeIndex.Add({ Sample.Timestamp, Offset + LineStart });
+            }
+            if (RowCount == 0)
+            {
+                StartTime = Sample.Timestamp;
+            }
+            EndTime = Sample.Timestamp;
+            ++RowCount;
+            return true;
+        });
+
+        Offset += Consumed;
+    }
+
+    return TimeIndex.Num() > 0;
+}
+
+bool FHistoricalPriceStream::ReadBinaryRecord(int64 RecordIndex, FHistoricalPriceSample& OutSample)
+{
+    const int64 RecordOffset = RecordIndex * sizeof(FHistoricalPriceSample);
+    if (RecordIndex < 0 || RecordOffset + (int64)sizeof(FHistoricalPriceSample) > FileSize)
+    {
+        return false;
+    }
+
+    File->Seek(RecordOffset);
+    File->Serialize(&OutSample, sizeof(FHistoricalPriceSample));
+    return !File->IsError();
+}
+
+void FHistoricalPriceStream::ResetRing(int64 NewReadOffset)
+{
+    ReadOffset = NewReadOffset;
+    RingHead = 0;
+    RingCount = 0;
+    bHasCurrent = false;
+}
+
+bool FHistoricalPriceStream::FillRing()
+{
+    if (!File.IsValid() || ReadOffset >= FileSize)
+    {
+        return false;
+    }
+
+    const int32 Free = Ring.Num() - RingCount;
+    if (Free <= 0)
+    {
+        return true;
+    }
+
+    File->Seek(ReadOffset);
+
+    if (bBinary)
+    {
+        const int64 RecordSize = sizeof(FHistoricalPriceSample);
+        const int64 Records = FMath::Min3<int64>(Free, ChunkSize / RecordSize, (FileSize - ReadOffset) / RecordSize);
+        if (Records <= 0)
+        {
+            ReadOffset = FileSize;
+            return false;
+        }
+
+        File->Serialize(Chunk.GetData(), Records * RecordSize);
+        for (int64 i = 0; i < Records; ++i)
+        {
+            FHistoricalPriceSample Sample;
+            FMemory::Memcpy(&Sample, Chunk.GetData() + i * RecordSize, RecordSize);
+            PushSample(Sample);
+        }
+        ReadOffset += Records * RecordSize;
+        return true;
+    }
+
+    const int32 BytesToRead = (int32)FMath::Min<int64>(ChunkSize, FileSize - ReadOffset);
+    File->Serialize(Chunk.GetData(), BytesToRead);
+
+    ReadOffset += ScanCsvChunk(BytesToRead, ReadOffset + BytesToRead >= FileSize, [this](const FHistoricalPriceSample& Sample, int32)
+    {
+        if (RingCount >= Ring.Num())
+        {
+            return false;
+        }
+        PushSample(Sample);
+        return true;
+    });
+    return true;
+}
+
+int32 FHistoricalPriceStream::ScanCsvChunk(int32 BytesRead, bool bLastChunk, TFunctionRef<bool(const FHistoricalPriceSample&, int32)> OnSample) const
+{
+    const ANSICHAR* Data = reinterpret_cast<const ANSICHAR*>(Chunk.GetData());
+    int32 LineStart = 0;
+
+    for (int32 i = 0; i < BytesRead; ++i)
+    {
+        const bool bEndOfLine = Data[i] == '\n';
+        if (!bEndOfLine && !(bLastChunk && i == BytesRead - 1))
+        {
+            continue;
+        }
+
+        const int32 LineEnd = bEndOfLine ? i : i + 1;
+        FHistoricalPriceSample Sample;
+        if (ParseCsvLine(Data + LineStart, LineEnd - LineStart, Sample) && !OnSample(Sample, LineStart))
+        {
+            // Leave the rejected line for the next read
+            return LineStart;
+        }
+        LineStart = i + 1;
+    }
+
+    // A line longer than a whole chunk can never complete; skip past it rather than stalling
+    if (LineStart == 0 && !bLastChunk)
+    {
+        return BytesRead;
+    }
+    return LineStart;
+}
+
+bool FHistoricalPriceStream::ParseCsvLine(const ANSICHAR* Line, int32 Length, FHistoricalPriceSample& OutSample) const
+{
+    ANSICHAR Buffer[128];
+    const int32 CopyLength = FMath::Min(Length, (int32)UE_ARRAY_COUNT(Buffer) - 1);
+    FMemory::Memcpy(Buffer, Line, CopyLength);
+    Buffer[CopyLength] = '\0';
+
+    // Header lines and blanks don't start with a number
+    if (!FCharAnsi::IsDigit(Buffer[0]) && Buffer[0] != '-')
+    {
+        return false;
+    }
+
+    const ANSICHAR* Comma = FCStringAnsi::Strchr(Buffer, ',');
+    if (!Comma)
+    {
+        return false;
+    }
+
+    OutSample.Timestamp = FCStringAnsi::Atoi64(Buffer);
+    OutSample.Price = FCStringAnsi::Atod(Comma + 1);
+    return true;
+}
+
+void FHistoricalPriceStream::PushSample(const FHistoricalPriceSample& Sample)
+{
+    Ring[(RingHead + RingCount) % Ring.Num()] = Sample;
+    ++RingCount;
+}
+
+void FHistoricalPriceStream::PopSample()
+{
+    RingHead = (RingHead + 1) % Ring.Num();
+    --RingCount;
+}
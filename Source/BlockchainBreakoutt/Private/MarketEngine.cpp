@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MarketEngine.h"
+
+void FMarketEngine::Reset()
+{
+    ++Revision;
+    NumTokens = 0;
+    MarketDrift = 0.0f;
+    Price.Reset();
+    Drift.Reset();
+    Volatility.Reset();
+    Beta.Reset();
+    ForcedMultiplier.Reset();
+    Trend.Reset();
+    Noise.Reset();
+}
+
+int32 FMarketEngine::AddToken(float BasePrice, float InDrift, float InVolatility, float InBeta)
+{
+    ++Revision;
+    const int32 Index = NumTokens++;
+    Pad();
+
+    Price[Index] = FMath::Clamp(BasePrice, MinPrice, MaxPrice);
+    Drift[Index] = InDrift;
+    Volatility[Index] = InVolatility;
+    Beta[Index] = InBeta;
+    return Index;
+}
+
+void FMarketEngine::Pad()
+{
+    const int32 NumLanes = Align(NumTokens, 4);
+    Price.SetNumZeroed(NumLanes);
+    Drift.SetNumZeroed(NumLanes);
+    Volatility.SetNumZeroed(NumLanes);
+    Beta.SetNumZeroed(NumLanes);
+    ForcedMultiplier.SetNumZeroed(NumLanes);
+    Trend.SetNumZeroed(NumLanes);
+    Noise.SetNumZeroed(NumLanes);
+}
+
+void FMarketEngine::Serialize(FArchive& Ar)
+{
+    Ar << NumTokens;
+    Ar << MarketDrift;
+    Ar << Price;
+    Ar << Drift;
+    Ar << Volatility;
+    Ar << Beta;
+    Ar << ForcedMultiplier;
+    Ar << Trend;
+
+    if (Ar.IsLoading())
+    {
+        Pad();
+        ++Revision;
+    }
+}
+
+void FMarketEngine::Tick(FRandomStream& Random)
+{
+    const int32 NumLanes = Price.Num();
+
+    float* RESTRICT PriceData = Price.GetData();
+    float* RESTRICT TrendData = Trend.GetData();
+    float* RESTRICT NoiseData = Noise.GetData();
+    const float* RESTRICT DriftData = Drift.GetData();
+    const float* RESTRICT VolatilityData = Volatility.GetData();
+    const float* RESTRICT BetaData = Beta.GetData();
+    const float* RESTRICT ForcedData = ForcedMultiplier.GetData();
+
+    // The random stream is sequential, so draw all the noise first and keep the update loop branch-free
+    for (int32 i = 0; i < NumTokens; ++i)
+    {
+        NoiseData[i] = Random.FRand() * 2.0f - 1.0f;
+    }
+
+    const VectorRegister4Float One = VectorOneFloat();
+    const VectorRegister4Float Zero = VectorZeroFloat();
+    const VectorRegister4Float Lowest = VectorSetFloat1(MinPrice);
+    const VectorRegister4Float Highest = VectorSetFloat1(MaxPrice);
+    const VectorRegister4Float Market = VectorSetFloat1(MarketDrift);
+
+    for (int32 i = 0; i < NumLanes; i += 4)
+    {
+        VectorRegister4Float Multiplier = VectorAdd(One, VectorLoad(DriftData + i));
+        Multiplier = VectorMultiplyAdd(VectorLoad(BetaData + i), Market, Multiplier);
+        Multiplier = VectorMultiplyAdd(VectorLoad(VolatilityData + i), VectorLoad(NoiseData + i), Multiplier);
+
+        const VectorRegister4Float Forced = VectorLoad(ForcedData + i);
+        Multiplier = VectorSelect(VectorCompareGT(Forced, Zero), Forced, Multiplier);
+
+        VectorRegister4Float NewPrice = VectorMultiply(VectorLoad(PriceData + i), Multiplier);
+        NewPrice = VectorMin(VectorMax(NewPrice, Lowest), Highest);
+
+        VectorStore(NewPrice, PriceData + i);
+        VectorStore(VectorSelect(VectorCompareGT(Multiplier, One), One, Zero), TrendData + i);
+    }
+
+    FMemory::Memzero(ForcedMultiplier.GetData(), NumLanes * sizeof(float));
+    ++Revision;
+}
+
+void FMarketEngine::ForceAllUp()
+{
+    ++Revision;
+    for (int32 i = 0; i < NumTokens; ++i)
+    {
+        ForcedMultiplier[i] = ForceUpMultiplier;
+    }
+}
+
+void FMarketEngine::ForceAllDown()
+{
+    ++Revision;
+    for (int32 i = 0; i < NumTokens; ++i)
+    {
+        ForcedMultiplier[i] = ForceDownMultiplier;
+    }
+}
+
+void FMarketEngine::SetPrice(int32 Index, float NewPrice, float PreviousPrice)
+{
+    ++Revision;
+    const float Clamped = FMath::Clamp(NewPrice, MinPrice, MaxPrice);
+    Trend[Index] = Clamped > PreviousPrice ? 1.0f : 0.0f;
+    Price[Index] = Clamped;
+}
@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NextPiecePreviewWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/Image.h"
+#include "Components/VerticalBox.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+void UNextPiecePreviewWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    if (!PieceList && WidgetTree)
+    {
+        PieceList = WidgetTree->ConstructWidget<UVerticalBox>(UVerticalBox::StaticClass(), TEXT("PieceList"));
+        WidgetTree->RootWidget = PieceList;
+    }
+}
+
+void UNextPiecePreviewWidget::SetThumbnails(const TArray<UTextureRenderTarget2D*>& Thumbnails)
+{
+    if (!PieceList || !WidgetTree)
+    {
+        return;
+    }
+
+    // Images are created once per queue slot and then only have their brush swapped
+    while (Images.Num() < Thumbnails.Num())
+    {
+        UImage* Image = WidgetTree->ConstructWidget<UImage>(UImage::StaticClass());
+        const float Size = Images.Num() == 0 ? FirstPieceSize : FirstPieceSize * 0.5f;
+        Image->SetDesiredSizeOverride(FVector2D(Size, Size));
+        PieceList->AddChild(Image);
+        Images.Add(Image);
+    }
+
+    for (int32 i = 0; i < Images.Num(); i++)
+    {
+        UTextureRenderTarget2D* Thumbnail = Thumbnails.IsValidIndex(i) ? Thumbnails[i] : nullptr;
+        Images[i]->SetBrushResourceObject(Thumbnail);
+        Images[i]->SetVisibility(Thumbnail ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+    }
+}
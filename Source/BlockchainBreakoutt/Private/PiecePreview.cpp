@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PiecePreview.h"
+#include "Engine/Canvas.h"
+#include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Kismet/KismetRenderingLibrary.h"
+
+UTextureRenderTarget2D* UPiecePreviewCache::GetThumbnail(const FUpcomingPiece& Piece, int32 Rotation, const TArray<UTexture2D*>& TokenIcons, UTexture2D* OfficerIcon)
+{
+    const FString Key = MakeKey(Piece, Rotation);
+
+    const int32 Found = Keys.IndexOfByKey(Key);
+    if (Found != INDEX_NONE)
+    {
+        LastUsed[Found] = ++UseCounter;
+        return Targets[Found];
+    }
+
+    int32 Slot = INDEX_NONE;
+    if (Targets.Num() < MaxEntries)
+    {
+        UTextureRenderTarget2D* Target = UKismetRenderingLibrary::CreateRenderTarget2D(this, ThumbnailSize, ThumbnailSize, RTF_RGBA8);
+        if (!Target)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to create piece preview render target"));
+            return nullptr;
+        }
+
+        Slot = Targets.Add(Target);
+        Keys.AddDefaulted();
+        LastUsed.AddDefaulted();
+    }
+    else
+    {
+        // Reuse whichever thumbnail has gone longest without being shown
+        Slot = 0;
+        for (int32 i = 1; i < LastUsed.Num(); i++)
+        {
+            if (LastUsed[i] < LastUsed[Slot])
+            {
+                Slot = i;
+            }
+        }
+    }
+
+    Keys[Slot] = Key;
+    LastUsed[Slot] = ++UseCounter;
+    Draw(Targets[Slot], Piece, Rotation, TokenIcons, OfficerIcon);
+    return Targets[Slot];
+}
+
+void UPiecePreviewCache::Draw(UTextureRenderTarget2D* Target, const FUpcomingPiece& Piece, int32 Rotation, const TArray<UTexture2D*>& TokenIcons, UTexture2D* OfficerIcon)
+{
+    ++NumDraws;
+
+    UKismetRenderingLibrary::ClearRenderTarget2D(this, Target, FLinearColor::Transparent);
+
+    if (Piece.BlockOffsets.Num() == 0)
+    {
+        return;
+    }
+
+    // Rotate a quarter turn at a time the same way RotateTetromino does, then fit the piece's bounds to the target
+    TArray<FVector2D, TInlineAllocator<16>> Cells;
+    FVector2D Min(MAX_flt, MAX_flt);
+    FVector2D Max(-MAX_flt, -MAX_flt);
+    for (FVector2D Offset : Piece.BlockOffsets)
+    {
+        for (int32 r = 0; r < (Rotation & 3); r++)
+        {
+            Offset = FVector2D(-Offset.Y, Offset.X);
+        }
+        Cells.Add(Offset);
+        Min = FVector2D::Min(Min, Offset);
+        Max = FVector2D::Max(Max, Offset);
+    }
+
+    const FVector2D Extent = Max - Min + FVector2D(1.0f, 1.0f);
+    const float CellPixels = ThumbnailSize / FMath::Max(Extent.X, Extent.Y);
+    const FVector2D Margin = (FVector2D(ThumbnailSize, ThumbnailSize) - Extent * CellPixels) * 0.5f;
+
+    UCanvas* Canvas = nullptr;
+    FVector2D CanvasSize;
+    FDrawToRenderTargetContext Context;
+    UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, Target, Canvas, CanvasSize, Context);
+
+    if (Canvas)
+    {
+        for (int32 i = 0; i < Cells.Num(); i++)
+        {
+            const int32 TokenIndex = Piece.TokenIndices.IsValidIndex(i) ? Piece.TokenIndices[i] : INDEX_NONE;
+            UTexture2D* Icon = TokenIcons.IsValidIndex(TokenIndex) ? TokenIcons[TokenIndex] : OfficerIcon;
+            if (!Icon)
+            {
+                continue;
+            }
+
+            // Grid y grows upwards, canvas y grows downwards
+            const FVector2D Position(Margin.X + (Cells[i].X - Min.X) * CellPixels, Margin.Y + (Max.Y - Cells[i].Y) * CellPixels);
+            Canvas->K2_DrawTexture(Icon, Position, FVector2D(CellPixels, CellPixels), FVector2D::ZeroVector);
+        }
+    }
+
+    UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+}
+
+FString UPiecePreviewCache::MakeKey(const FUpcomingPiece& Piece, int32 Rotation)
+{
+    TStringBuilder<128> Key;
+    Key.Appendf(TEXT("%d|"), Rotation & 3);
+    for (int32 i = 0; i < Piece.BlockOffsets.Num(); i++)
+    {
+        Key.Appendf(TEXT("%d,%d,%d;"), FMath::RoundToInt(Piece.BlockOffsets[i].X), FMath::RoundToInt(Piece.BlockOffsets[i].Y),
+            Piece.TokenIndices.IsValidIndex(i) ? Piece.TokenIndices[i] : INDEX_NONE);
+    }
+    return FString(Key.ToView());
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PresentationCommandBuffer.h"
+#include "Blueprint/UserWidget.h"
+
+void FPresentationCommandBuffer::RequestVfx(const FString& SystemPath, const FVector& Location, const FLinearColor& Color1, const FLinearColor& Color2, int32 Priority)
+{
+    const float MergeDistanceSquared = VfxMergeDistance * VfxMergeDistance;
+
+    for (FPresentationVfxCommand& Existing : Vfx)
+    {
+        if (Existing.SystemPath == SystemPath && FVector::DistSquared(Existing.Location, Location) <= MergeDistanceSquared)
+        {
+            // Keep the centroid of everything merged so far so a cluster still plays where it happened
+            Existing.Location = (Existing.Location * Existing.MergedCount + Location) / (Existing.MergedCount + 1);
+            Existing.MergedCount++;
+            Existing.Priority = FMath::Max(Existing.Priority, Priority);
+            return;
+        }
+    }
+
+    FPresentationVfxCommand& Command = Vfx.AddDefaulted_GetRef();
+    Command.SystemPath = SystemPath;
+    Command.Location = Location;
+    Command.Color1 = Color1;
+    Command.Color2 = Color2;
+    Command.Priority = Priority;
+}
+
+void FPresentationCommandBuffer::RequestWidget(TSubclassOf<UUserWidget> WidgetClass, UUserWidget** OutWidget)
+{
+    if (!WidgetClass)
+    {
+        return;
+    }
+
+    for (const FPresentationWidgetCommand& Existing : Widgets)
+    {
+        if (Existing.WidgetClass == WidgetClass)
+        {
+            return;
+        }
+    }
+
+    Widgets.Add({ WidgetClass, OutWidget });
+}
+
+void FPresentationCommandBuffer::Resolve()
+{
+    // Higher priority first, then whichever stands for more requests
+    Vfx.StableSort([](const FPresentationVfxCommand& A, const FPresentationVfxCommand& B)
+    {
+        return A.Priority != B.Priority ? A.Priority > B.Priority : A.MergedCount > B.MergedCount;
+    });
+
+    if (MaxVfxPerFrame >= 0 && Vfx.Num() > MaxVfxPerFrame)
+    {
+        Vfx.SetNum(MaxVfxPerFrame);
+    }
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SimulationClock.h"
+
+int32 FSimulationClock::Advance(float RealDeltaSeconds)
+{
+    int32 Steps = QueuedSteps;
+    QueuedSteps = 0;
+
+    if (!bPaused)
+    {
+        const float FrameTime = FMath::Min(RealDeltaSeconds, MaxCatchUpSteps * FixedStep);
+        Accumulator += FrameTime * FMath::Max(TimeScale, 0.0f);
+
+        const int32 DueSteps = FMath::FloorToInt(Accumulator / FixedStep);
+        Accumulator -= DueSteps * (double)FixedStep;
+        Steps += DueSteps;
+    }
+
+    StepCount += Steps;
+    return Steps;
+}
+
+void FSimTimerManager::SetTimer(FSimTimerHandle& InOutHandle, FTimerDelegate Delegate, float Rate, bool bLoop, float FirstDelay)
+{
+    ClearTimer(InOutHandle);
+
+    if (Rate <= 0.0f)
+    {
+        return;
+    }
+
+    InOutHandle.Id = ++LastId;
+    Timers.Add({ InOutHandle.Id, MoveTemp(Delegate), Time + (FirstDelay >= 0.0f ? FirstDelay : Rate), Rate, bLoop });
+}
+
+void FSimTimerManager::ClearTimer(FSimTimerHandle& InOutHandle)
+{
+    const int32 Index = FindTimer(InOutHandle.Id);
+    if (Index != INDEX_NONE)
+    {
+        Timers.RemoveAt(Index, 1, false);
+    }
+    InOutHandle.Invalidate();
+}
+
+bool FSimTimerManager::IsTimerActive(const FSimTimerHandle& Handle) const
+{
+    return FindTimer(Handle.Id) != INDEX_NONE;
+}
+
+void FSimTimerManager::Advance(double DeltaSeconds)
+{
+    Time += DeltaSeconds;
+
+    for (;;)
+    {
+        int32 Next = INDEX_NONE;
+        for (int32 i = 0; i < Timers.Num(); i++)
+        {
+            const FSimTimer& Timer = Timers[i];
+            if (Timer.DueTime <= Time && (Next == INDEX_NONE || Timer.DueTime < Timers[Next].DueTime ||
+                (Timer.DueTime == Timers[Next].DueTime && Timer.Id < Timers[Next].Id)))
+            {
+                Next = i;
+            }
+        }
+
+        if (Next == INDEX_NONE)
+        {
+            return;
+        }
+
+        // The callback may set or clear timers, this one included, so nothing in Timers is held across it
+        const FTimerDelegate Delegate = Timers[Next].Delegate;
+        if (Timers[Next].bLoop)
+        {
+            Timers[Next].DueTime += Timers[Next].Rate;
+        }
+        else
+        {
+            Timers.RemoveAt(Next, 1, false);
+        }
+
+        Delegate.ExecuteIfBound();
+    }
+}
+
+int32 FSimTimerManager::FindTimer(uint64 Id) const
+{
+    if (Id == 0)
+    {
+        return INDEX_NONE;
+    }
+    return Timers.IndexOfByPredicate([Id](const FSimTimer& Timer) { return Timer.Id == Id; });
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TokenBitPlanes.h"
+
+void FTokenBitPlanes::Reset(int32 InNumTokens, int32 InWidth, int32 InHeight)
+{
+    check(InNumTokens <= MaxTokens);
+
+    NumTokens = InNumTokens;
+    Width = InWidth;
+    Height = InHeight;
+    WordsPerRow = FMath::DivideAndRoundUp(FMath::Max(Width, 1), 64);
+
+    Rows.Init(0, NumTokens * Height * WordsPerRow);
+    Cells.Init(INDEX_NONE, Width * Height);
+}
+
+void FTokenBitPlanes::SetCell(int32 X, int32 Y, int32 Token)
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+    {
+        return;
+    }
+
+    const uint64 Bit = 1ull << (X % 64);
+    const int32 Word = Y * WordsPerRow + X / 64;
+    int8& Cell = Cells[Y * Width + X];
+    if (Cell != INDEX_NONE)
+    {
+        Rows[Cell * Height * WordsPerRow + Word] &= ~Bit;
+    }
+
+    Cell = (Token >= 0 && Token < NumTokens) ? (int8)Token : INDEX_NONE;
+    if (Cell != INDEX_NONE)
+    {
+        Rows[Cell * Height * WordsPerRow + Word] |= Bit;
+    }
+}
+
+int32 FTokenBitPlanes::GetCell(int32 X, int32 Y) const
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+    {
+        return INDEX_NONE;
+    }
+    return Cells[Y * Width + X];
+}
+
+void FTokenBitPlanes::FindPairs(TConstArrayView<uint64> FirstCellRows, TArray<FTokenPair>& OutPairs, uint64& OutTokens) const
+{
+    OutTokens = 0;
+
+    for (int32 Token = 0; Token < NumTokens; ++Token)
+    {
+        const uint64* Plane = &Rows[Token * Height * WordsPerRow];
+
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            const uint64* Row = &Plane[Y * WordsPerRow];
+            const uint64* Above = Y + 1 < Height ? &Plane[(Y + 1) * WordsPerRow] : nullptr;
+            const uint64* FirstCells = &FirstCellRows[Y * WordsPerRow];
+
+            for (int32 Word = 0; Word < WordsPerRow; ++Word)
+            {
+                // The right-hand neighbour of a word's last cell is the first cell of the next word
+                const uint64 Right = (Row[Word] >> 1) | (Word + 1 < WordsPerRow ? Row[Word + 1] << 63 : 0);
+                const uint64 Horizontal = Row[Word] & Right & FirstCells[Word];
+                const uint64 Vertical = Row[Word] & (Above ? Above[Word] : 0) & FirstCells[Word];
+                if ((Horizontal | Vertical) == 0)
+                {
+                    continue;
+                }
+
+                OutTokens |= 1ull << Token;
+
+                for (uint64 Either = Horizontal | Vertical; Either != 0; Either &= Either - 1)
+                {
+                    const int32 Bit = (int32)FMath::CountTrailingZeros64(Either);
+                    const int32 X = Word * 64 + Bit;
+                    if (Horizontal & (1ull << Bit))
+                    {
+                        OutPairs.Add({ Token, FIntPoint(X, Y), FIntPoint(X + 1, Y) });
+                    }
+                    if (Vertical & (1ull << Bit))
+                    {
+                        OutPairs.Add({ Token, FIntPoint(X, Y), FIntPoint(X, Y + 1) });
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TokenRegistry.h"
+
+namespace
+{
+    FTokenDefinition MakeDefaultToken(const TCHAR* BlockName, const TCHAR* DisplayName, const TCHAR* Symbol, float BasePrice,
+        bool bStartsTrendingUp, ETokenMarketClass MarketClass, const FLinearColor& Color)
+    {
+        FTokenDefinition Token;
+        Token.BlockName = BlockName;
+        Token.DisplayName = DisplayName;
+        Token.Symbol = Symbol;
+        Token.BasePrice = BasePrice;
+        Token.bStartsTrendingUp = bStartsTrendingUp;
+        Token.MarketClass = MarketClass;
+        Token.Color = Color;
+        Token.BlockClass = TSoftClassPtr<AActor>(FSoftObjectPath(FString::Printf(TEXT("/Game/Blueprints/BP_%s.BP_%s_C"), BlockName, BlockName)));
+        Token.SuperBlockClass = TSoftClassPtr<AActor>(FSoftObjectPath(FString::Printf(TEXT("/Game/Blueprints/BP_super%s.BP_super%s_C"), BlockName, BlockName)));
+        Token.TickerTexture = TSoftObjectPtr<UTexture2D>(FSoftObjectPath(FString::Printf(TEXT("/Game/Images/stock_market_textures/%s_circ.%s_circ"), BlockName, BlockName)));
+        return Token;
+    }
+}
+
+void UTokenRegistry::FillWithDefaults()
+{
+    Tokens = {
+        MakeDefaultToken(TEXT("bitcoin"), TEXT("Bitcoin"), TEXT("BTC"), 20000.0f, true, ETokenMarketClass::HighRisk, FLinearColor(20.0f, 11.0f, 3.0f)),
+        MakeDefaultToken(TEXT("ethereum"), TEXT("Ethereum"), TEXT("ETH"), 12000.0f, false, ETokenMarketClass::HighRisk, FLinearColor(15.0f, 15.0f, 15.0f)),
+        MakeDefaultToken(TEXT("xrp"), TEXT("XRP"), TEXT("XRP"), 15000.0f, true, ETokenMarketClass::Standard, FLinearColor::White),
+        MakeDefaultToken(TEXT("polkadot"), TEXT("Polkadot"), TEXT("DOT"), 10.0f, false, ETokenMarketClass::Standard, FLinearColor(10.0f, 5.0f, 5.0f)),
+        MakeDefaultToken(TEXT("solana"), TEXT("Solana"), TEXT("SOL"), 505.0f, true, ETokenMarketClass::HighRisk, FLinearColor(2.0f, 17.0f, 14.0f)),
+        MakeDefaultToken(TEXT("tether"), TEXT("Tether"), TEXT("USDT"), 100.0f, true, ETokenMarketClass::Stablecoin, FLinearColor(0.0f, 15.0f, 15.0f)),
+        MakeDefaultToken(TEXT("usdc"), TEXT("USDC"), TEXT("USDC"), 110.0f, true, ETokenMarketClass::Stablecoin, FLinearColor(10.0f, 5.0f, 15.0f)),
+    };
+}
+
+void UTokenRegistry::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths, int32 MaxCount) const
+{
+    const int32 NumTokens = FMath::Min(Tokens.Num(), MaxCount);
+    for (int32 TokenId = 0; TokenId < NumTokens; TokenId++)
+    {
+        const FTokenDefinition& Token = Tokens[TokenId];
+        for (const FSoftObjectPath& Path : { Token.BlockClass.ToSoftObjectPath(), Token.SuperBlockClass.ToSoftObjectPath(), Token.TickerTexture.ToSoftObjectPath() })
+        {
+            if (!Path.IsNull())
+            {
+                OutPaths.Add(Path);
+            }
+        }
+    }
+}
+
+FPrimaryAssetId UTokenRegistry::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(TEXT("TokenRegistry"), GetFName());
+}
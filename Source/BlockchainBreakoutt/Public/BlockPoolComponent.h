@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "BlockPoolComponent.generated.h"
+
+USTRUCT()
+struct FPooledBlockList
+{
+    GENERATED_BODY()
+
+    UPROPERTY(Transient)
+    TArray<AActor*> Actors;
+};
+
+/**
+ * Keeps block actors alive between uses so pieces, super blocks and bombs don't spawn and destroy actors during play.
+ *
+ * Released blocks are hidden, lose collision and tick, and go back to their class's free list. Acquire hands one
+ * back with the class default tags, the scale it was first spawned with and its dynamic materials swapped back
+ * to their parents. Bulk releases (clearing the board) and pre-warming are spread over frames by per-frame budgets.
+ */
+UCLASS(ClassGroup = (Gameplay))
+class BLOCKCHAINBREAKOUTT_API UBlockPoolComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UBlockPoolComponent();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    AActor* Acquire(TSubclassOf<AActor> Class, const FVector& Location, const FRotator& Rotation);
+    void Release(AActor* Actor);
+
+    // Releases Actors a few per frame; they are hidden straight away so the board looks empty at once
+    void ReleaseGradually(const TArray<AActor*>& Actors);
+
+    // Spawns hidden blocks over the next frames until Class has at least Count free
+    void Prewarm(TSubclassOf<AActor> Class, int32 Count);
+
+    int32 GetNumFree() const;
+    int32 GetNumSpawned() const { return NumSpawned; }
+    int32 GetNumReused() const { return NumReused; }
+
+    UPROPERTY(EditAnywhere, Category = "Pool")
+    int32 ReleaseBudgetPerFrame = 24;
+
+    UPROPERTY(EditAnywhere, Category = "Pool")
+    int32 PrewarmBudgetPerFrame = 8;
+
+private:
+    AActor* SpawnHidden(TSubclassOf<AActor> Class);
+    void Deactivate(AActor* Actor);
+
+    UPROPERTY(Transient)
+    TMap<UClass*, FPooledBlockList> FreeBlocks;
+
+    UPROPERTY(Transient)
+    TArray<AActor*> PendingRelease;
+
+    // Scale each class was spawned with, restored on reuse (super block formation scales blocks)
+    UPROPERTY(Transient)
+    TMap<UClass*, FVector> SpawnScales;
+
+    TMap<UClass*, int32> PrewarmTargets;
+
+    int32 NumSpawned = 0;
+    int32 NumReused = 0;
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "BoardAudioService.generated.h"
+
+/**
+ * Plays the board's gameplay cues from a fixed set of pre-created audio components.
+ *
+ * Each registered cue owns MaxVoices components created up front. Play requests are queued and at most one
+ * per cue is started each frame, so a cascade that asks for the same cue twenty times plays it once. When every
+ * voice of a cue is busy the oldest one is restarted, so no audio components are created during play.
+ */
+UCLASS(ClassGroup = (Audio), meta = (BlueprintSpawnableComponent))
+class BLOCKCHAINBREAKOUTT_API UBoardAudioService : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UBoardAudioService();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Creates the voices for Cue; registering the same cue again only raises its voice count
+    void RegisterCue(USoundBase* Cue, int32 MaxVoices);
+
+    // Queues Cue for this frame. Unregistered cues are ignored.
+    UFUNCTION(BlueprintCallable, Category = "Audio")
+    void PlayCue(USoundBase* Cue);
+
+    UFUNCTION(BlueprintCallable, Category = "Audio")
+    void StopAll();
+
+private:
+    struct FCueVoices
+    {
+        TArray<TObjectPtr<UAudioComponent>> Voices;
+        int32 NextVoice = 0; // round robin, so the next voice to steal is always the oldest
+    };
+
+    UAudioComponent* CreateVoice(USoundBase* Cue);
+
+    TMap<TObjectPtr<USoundBase>, FCueVoices> CueVoices;
+
+    // Cues requested this frame, each at most once
+    TArray<TObjectPtr<USoundBase>> PendingCues;
+
+    // Keeps the voices referenced for GC; CueVoices is not a UPROPERTY
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UAudioComponent>> AllVoices;
+};
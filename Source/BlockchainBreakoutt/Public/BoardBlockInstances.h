@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "BoardBlockInstances.generated.h"
+
+class UMaterialInstanceDynamic;
+class UTexture2DArray;
+
+/**
+ * Draws every settled block as an instance of one mesh with one master material, instead of one draw per block
+ * actor with its own Blueprint material.
+ *
+ * There is one instance per cell. The material picks the block's artwork from TokenArt by the slice index in
+ * custom data 0: tokens first, then the super block of each token, then the SEC officer and the bomb. Custom
+ * data 1 and 2 carry GlowFactor and GlowPower, custom data 3 is 1 while the block is picked for a super block.
+ * Blocks in the grid keep their actors for rules and animation, only their meshes are hidden; the falling piece
+ * still draws as actors.
+ */
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class BLOCKCHAINBREAKOUTT_API UBoardBlockInstances : public UInstancedStaticMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr int32 NumCustomData = 4;
+
+    UBoardBlockInstances();
+
+    // Needs StaticMesh and a master material on slot 0 as well; left off, block actors draw themselves
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blocks")
+    bool bRenderSettledBlocks = false;
+
+    // Token artwork, laid out as described above; bound to the master material's TokenArt parameter
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blocks")
+    UTexture2DArray* TokenArt;
+
+    // Makes a hidden instance for each cell of a Width by Height board with NumTokens tokens
+    void Initialize(int32 Width, int32 Height, int32 InNumTokens);
+
+    bool IsRenderingBlocks() const { return bRenderSettledBlocks && GetStaticMesh() && CellBlocks.Num() > 0; }
+
+    // Where a cell's artwork sits in TokenArt
+    static int32 GetSlice(uint16 CellCode, int32 InNumTokens);
+
+    static void SetBlockMeshHidden(AActor* Block, bool bHidden);
+
+    // Matches the instances to Grid (indexed [x][y]), hiding block meshes that joined it and showing ones that left.
+    // Only needed after a cell changed or while blocks are animating.
+    void Sync(const TArray<TArray<AActor*>>& Grid, TFunctionRef<uint16(int32, int32)> GetCellCode, float GlowFactor, float GlowPower);
+
+private:
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* TokenArtMaterial;
+
+    // The block each instance drew at the last Sync, and its mesh, looked up once when the block arrived
+    TArray<TWeakObjectPtr<AActor>> CellBlocks;
+    TArray<TWeakObjectPtr<UStaticMeshComponent>> CellMeshes;
+    TArray<FTransform> CellTransforms;
+    TArray<float> CellData;
+
+    int32 GridHeight = 0;
+    int32 NumTokens = 0;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TokenBitPlanes.h"
+
+// What a cell held when the snapshot was taken, from its actor's tags
+enum class EBoardCellFlags : uint8
+{
+    None = 0,
+    Occupied = 1 << 0,
+    TetrisBlock = 1 << 1,
+    SuperBlock = 1 << 2,
+    Bomb = 1 << 3,
+    CanClearThreeRows = 1 << 4,
+    CannotBlowUpYet = 1 << 5,
+    Glow = 1 << 6,
+};
+ENUM_CLASS_FLAGS(EBoardCellFlags);
+
+// A settled super block ready to clear its rows, or a bomb
+struct FBoardBlast
+{
+    FIntPoint Cell;
+    bool bBomb = false;
+};
+
+// Same-token blocks that will merge; the first cell started the search and names the super block
+struct FBoardCluster
+{
+    TArray<FIntPoint, TInlineAllocator<4>> Cells;
+};
+
+// Everything one combo pass found, in the order the game thread applies it
+struct FBoardEvaluation
+{
+    uint32 Generation = 0;
+
+    TArray<FBoardBlast> Blasts;
+    TArray<FBoardCluster> Clusters;
+    TArray<FTokenPair> Pairs;
+};
+
+/**
+ * Actor-free copy of the board taken on the game thread, so combo rules can run as a task while the game keeps
+ * ticking. Generation is the board's change counter at capture time; a result whose generation no longer matches
+ * the board is thrown away and the board is evaluated again.
+ *
+ * Evaluate follows the order of a synchronous pass: super block row clears and bombs first, then super duper
+ * (four) and super (three) clusters, then same-token pairs among the blocks no cluster took. Its temporaries come
+ * from the evaluating thread's FBoardFrameArena; only the result touches the heap.
+ */
+struct BLOCKCHAINBREAKOUTT_API FBoardSnapshot
+{
+    uint32 Generation = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 BlockPairingSet = 0;
+
+    TArray<EBoardCellFlags> Flags; // x-major, Width * Height
+    FTokenBitPlanes Tokens;
+
+    EBoardCellFlags GetFlags(int32 X, int32 Y) const { return Flags[X * Height + Y]; }
+
+    FBoardEvaluation Evaluate() const;
+
+private:
+    bool FindCluster(int32 X, int32 Y, int32 Size, TConstArrayView<bool> Glowing, FBoardCluster& OutCluster) const;
+};
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "HAL/ThreadSingleton.h"
+#include <atomic>
+
+// Totals over every thread's arena since startup
+struct FBoardArenaStats
+{
+    int64 Allocations = 0;
+    int64 Bytes = 0;
+    int64 HeapAllocations = 0; // blocks the arenas had to take from the heap; flat once they have warmed up
+};
+
+/**
+ * Bump allocator for rule temporaries, one per thread: combo evaluation runs as a task, the rest of a resolution
+ * pass on the game thread, and the balance simulation on many workers at once.
+ *
+ * Memory comes from 64 KB blocks that are kept once allocated, so after the first few passes nothing reaches the
+ * general heap. Nothing is freed on its own; an FBoardArenaMark takes everything allocated since it was made back
+ * when it goes out of scope. The board ticks inside one, which resets the game thread's arena once a frame.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardFrameArena : public TThreadSingleton<FBoardFrameArena>
+{
+public:
+    static constexpr SIZE_T BlockSize = 64 * 1024;
+
+    ~FBoardFrameArena();
+
+    void* Allocate(SIZE_T Size, uint32 Alignment);
+
+    static FBoardArenaStats GetStats();
+
+private:
+    friend class FBoardArenaMark;
+
+    struct FBlock
+    {
+        uint8* Data = nullptr;
+        SIZE_T Size = 0;
+    };
+
+    TArray<FBlock, TInlineAllocator<4>> Blocks;
+    int32 CurrentBlock = 0;
+    SIZE_T Offset = 0;
+
+    static std::atomic<int64> TotalAllocations;
+    static std::atomic<int64> TotalBytes;
+    static std::atomic<int64> TotalHeapAllocations;
+};
+
+// Rewinds this thread's arena to where it was when the mark was made
+class BLOCKCHAINBREAKOUTT_API FBoardArenaMark
+{
+public:
+    FBoardArenaMark()
+        : Arena(FBoardFrameArena::Get())
+        , Block(Arena.CurrentBlock)
+        , Offset(Arena.Offset)
+    {
+    }
+
+    ~FBoardArenaMark()
+    {
+        Arena.CurrentBlock = Block;
+        Arena.Offset = Offset;
+    }
+
+    UE_NONCOPYABLE(FBoardArenaMark);
+
+private:
+    FBoardFrameArena& Arena;
+    int32 Block;
+    SIZE_T Offset;
+};
+
+/**
+ * TArray allocator that takes its memory from this thread's FBoardFrameArena, after the pattern of
+ * TMemStackAllocator. Growing copies into fresh arena memory and leaves the old block to the next rewind, so an
+ * array must not outlive the mark it was filled under.
+ */
+template <uint32 Alignment = DEFAULT_ALIGNMENT>
+class TBoardArenaAllocator
+{
+public:
+    using SizeType = int32;
+
+    enum { NeedsElementType = true };
+    enum { RequireRangeCheck = true };
+
+    template <typename ElementType>
+    class ForElementType
+    {
+    public:
+        ForElementType() = default;
+
+        void MoveToEmpty(ForElementType& Other)
+        {
+            checkSlow(this != &Other);
+            Data = Other.Data;
+            Other.Data = nullptr;
+        }
+
+        ElementType* GetAllocation() const { return Data; }
+
+        void ResizeAllocation(SizeType PreviousNumElements, SizeType NumElements, SIZE_T NumBytesPerElement)
+        {
+            ElementType* OldData = Data;
+            Data = nullptr;
+            if (NumElements > 0)
+            {
+                const uint32 ElementAlignment = FMath::Max<uint32>(Alignment, alignof(ElementType));
+                Data = (ElementType*)FBoardFrameArena::Get().Allocate(NumElements * NumBytesPerElement, ElementAlignment);
+                if (OldData && PreviousNumElements > 0)
+                {
+                    FMemory::Memcpy(Data, OldData, FMath::Min(NumElements, PreviousNumElements) * NumBytesPerElement);
+                }
+            }
+        }
+
+        SizeType CalculateSlackReserve(SizeType NumElements, SIZE_T NumBytesPerElement) const
+        {
+            return DefaultCalculateSlackReserve(NumElements, NumBytesPerElement, false, Alignment);
+        }
+
+        SizeType CalculateSlackShrink(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+        {
+            return DefaultCalculateSlackShrink(NumElements, NumAllocatedElements, NumBytesPerElement, false, Alignment);
+        }
+
+        SizeType CalculateSlackGrow(SizeType NumElements, SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+        {
+            return DefaultCalculateSlackGrow(NumElements, NumAllocatedElements, NumBytesPerElement, false, Alignment);
+        }
+
+        SIZE_T GetAllocatedSize(SizeType NumAllocatedElements, SIZE_T NumBytesPerElement) const
+        {
+            return NumAllocatedElements * NumBytesPerElement;
+        }
+
+        bool HasAllocation() const { return Data != nullptr; }
+        SizeType GetInitialCapacity() const { return 0; }
+
+    private:
+        ElementType* Data = nullptr;
+    };
+
+    typedef ForElementType<FScriptContainerElement> ForAnyElementType;
+};
+
+// An array of rule temporaries; wrap the allocator in a TInlineAllocator to skip the arena for the usual sizes
+template <typename ElementType>
+using TBoardArenaArray = TArray<ElementType, TBoardArenaAllocator<>>;
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EBoardCommand : uint8
+{
+    MoveLeft,
+    MoveRight,
+    Rotate,
+    SoftDropStart,
+    SoftDropStop,
+};
+
+struct FBoardInputCommand
+{
+    EBoardCommand Command = EBoardCommand::MoveLeft;
+    double Timestamp = 0.0; // FPlatformTime::Seconds when the input arrived, or when an auto-repeat fell due
+    uint64 Step = 0;        // simulation step that applied it, stamped by Drain
+};
+
+/**
+ * Player commands waiting for the next simulation step, in arrival order.
+ *
+ * Left and right also auto-shift: a held direction moves once on press, again after AutoShiftDelay, and then
+ * every AutoRepeatRate seconds (0 slides all the way in one step). When both are held the last one pressed
+ * wins; letting go of it hands back to the other with a fresh delay.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardInputQueue
+{
+public:
+    void Push(EBoardCommand Command, double Timestamp);
+
+    void PressDirection(EBoardCommand Direction, double Timestamp);
+    void ReleaseDirection(EBoardCommand Direction, double Timestamp);
+
+    // Queues every auto-repeat that fell due up to Now; MaxInstantShift bounds a zero repeat rate
+    void Update(double Now, float AutoShiftDelay, float AutoRepeatRate, int32 MaxInstantShift);
+
+    // Hands over everything queued, stamped with the simulation step about to apply it; the queue is empty afterwards
+    void Drain(TArray<FBoardInputCommand>& OutCommands, uint64 Step);
+
+    void Reset();
+
+private:
+    bool bLeftHeld = false;
+    bool bRightHeld = false;
+    bool bShifting = false;          // a direction is held and auto-shift is running for it
+    EBoardCommand ShiftDirection = EBoardCommand::MoveLeft;
+    double ShiftPressedTime = 0.0;
+    double NextRepeatTime = 0.0;     // 0 until the auto-shift delay has passed
+
+    TArray<FBoardInputCommand> Pending;
+};
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Low-Level Memory Tracker tags for this module, all under BlockchainBreakout. They only count when the game runs
+ * with -llm; BlockchainBreakout.MemReport prints them against the BlockchainBreakout.MemBudget.* console variables
+ * (megabytes, settable from [SystemSettings] in DefaultEngine.ini).
+ *
+ *   Board   grid, token planes, hashes, net state and anything else a board tick allocates
+ *   Blocks  block actors and their components, spawned through the pool
+ *   Glow    dynamic material instances for glowing blocks and the board
+ *   Effects Niagara systems
+ *   Market  market engine, ticks and historical price streams
+ *   UI      widgets and UI delta broadcasts
+ *   Rewind  rewind frames
+ */
+LLM_DECLARE_TAG_API(BlockchainBreakout, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Board, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Blocks, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Glow, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Effects, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Market, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_UI, BLOCKCHAINBREAKOUTT_API);
+LLM_DECLARE_TAG_API(BlockchainBreakout_Rewind, BLOCKCHAINBREAKOUTT_API);
+
+class BLOCKCHAINBREAKOUTT_API FBoardMemoryReport
+{
+public:
+    // Updates each tag's peak and warns once per tag that goes over budget; boards call it about once a second
+    static void Sample();
+
+    // Current and peak per tag against its budget (console: BlockchainBreakout.MemReport)
+    static void Print(FOutputDevice& Ar);
+};
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoardNetState.generated.h"
+
+// What a cell shows on other machines; the actor class follows from the kind and the token
+enum class EBoardNetCellKind : uint8
+{
+    Empty,
+    Block,
+    SuperBlock,
+    Officer,
+    Bomb,
+};
+
+/**
+ * A cell packed into 12 bits: kind (3), token (6) and the tags that change how it behaves or looks (3).
+ * The whole board is 300 of these, 450 bytes; a lock usually changes four.
+ */
+namespace BoardNetCell
+{
+    constexpr int32 KindBits = 3;
+    constexpr int32 TokenBits = 6;
+    constexpr int32 NumBits = 12;
+    constexpr uint32 NumCodes = 1u << NumBits;
+
+    constexpr uint16 CanClearThreeRows = 1 << 9;
+    constexpr uint16 CannotBlowUpYet = 1 << 10;
+    constexpr uint16 Glow = 1 << 11;
+
+    inline uint16 Make(EBoardNetCellKind Kind, int32 Token, uint16 Flags)
+    {
+        const uint16 TokenField = Token != INDEX_NONE ? (uint16)(Token & ((1 << TokenBits) - 1)) : 0;
+        return (uint16)Kind | (uint16)(TokenField << KindBits) | Flags;
+    }
+
+    inline EBoardNetCellKind GetKind(uint16 Code) { return (EBoardNetCellKind)(Code & ((1 << KindBits) - 1)); }
+    inline int32 GetToken(uint16 Code) { return (Code >> KindBits) & ((1 << TokenBits) - 1); }
+}
+
+/**
+ * Board cells as they travel: the cells that differ from the keyframe BaseSequence (0 means from an empty board),
+ * bit-packed as (cells skipped, cell code) pairs after a count.
+ *
+ * The server keeps one keyframe and one delta against it, both replicated properties, rather than a stream of
+ * per-lock deltas: property replication only guarantees the latest value arrives, and any latest delta plus the
+ * latest keyframe rebuilds the board. Once a delta grows past half a keyframe it becomes the next keyframe.
+ */
+USTRUCT()
+struct FBoardNetCells
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    uint32 Sequence = 0;
+
+    UPROPERTY()
+    uint32 BaseSequence = 0;
+
+    // FBoardZobrist cells hash of the whole board at Sequence, so a client can check what it rebuilt
+    UPROPERTY()
+    uint64 Hash = 0;
+
+    UPROPERTY()
+    TArray<uint8> Bits;
+};
+
+// The falling piece: which shape, turned how often, with its pivot (block 0) where; enough to draw it anywhere
+USTRUCT()
+struct FBoardNetPiece
+{
+    GENERATED_BODY()
+
+    static constexpr uint8 NoPiece = 255;
+    static constexpr uint8 OfficerShape = 254;
+
+    UPROPERTY()
+    uint8 Shape = NoPiece; // index into TetrominoShapes, or one of the above
+
+    UPROPERTY()
+    uint8 Rotation = 0;
+
+    UPROPERTY()
+    int8 X = 0;
+
+    UPROPERTY()
+    int8 Y = 0;
+
+    UPROPERTY()
+    TArray<uint8> Tokens; // per block; unused for an SEC row
+
+    bool operator==(const FBoardNetPiece& Other) const
+    {
+        return Shape == Other.Shape && Rotation == Other.Rotation && X == Other.X && Y == Other.Y && Tokens == Other.Tokens;
+    }
+};
+
+class BLOCKCHAINBREAKOUTT_API FBoardNetCodec
+{
+public:
+    // Every cell of Cells that differs from Base; both the same size
+    static void Encode(const TArray<uint16>& Base, const TArray<uint16>& Cells, TArray<uint8>& OutBits);
+
+    // Base with the encoded cells applied; false (and OutCells untouched) when Bits doesn't fit Base
+    static bool Decode(const TArray<uint16>& Base, const TArray<uint8>& Bits, TArray<uint16>& OutCells);
+};
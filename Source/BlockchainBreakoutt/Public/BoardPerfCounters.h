@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EBoardStage : uint8
+{
+    Fall = 0,
+    Lock,
+    Clears,
+    Combos,
+    Clusters,
+    Drops,
+    Market,
+    Effects,
+    Count
+};
+
+// Everything the perf HUD shows, computed a few times a second so reading it costs nothing
+struct FBoardPerfSnapshot
+{
+    static constexpr int32 NumStages = (int32)EBoardStage::Count;
+
+    float LastFrameMs[NumStages] = {};
+    float P50Ms[NumStages] = {};
+    float P99Ms[NumStages] = {};
+
+    int32 LiveBlockActors = 0;
+    int32 SpawnedBlocks = 0;
+    int32 PooledBlocks = 0;
+    int32 ActiveNiagaraComponents = 0;
+    int32 DynamicMaterialInstances = 0;
+    int32 ActiveTimers = 0;
+    int32 RewindFrames = 0;
+    int32 RewindBytes = 0;
+
+    // Replicated board cells (server only): average delta size and the current keyframe
+    float NetBytesPerUpdate = 0.0f;
+    int32 NetKeyframeBytes = 0;
+
+    // Rule temporaries since the last refresh, from the frame arenas of every thread; heap allocations should stay 0
+    int32 ArenaAllocations = 0;
+    int64 ArenaBytes = 0;
+    int32 ArenaHeapAllocations = 0;
+
+    // Input arrival to the board change it caused, over the last InputWindowSize commands that changed it
+    float InputLatencyLastMs = 0.0f;
+    float InputLatencyP50Ms = 0.0f;
+    float InputLatencyP99Ms = 0.0f;
+    int32 InputSamples = 0;
+
+    uint32 Serial = 0; // bumped on every refresh so readers can skip redundant work
+};
+
+/**
+ * Per-stage gameplay timings for one board.
+ *
+ * Stages are timed exclusively: when a stage starts inside another (Combos running Clears, say) the outer
+ * stage is paused, so the columns add up to the board's total cost. Each frame's totals go into a rolling
+ * window from which p50/p99 are taken when the snapshot refreshes.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardPerfCounters
+{
+public:
+    static constexpr int32 NumStages = (int32)EBoardStage::Count;
+    static constexpr int32 WindowSize = 256;
+    static constexpr int32 InputWindowSize = 128;
+
+    void BeginStage(EBoardStage Stage);
+    void EndStage();
+
+    // Closes the current frame's totals into the rolling window
+    void EndFrame();
+
+    // One input command that moved the piece, from its timestamp to now (both FPlatformTime::Seconds)
+    void AddInputLatency(double InputTimestamp, double AppliedTimestamp);
+
+    // Recomputes percentiles into OutSnapshot; the resource counts are left to the caller
+    void FillSnapshot(FBoardPerfSnapshot& OutSnapshot) const;
+
+    static const TCHAR* GetStageName(EBoardStage Stage);
+
+    // Resource counters, bumped where the resources are created
+    int32 SpawnedBlocks = 0;
+    int32 PooledBlocks = 0;
+    int32 DynamicMaterialInstances = 0;
+
+private:
+    struct FOpenStage
+    {
+        EBoardStage Stage;
+        uint64 StartCycles;
+    };
+
+    TArray<FOpenStage, TInlineAllocator<8>> OpenStages;
+    uint64 FrameCycles[NumStages] = {};
+    float LastFrameMs[NumStages] = {};
+    float Window[NumStages][WindowSize] = {};
+    int32 WindowCount = 0;
+    int32 WindowNext = 0;
+
+    float InputWindow[InputWindowSize] = {};
+    float LastInputLatencyMs = 0.0f;
+    int32 InputWindowCount = 0;
+    int32 InputWindowNext = 0;
+};
+
+struct FScopedBoardStage
+{
+    FScopedBoardStage(FBoardPerfCounters& InCounters, EBoardStage Stage)
+        : Counters(InCounters)
+    {
+        Counters.BeginStage(Stage);
+    }
+
+    ~FScopedBoardStage()
+    {
+        Counters.EndStage();
+    }
+
+private:
+    FBoardPerfCounters& Counters;
+};
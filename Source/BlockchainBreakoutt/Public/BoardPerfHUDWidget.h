@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "BoardPerfCounters.h"
+#include "BoardPerfHUDWidget.generated.h"
+
+class ATetrisGrid;
+class UTextBlock;
+
+/**
+ * Overlay showing a board's stage timings and resource counts.
+ *
+ * Reads the grid's pre-aggregated FBoardPerfSnapshot and only reformats its text when the snapshot has been
+ * refreshed, so having it open adds almost nothing to the numbers it reports. A Blueprint subclass can lay out
+ * its own StatsText; without one, a plain text block is created.
+ */
+UCLASS()
+class BLOCKCHAINBREAKOUTT_API UBoardPerfHUDWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    void SetGrid(ATetrisGrid* InGrid);
+
+protected:
+    virtual void NativeOnInitialized() override;
+    virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UTextBlock* StatsText;
+
+private:
+    TWeakObjectPtr<ATetrisGrid> Grid;
+    uint32 LastSerial = MAX_uint32;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The last Capacity board states, as opaque byte frames, with only the newest kept whole.
+ *
+ * Each older frame is stored as a delta that rebuilds it from the frame after it: the XOR of the two, with runs
+ * of zero bytes (the unchanged cells and prices) run-length encoded. Going back N frames undoes N deltas from the
+ * newest, and dropping the oldest frame is just forgetting its delta, so no keyframes are needed. A piece lock
+ * changes a handful of cells, so a delta is typically a few dozen bytes.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardRewindBuffer
+{
+public:
+    void SetCapacity(int32 InCapacity);
+
+    // Frame becomes the newest; Time is only used to find frames by age
+    void Push(TArray<uint8>&& Frame, double Time);
+
+    int32 Num() const { return Latest.Num() > 0 ? NumDeltas + 1 : 0; }
+
+    // 0 is the newest frame
+    bool GetFrame(int32 StepsBack, TArray<uint8>& OutFrame) const;
+    double GetTime(int32 StepsBack) const;
+
+    // Steps back to the newest frame at least Seconds older than Now, clamped to the oldest kept
+    int32 FindStepsBack(double Now, double Seconds) const;
+
+    // Forgets the newest Count frames, so the one before them becomes the newest
+    void DiscardNewest(int32 Count);
+
+    void Reset();
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FDelta
+    {
+        TArray<uint8> Bytes;
+        double Time = 0.0; // of the frame this delta rebuilds
+    };
+
+    static void EncodeDelta(const TArray<uint8>& From, const TArray<uint8>& To, TArray<uint8>& OutDelta);
+    static void ApplyDelta(TArray<uint8>& InOutFrame, const TArray<uint8>& Delta);
+
+    // Ring index of the delta that rebuilds the frame StepsBack from the newest (StepsBack >= 1)
+    int32 DeltaIndex(int32 StepsBack) const { return (NewestDelta - (StepsBack - 1) + Capacity) % Capacity; }
+
+    TArray<uint8> Latest;
+    double LatestTime = 0.0;
+    TArray<FDelta> Deltas;
+    int32 Capacity = 256;
+    int32 NewestDelta = -1;
+    int32 NumDeltas = 0;
+};
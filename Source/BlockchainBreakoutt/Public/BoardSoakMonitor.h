@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// One reading of everything the soak run watches for growth
+struct FBoardSoakSample
+{
+    int32 Pieces = 0;
+    int32 UObjects = 0;
+    int32 Actors = 0;
+    int32 Widgets = 0;
+    int32 DynamicMaterials = 0;
+    int32 NiagaraComponents = 0;
+    int32 AudioComponents = 0;
+    uint64 UsedPhysicalMB = 0;
+};
+
+/**
+ * Watches object and memory counts while a board plays thousands of pieces unattended.
+ *
+ * The first sample after the warm-up is the baseline. Every later sample is logged, and at the end a counter fails the
+ * run if it ended more than its tolerance above the baseline and also rose across every sample of the second half.
+ * The second condition separates a real leak from a board that is just fuller than it was at the baseline.
+ *
+ * Samples follow a full garbage collection, which the engine runs at the end of the frame it is requested in, never
+ * inside an actor tick; the sample itself is taken by Tick on the next frame.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardSoakMonitor
+{
+public:
+    void Start(int32 InTargetPieces, int32 InWarmupPieces = 500, int32 InSampleEveryPieces = 250);
+
+    // Call once per spawned piece; returns true once the target is reached and RequestFinish should be called
+    bool OnPieceSpawned();
+
+    // Stops counting pieces and queues the final sample; Tick gives the verdict once it is taken
+    void RequestFinish();
+
+    // Call every frame; returns true on the frame the verdict is ready, with bOutPassed false if a counter grew without bound
+    bool Tick(UWorld* World, bool& bOutPassed);
+
+    bool IsRunning() const { return bRunning; }
+    bool IsActive() const { return bRunning || bSamplePending; }
+    int32 GetPieces() const { return Pieces; }
+    int32 GetTargetPieces() const { return TargetPieces; }
+
+private:
+    void RequestSample();
+    bool Judge() const;
+    FBoardSoakSample TakeSample(UWorld* World) const;
+    static void LogSample(const TCHAR* Label, const FBoardSoakSample& Sample);
+
+    bool bRunning = false;
+    int32 TargetPieces = 0;
+    int32 WarmupPieces = 0;
+    int32 SampleEveryPieces = 0;
+    int32 Pieces = 0;
+    TArray<FBoardSoakSample> Samples;
+
+    bool bSamplePending = false;
+    bool bFinalPending = false;
+    uint64 SampleRequestFrame = 0;
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/StaticMeshComponent.h"
+#include "BoardStateQuad.generated.h"
+
+class UMaterialInstanceDynamic;
+class UTexture2D;
+
+/**
+ * Draws the whole settled board as one quad whose material reads the cells from a small R8G8 texture, so a board
+ * costs one draw whatever its size; meant for very large boards and spectator thumbnails.
+ *
+ * One texel per cell, row 0 being the bottom row. R is the cell's UBoardBlockInstances slice plus one (0 is an
+ * empty cell); G holds flags: 1 can clear three rows, 2 cannot blow up yet, 4 picked for a super block. The
+ * material draws artwork, glow and clear effects from those, with GlowFactor and GlowPower as scalar parameters.
+ *
+ * The board calls SetCell whenever a cell or its tags change. Only rows that changed go to the GPU, at Flush.
+ * Block actors stay in the grid for rules and animation, as with UBoardBlockInstances, with their meshes hidden.
+ */
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class BLOCKCHAINBREAKOUTT_API UBoardStateQuad : public UStaticMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    UBoardStateQuad();
+
+    // Needs a board material on slot 0 with a BoardState texture parameter; takes over from instanced blocks
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blocks")
+    bool bRenderBoardTexture = false;
+
+    // Makes the state texture for an InWidth by InHeight board and stretches the quad over it
+    void Initialize(int32 InWidth, int32 InHeight, int32 InNumTokens, const FVector& BottomLeftCell, const FVector& TopRightCell, float CellSize);
+
+    bool IsRenderingBoard() const { return bRenderBoardTexture && BoardState && BoardMaterial; }
+
+    void SetCell(int32 X, int32 Y, AActor* Block, uint16 CellCode);
+
+    // Uploads the rows changed since the last Flush and updates which block meshes are hidden
+    void Flush(float GlowFactor, float GlowPower);
+
+    int64 GetUploadedBytes() const { return UploadedBytes; }
+
+private:
+    UPROPERTY(Transient)
+    UTexture2D* BoardState;
+
+    UPROPERTY(Transient)
+    UMaterialInstanceDynamic* BoardMaterial;
+
+    static constexpr int32 BytesPerCell = 2;
+
+    // Texels as last set, rows of Width cells
+    TArray<uint8> Cells;
+    TArray<bool> DirtyRows;
+    bool bAnyDirty = false;
+
+    // Blocks as last set and as hidden at the last Flush
+    TArray<TWeakObjectPtr<AActor>> CellBlocks;
+    TArray<TWeakObjectPtr<AActor>> HiddenBlocks;
+
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 NumTokens = 0;
+    float LastGlowFactor = -1.0f;
+    float LastGlowPower = -1.0f;
+    int64 UploadedBytes = 0;
+};
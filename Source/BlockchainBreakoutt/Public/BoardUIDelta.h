@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoardUIDelta.generated.h"
+
+// Everything the HUD needs to redraw since the last flush. Built up during the frame and dispatched once from Tick.
+USTRUCT(BlueprintType)
+struct FBoardUIDelta
+{
+    GENERATED_BODY()
+
+    // PointValues indices whose displayed price or trend arrow changed
+    UPROPERTY(BlueprintReadOnly)
+    TArray<int32> ChangedTokens;
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bScoreChanged = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 Score = 0;
+
+    UPROPERTY(BlueprintReadOnly)
+    bool bNotchesChanged = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 Combos = 0;
+
+    bool IsEmpty() const
+    {
+        return ChangedTokens.Num() == 0 && !bScoreChanged && !bNotchesChanged;
+    }
+
+    void Reset()
+    {
+        ChangedTokens.Reset();
+        bScoreChanged = false;
+        bNotchesChanged = false;
+    }
+};
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoardNetState.h"
+
+class FMarketEngine;
+
+/**
+ * 64-bit Zobrist hash of a board: the XOR of one random key per cell feature (kind, token, each rule flag), kept
+ * up to date one cell at a time, so a write costs a few XORs. The falling piece and the market (a half-octave
+ * price bucket per token and the running event) have keys of their own and are folded in on demand.
+ *
+ * Cells are BoardNetCell codes, the same ones the board replicates, indexed X * Height + Y. Glow only changes
+ * how a cell looks and is left out. Keys come from a fixed seed and only depend on the feature, so every machine
+ * and build hashes the same board to the same value: replays and versus clients can compare hashes to catch a
+ * divergence at the lock it happens.
+ */
+class BLOCKCHAINBREAKOUTT_API FBoardZobrist
+{
+public:
+    static constexpr int32 MaxTokens = 64;
+    static constexpr int32 NumPriceBuckets = 64;
+
+    // Empties the board
+    void Reset(int32 InWidth, int32 InHeight);
+
+    void SetCell(int32 X, int32 Y, uint16 Code);
+    uint16 GetCell(int32 X, int32 Y) const { return Cells[X * Height + Y]; }
+
+    uint64 GetCellsHash() const { return CellsHash; }
+
+    // From scratch, to check the running hash or to hash cells that arrived some other way
+    uint64 HashCells(const TArray<uint16>& Codes) const;
+
+    uint64 GetCellKey(int32 Index, uint16 Code) const;
+
+    // Marks a cell as holding part of a piece that is about to lock, for caching by placement
+    uint64 GetPlacedKey(int32 Index) const { return PlacedKeys[Index]; }
+
+    uint64 GetPieceKey(const FBoardNetPiece& Piece) const;
+    uint64 GetMarketKey(const FMarketEngine& Market, int32 Event) const;
+
+private:
+    static constexpr int32 NumKinds = 1 << BoardNetCell::KindBits;
+    static constexpr int32 NumTokens = 1 << BoardNetCell::TokenBits;
+    static constexpr int32 KeysPerCell = NumKinds + NumTokens + 2; // kind, token, CanClearThreeRows, CannotBlowUpYet
+
+    int32 Width = 0;
+    int32 Height = 0;
+    uint64 CellsHash = 0;
+
+    TArray<uint16> Cells;
+    TArray<uint64> CellKeys; // KeysPerCell per cell
+    TArray<uint64> PlacedKeys;
+};
+
+/**
+ * Fixed-size cache of values by board hash, for bots and hint searches that keep meeting the same positions.
+ * One entry per slot, indexed by the low bits of the hash; a new position always takes the slot. The full hash is
+ * kept, so a hit is the same position unless two 64-bit hashes collide.
+ */
+template <typename ValueType>
+class TBoardTranspositionTable
+{
+public:
+    explicit TBoardTranspositionTable(int32 NumEntriesLog2 = 12)
+    {
+        Entries.SetNum(1 << NumEntriesLog2);
+        Mask = Entries.Num() - 1;
+    }
+
+    const ValueType* Find(uint64 Hash)
+    {
+        const FEntry& Entry = Entries[Hash & Mask];
+        if (Entry.bUsed && Entry.Hash == Hash)
+        {
+            ++Hits;
+            return &Entry.Value;
+        }
+        ++Misses;
+        return nullptr;
+    }
+
+    void Add(uint64 Hash, const ValueType& Value)
+    {
+        FEntry& Entry = Entries[Hash & Mask];
+        Entry.Hash = Hash;
+        Entry.Value = Value;
+        Entry.bUsed = true;
+    }
+
+    void Reset()
+    {
+        for (FEntry& Entry : Entries)
+        {
+            Entry.bUsed = false;
+        }
+        Hits = 0;
+        Misses = 0;
+    }
+
+    int64 GetHits() const { return Hits; }
+    int64 GetMisses() const { return Misses; }
+
+private:
+    struct FEntry
+    {
+        uint64 Hash = 0;
+        ValueType Value = ValueType();
+        bool bUsed = false;
+    };
+
+    TArray<FEntry> Entries;
+    uint64 Mask = 0;
+    int64 Hits = 0;
+    int64 Misses = 0;
+};
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BreakoutSimCommandlet.generated.h"
+
+/**
+ * Plays many bot games of each level headlessly, on every core, and writes per-level balance statistics as CSV.
+ *
+ *   UnrealEditor-Cmd BlockchainBreakoutt.uproject -run=BreakoutSim [-games=10000] [-levels=1,2,3|all]
+ *       [-policy=greedy,token,random|all] [-seed=1] [-maxpieces=5000] [-maxseconds=3600] [-nosoftdrop]
+ *       [-noofficerclear] [-target=<score>] [-fall=<seconds>] [-pairing=<2-4>] [-grid=<class path>]
+ *       [-registry=<asset path>] [-out=<file.csv>] [-gamesout=<file.csv>]
+ *
+ * Rules come from the ATetrisGrid defaults (or -grid, a board Blueprint) and its token registry; -target, -fall
+ * and -pairing override every selected level, for trying a change before editing the table. One row per level and
+ * policy: end causes, score rate, time to TargetScore, chain depth, SEC raids per minute. -gamesout also writes
+ * one row per game. A game's seed depends on -seed, the level and
+ * the game's index only, so policies and rule overrides are compared on the same seeds.
+ */
+UCLASS()
+class UBreakoutSimCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UBreakoutSimCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
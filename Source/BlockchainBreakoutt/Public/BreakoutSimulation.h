@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoardEvaluation.h"
+#include "BoardZobrist.h"
+#include "LevelData.h"
+#include "MarketEngine.h"
+#include "Math/RandomStream.h"
+
+// How the bot picks where each piece goes
+enum class EBreakoutBotPolicy : uint8
+{
+    Random,      // any placement that fits
+    Greedy,      // classic stacking: few holes, low and flat, lines cleared
+    TokenGreedy, // Greedy, plus a bonus for every same-token neighbour the piece lands next to
+};
+
+enum class EBreakoutSimEnd : uint8
+{
+    Target,        // reached the level's TargetScore
+    TopOut,        // a piece locked in the top row
+    OfficerTopOut, // an SEC row locked in the top row
+    Limit,         // ran out of pieces or seconds
+    Num
+};
+
+// The rules of one level, as ATetrisGrid plays them
+struct FBreakoutSimConfig
+{
+    int32 Width = 15;
+    int32 Height = 20;
+    int32 SpawnX = 8;
+
+    FLevelData Level;
+    TArray<TArray<FIntPoint>> Shapes; // block 0 is the rotation pivot
+
+    // Per token
+    TArray<float> BasePrices;
+    TArray<float> Betas;
+    uint64 HighRiskMask = 0;
+    uint64 StablecoinMask = 0;
+
+    float MarketTickInterval = 1.0f;
+    float MarketVolatility = 0.2f;
+    float MarketEventDrift = 0.02f;
+    float MinMarketEventInterval = 30.0f;
+    float MaxMarketEventInterval = 45.0f;
+
+    float BullRunFallInterval = 0.7f;
+    float CryptoCrashFallInterval = 0.2f;
+    float FastFallInterval = 0.05f;
+    float DropStepInterval = 0.2f; // one cell of gravity after a clear
+    float LockDelay = 0.2f;        // from lock to the next piece
+    int32 RoundsBeforeSecSpawn = 10;
+    int32 MaxComboNotches = 5;
+
+    EBreakoutBotPolicy Policy = EBreakoutBotPolicy::Greedy;
+    bool bSoftDrop = true;     // the bot holds down once the piece is lined up
+    bool bClearOfficers = true; // the bot spends a full combo bar on clearing SEC blocks
+
+    int32 MaxPieces = 5000;
+    float MaxSeconds = 3600.0f;
+};
+
+struct FBreakoutSimResult
+{
+    EBreakoutSimEnd End = EBreakoutSimEnd::Limit;
+    int64 Score = 0;
+    float Seconds = 0.0f;
+    float SecondsToTarget = -1.0f;
+    int32 Pieces = 0;
+    int32 RowsCleared = 0;
+    int32 SecRaids = 0;      // SEC rows dealt
+    int32 OfficerClears = 0; // combo bars spent clearing them
+    int32 Chains = 0;        // locks that set off at least one combo pass
+    int32 MaxChainDepth = 0;
+    int32 TotalChainDepth = 0;
+};
+
+/**
+ * One game of a level, played by a bot on an actor-free copy of the grid rules, for balance runs.
+ *
+ * The board is a cell array run through FBoardSnapshot::Evaluate, so blasts, clusters and pairs come from the same
+ * code the game uses; row clears, gravity, SEC rows, combo notches, market ticks and market events follow
+ * ATetrisGrid. Time is simulation time: falling at the current interval, gravity at one step per cell, and a lock
+ * delay per piece. Animations that don't hold up the next piece (glow, sweeps) take no time.
+ *
+ * A placement is a rotation and a column; the piece is assumed to get there while falling, so only where it
+ * lands is checked. Each instance owns its random stream and market, so games run in parallel freely.
+ */
+class BLOCKCHAINBREAKOUTT_API FBreakoutSimulation
+{
+public:
+    FBreakoutSimulation(const FBreakoutSimConfig& InConfig, int32 Seed);
+
+    FBreakoutSimResult Run();
+
+    // FBoardZobrist hash of the cells, equal to ATetrisGrid's cells hash for the same board, so a step of either
+    // can be checked against the other
+    uint64 GetCellsHash() const;
+
+    // Replaces the board with cell codes laid out as FBoardNetCells ([x * Height + y]); bombs are left out
+    void SetCells(TConstArrayView<uint16> Codes);
+
+    // Locks a piece that landed on Cells (tokens INDEX_NONE for an SEC row) and resolves everything it sets off
+    void LockCells(TConstArrayView<FIntPoint> PieceCells, TConstArrayView<int32> Tokens, bool bOfficer);
+
+private:
+    enum class ECell : uint8
+    {
+        Empty,
+        Token,
+        Super,
+        Sec,
+    };
+
+    struct FPiece
+    {
+        TArray<FIntPoint, TInlineAllocator<16>> Offsets;
+        TArray<int32, TInlineAllocator<16>> Tokens; // INDEX_NONE for SEC blocks
+        bool bOfficer = false;
+    };
+
+    struct FPlacement
+    {
+        TArray<FIntPoint, TInlineAllocator<16>> Cells;
+        int32 RowsFallen = 0;
+    };
+
+    int32 Index(int32 X, int32 Y) const { return X * Config.Height + Y; }
+    bool IsFree(int32 X, int32 Y) const;
+
+    FPiece MakeRandomPiece();
+    FPiece MakeOfficerPiece() const;
+
+    // Every rotation and column that lands on the board; empty when the piece can't enter at all
+    void FindPlacements(const FPiece& Piece, TArray<FPlacement>& OutPlacements) const;
+    bool DropFrom(const TArray<FIntPoint, TInlineAllocator<16>>& Offsets, int32 PivotX, FPlacement& OutPlacement) const;
+    int32 ChoosePlacement(const FPiece& Piece, const TArray<FPlacement>& Placements);
+    uint16 GetCellCode(int32 CellIndex) const;
+    float RatePlacement(const FPiece& Piece, const FPlacement& Placement) const;
+
+    void Lock(const FPiece& Piece, const FPlacement& Placement);
+    void ClearFullRows();
+    void ResolveCombos();
+    void ClearThreeRows(int32 RowIndex);
+    void BlastNeighbours(const FIntPoint& Cell);
+    void DestroyCell(const FIntPoint& Cell, bool bScore);
+    int32 ApplyGravity();
+    void ClearOfficers();
+
+    void AdvanceTime(float DeltaSeconds);
+    void MarketEvent();
+    int32 GetBlockScoreValue(int32 Token) const;
+    void AddScore(int64 Points);
+
+    FBoardSnapshot MakeSnapshot() const;
+
+    const FBreakoutSimConfig& Config;
+    FRandomStream Random;
+    FRandomStream MarketRandom;
+    FMarketEngine Market;
+
+    TArray<ECell> Cells;
+    TArray<int8> CellTokens;
+    TArray<bool> CannotBlowUpYet;
+
+    // A rating only depends on the board a placement leaves behind, so positions met again are looked up
+    FBoardZobrist Zobrist;
+    TBoardTranspositionTable<float> RatingCache;
+
+    int8 CurrentEvent = 0; // 0 none, 1 bull run, -1 crypto crash
+    float FallInterval = 0.5f;
+    double Time = 0.0;
+    double NextMarketTick = 0.0;
+    double NextMarketEvent = 0.0;
+    float MarketEventInterval = 30.0f; // drawn once; the board's event timer loops at its first interval
+
+    int32 Combos = 0;
+    int32 RoundsLeftBeforeSecSpawn = 0;
+    bool bOfficerNext = false;
+    int32 OfficerCells = 0;
+
+    FBreakoutSimResult Result;
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "BreakoutVersusGameMode.generated.h"
+
+class ATetrisGrid;
+
+/**
+ * Two players, two boards, one listen server. The server runs both games; each client sends its input and draws
+ * the boards from replicated cells. Boards share a seed, so both players are dealt the same pieces.
+ *
+ * Loopback test on one machine:
+ *   UnrealEditor BlockchainBreakoutt.uproject /Game/Maps/<map>?listen?game=Versus -game -log
+ *   UnrealEditor BlockchainBreakoutt.uproject 127.0.0.1 -game -log
+ */
+UCLASS()
+class BLOCKCHAINBREAKOUTT_API ABreakoutVersusGameMode : public AGameModeBase
+{
+    GENERATED_BODY()
+
+public:
+    ABreakoutVersusGameMode();
+
+    UPROPERTY(EditDefaultsOnly, Category = "Versus")
+    TSubclassOf<ATetrisGrid> BoardClass;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Versus")
+    FVector FirstBoardLocation = FVector::ZeroVector;
+
+    // From one board to the next
+    UPROPERTY(EditDefaultsOnly, Category = "Versus")
+    FVector BoardSpacing = FVector(2000.0f, 0.0f, 0.0f);
+
+    // Both players look through the actor with this tag, which should frame both boards
+    UPROPERTY(EditDefaultsOnly, Category = "Versus")
+    FName CameraTag = TEXT("VersusCamera");
+
+    // Seconds from a loss to the map restarting
+    UPROPERTY(EditDefaultsOnly, Category = "Versus")
+    float RestartDelay = 5.0f;
+
+    // Called by a board instead of its own game over
+    void OnBoardLost(ATetrisGrid* Board);
+
+protected:
+    virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
+    virtual void Logout(AController* Exiting) override;
+
+private:
+    void StartMatch();
+    void RestartMatch();
+
+    UPROPERTY()
+    TArray<APlayerController*> Players;
+
+    UPROPERTY()
+    TArray<ATetrisGrid*> Boards;
+
+    bool bMatchOver = false;
+    FTimerHandle RestartTimer;
+};
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+enum class EGameplayEventType : uint8
+{
+    Spawn = 0,
+    Move = 1,
+    Rotate = 2,
+    Lock = 3,
+    Clear = 4,
+    Explosion = 5,
+    SuperBlock = 6,
+    MarketTick = 7,
+    LevelChange = 8,
+    Drop = 9,
+    EventsDropped = 10, // written by the log itself when a thread's ring overflowed; Value is the count
+    BoardHash = 11,     // after a lock; Value is the board's Zobrist hash, for replays to compare
+    Count
+};
+
+// One record, in memory and on disk (32 bytes, little endian)
+struct FGameplayEvent
+{
+    uint64 Cycles;   // FPlatformTime::Cycles64 at record time
+    uint32 ThreadId;
+    uint8 Type;
+    uint8 Reserved;
+    uint16 Board;    // lets several boards share one log
+    int32 X;
+    int32 Y;
+    int64 Value;
+};
+static_assert(sizeof(FGameplayEvent) == 32, "FGameplayEvent is an on-disk format");
+
+struct FGameplayEventLogHeader
+{
+    uint32 Magic = 0x56454242; // "BBEV"
+    uint32 Version = 1;
+    double SecondsPerCycle = 0.0;
+    uint64 StartCycles = 0;
+};
+
+/**
+ * Binary gameplay event log.
+ *
+ * Record appends a fixed-size event to a single-producer ring owned by the calling thread, so the hot path is
+ * a relaxed load, a 32 byte copy and a release store, with no lock and no formatting. A background thread drains
+ * every ring to disk a few times a second. When a ring is full the event is counted and dropped rather than
+ * blocking the game; the count is written to the file as an EventsDropped record.
+ *
+ * Files are turned into CSV or Chrome trace JSON by the GameplayEventLog commandlet.
+ */
+class BLOCKCHAINBREAKOUTT_API FGameplayEventLog : public FRunnable
+{
+public:
+    static FGameplayEventLog& Get();
+
+    // Starts writing to FilePath. Calls nest; the log keeps running until every Start has a matching Stop.
+    bool Start(const FString& FilePath);
+    void Stop();
+
+    bool IsRunning() const { return bRunning.load(std::memory_order_relaxed); }
+
+    static void Record(EGameplayEventType Type, uint16 Board, int32 X = 0, int32 Y = 0, int64 Value = 0)
+    {
+        FGameplayEventLog& Log = Get();
+        if (Log.IsRunning())
+        {
+            Log.RecordSlow(Type, Board, X, Y, Value);
+        }
+    }
+
+    static const TCHAR* GetTypeName(EGameplayEventType Type);
+
+    // FRunnable
+    virtual uint32 Run() override;
+
+private:
+    static constexpr uint32 RingCapacity = 8192; // power of two
+    static constexpr float FlushInterval = 0.05f;
+
+    struct FThreadRing
+    {
+        FGameplayEvent Events[RingCapacity];
+        std::atomic<uint32> Head{ 0 }; // written by the owning thread
+        std::atomic<uint32> Tail{ 0 }; // written by the writer thread
+        std::atomic<uint32> Dropped{ 0 };
+        uint32 ThreadId = 0;
+    };
+
+    void RecordSlow(EGameplayEventType Type, uint16 Board, int32 X, int32 Y, int64 Value);
+    FThreadRing& GetThreadRing();
+    void Drain();
+
+    std::atomic<bool> bRunning{ false };
+    std::atomic<bool> bStopRequested{ false };
+    int32 StartCount = 0;
+
+    FCriticalSection RingsLock; // only taken when a thread records for the first time and by the writer
+    TArray<TUniquePtr<FThreadRing>> Rings;
+
+    FCriticalSection StartLock;
+    TUniquePtr<FArchive> File;
+    FRunnableThread* WriterThread = nullptr;
+    TArray<FGameplayEvent> WriteBuffer;
+};
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GameplayEventLogCommandlet.generated.h"
+
+/**
+ * Converts a binary gameplay event log to text.
+ *
+ *   UnrealEditor-Cmd BlockchainBreakoutt.uproject -run=GameplayEventLog -in=<file.bbev> [-out=<file>] [-format=csv|trace]
+ *
+ * "trace" writes Chrome trace JSON (chrome://tracing, Perfetto) with one process per board and one track per thread.
+ */
+UCLASS()
+class UGameplayEventLogCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGameplayEventLogCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -13,8 +13,9 @@ struct FGlowBlockAnimationData
     UPROPERTY()
     float ElapsedTime;
 
+    // token of the block the cluster was found from, INDEX_NONE when unknown
     UPROPERTY()
-    FString BlockName;
+    int32 TokenId = INDEX_NONE;
 
     UPROPERTY()
     TArray<FVector> SuperBlockDropSpots;
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/FileManager.h"
+
+// One point of a token's price history. Also the on-disk record of the binary format (16 bytes, little endian).
+struct FHistoricalPriceSample
+{
+    int64 Timestamp = 0; // unix seconds
+    double Price = 0.0;
+};
+
+/**
+ * Streams one token's price history from disk through a fixed-size ring buffer, so multi-year
+ * minute-level series never sit fully in memory.
+ *
+ * Two formats are accepted:
+ *  - "*.bin": packed FHistoricalPriceSample records sorted by timestamp. Seeking is a binary search over the file.
+ *  - anything else is read as CSV, one "timestamp,price" per line (a header line is skipped). A sparse time index
+ *    (one entry every IndexStride rows) is built by a single chunked pass on Open and used for seeking.
+ */
+class BLOCKCHAINBREAKOUTT_API FHistoricalPriceStream
+{
+public:
+    bool Open(const FString& FilePath, int32 InRingCapacity = 4096);
+    void Close();
+    bool IsOpen() const { return File.IsValid(); }
+
+    int64 GetStartTime() const { return StartTime; }
+    int64 GetEndTime() const { return EndTime; }
+
+    // Repositions the stream so the next SampleAt returns the last sample at or before Timestamp
+    bool Seek(int64 Timestamp);
+
+    // Returns the last sample at or before Timestamp. Time is expected to move forward between calls; use Seek to go back.
+    bool SampleAt(int64 Timestamp, double& OutPrice);
+
+private:
+    struct FIndexEntry
+    {
+        int64 Timestamp;
+        int64 Offset;
+    };
+
+    static constexpr int32 IndexStride = 1024;
+    static constexpr int32 ChunkSize = 64 * 1024;
+
+    bool BuildCsvIndex();
+    bool ReadBinaryRecord(int64 RecordIndex, FHistoricalPriceSample& OutSample);
+    void ResetRing(int64 NewReadOffset);
+    bool FillRing();
+    int32 ScanCsvChunk(int32 BytesRead, bool bLastChunk, TFunctionRef<bool(const FHistoricalPriceSample&, int32)> OnSample) const;
+    bool ParseCsvLine(const ANSICHAR* Line, int32 Length, FHistoricalPriceSample& OutSample) const;
+
+    void PushSample(const FHistoricalPriceSample& Sample);
+    const FHistoricalPriceSample& PeekSample(int32 Index) const { return Ring[(RingHead + Index) % Ring.Num()]; }
+    void PopSample();
+
+    TUniquePtr<FArchive> File;
+    bool bBinary = false;
+    int64 FileSize = 0;
+    int64 ReadOffset = 0;
+    int64 StartTime = 0;
+    int64 EndTime = 0;
+
+    TArray<FIndexEntry> TimeIndex;
+    TArray<uint8> Chunk;
+
+    TArray<FHistoricalPriceSample> Ring;
+    int32 RingHead = 0;
+    int32 RingCount = 0;
+
+    FHistoricalPriceSample Current;
+    bool bHasCurrent = false;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/**
+ * Structure-of-arrays market state, one lane per token.
+ *
+ * Each tick multiplies every price by 1 + Drift + Beta * MarketDrift + Volatility * U(-1, 1), unless the lane has a
+ * forced multiplier queued (pair explosions force the whole market up or down). The update is a single SIMD pass
+ * over padded float arrays, so the cost is a few cycles per token no matter how many tokens are listed.
+ *
+ * MarketDrift is the correlated component: Bull Run and Crypto Crash push every lane in the same direction,
+ * scaled by the lane's Beta.
+ *
+ * The engine is a plain value, so a tick can run on a copy off the game thread. Every change bumps the revision;
+ * a ticked copy is only worth keeping if the original hasn't changed since it was taken.
+ */
+class BLOCKCHAINBREAKOUTT_API FMarketEngine
+{
+public:
+    static constexpr float MinPrice = 2.0f;
+    static constexpr float MaxPrice = 2147483520.0f; // largest float below int32 max
+    static constexpr float ForceUpMultiplier = 1.2f;
+    static constexpr float ForceDownMultiplier = 0.99f;
+
+    void Reset();
+    int32 AddToken(float BasePrice, float Drift, float Volatility, float Beta);
+    int32 Num() const { return NumTokens; }
+
+    void Tick(FRandomStream& Random);
+
+    void ForceAllUp();
+    void ForceAllDown();
+    void SetMarketDrift(float InMarketDrift) { MarketDrift = InMarketDrift; ++Revision; }
+    float GetMarketDrift() const { return MarketDrift; }
+
+    float GetPrice(int32 Index) const { return Price[Index]; }
+    int32 GetPriceAsInt(int32 Index) const { return (int32)Price[Index]; }
+    bool IsTrendingUp(int32 Index) const { return Trend[Index] > 0.0f; }
+
+    // Overrides a lane from outside the random walk (historical replay); the trend compares against PreviousPrice
+    void SetPrice(int32 Index, float NewPrice, float PreviousPrice);
+
+    uint32 GetRevision() const { return Revision; }
+
+    // Every lane, for rewind frames; loading counts as a change
+    void Serialize(FArchive& Ar);
+
+private:
+    void Pad();
+
+    int32 NumTokens = 0;
+    float MarketDrift = 0.0f;
+    uint32 Revision = 0;
+
+    // All arrays are padded to a multiple of four lanes; padding lanes are updated but never read
+    TArray<float> Price;
+    TArray<float> Drift;
+    TArray<float> Volatility;
+    TArray<float> Beta;
+    TArray<float> ForcedMultiplier; // 0 when the lane is free to move
+    TArray<float> Trend;            // 1 when the last tick went up
+    TArray<float> Noise;            // scratch, filled from the random stream each tick
+};
+
+// A market tick computed on a copy of the engine
+struct FMarketTickResult
+{
+    FMarketEngine Market;
+    FRandomStream Random;
+    uint32 BaseRevision = 0;
+    float Microseconds = 0.0f;
+};
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "NextPiecePreviewWidget.generated.h"
+
+class UImage;
+class UPanelWidget;
+class UTextureRenderTarget2D;
+
+/**
+ * Shows the upcoming pieces as cached thumbnails, first piece first.
+ *
+ * Only the image brushes change when the queue advances. A Blueprint subclass can provide its own PieceList panel;
+ * without one a vertical box is built.
+ */
+UCLASS()
+class BLOCKCHAINBREAKOUTT_API UNextPiecePreviewWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    void SetThumbnails(const TArray<UTextureRenderTarget2D*>& Thumbnails);
+
+protected:
+    virtual void NativeOnInitialized() override;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    UPanelWidget* PieceList;
+
+    // Size of the first piece; later ones are drawn at half size
+    UPROPERTY(EditAnywhere, Category = "Preview")
+    float FirstPieceSize = 160.0f;
+
+private:
+    UPROPERTY(Transient)
+    TArray<UImage*> Images;
+};
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "PiecePreview.generated.h"
+
+class UTexture2D;
+class UTextureRenderTarget2D;
+
+// A piece waiting in the queue: just its layout and which token each block is, no actors
+struct FUpcomingPiece
+{
+    TArray<FVector2D> BlockOffsets;
+    TArray<int32> TokenIndices; // index into the token tables per block, INDEX_NONE for an SEC block
+    int32 ShapeIndex = INDEX_NONE; // into the board's TetrominoShapes; INDEX_NONE for an SEC row
+    bool bOfficer = false;
+};
+
+/**
+ * Renders piece thumbnails into small render targets and keeps the most recent ones.
+ *
+ * A thumbnail is identified by its block layout, token pattern and rotation, so a piece that comes round again
+ * costs a map lookup. The cache holds at most MaxEntries targets and redraws the least recently used one when full,
+ * so the number of render targets never grows during play.
+ */
+UCLASS()
+class BLOCKCHAINBREAKOUTT_API UPiecePreviewCache : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr int32 ThumbnailSize = 256;
+    static constexpr int32 MaxEntries = 32;
+
+    // TokenIcons is indexed by FUpcomingPiece::TokenIndices; OfficerIcon is used for INDEX_NONE
+    UTextureRenderTarget2D* GetThumbnail(const FUpcomingPiece& Piece, int32 Rotation, const TArray<UTexture2D*>& TokenIcons, UTexture2D* OfficerIcon);
+
+    int32 GetNumDraws() const { return NumDraws; }
+
+private:
+    void Draw(UTextureRenderTarget2D* Target, const FUpcomingPiece& Piece, int32 Rotation, const TArray<UTexture2D*>& TokenIcons, UTexture2D* OfficerIcon);
+    static FString MakeKey(const FUpcomingPiece& Piece, int32 Rotation);
+
+    UPROPERTY(Transient)
+    TArray<UTextureRenderTarget2D*> Targets;
+
+    TArray<FString> Keys;    // parallel to Targets
+    TArray<uint64> LastUsed; // parallel to Targets
+    uint64 UseCounter = 0;
+    int32 NumDraws = 0;
+};
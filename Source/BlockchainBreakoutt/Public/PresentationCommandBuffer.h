@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USoundBase;
+class UUserWidget;
+
+struct FPresentationVfxCommand
+{
+    FString SystemPath;
+    FVector Location = FVector::ZeroVector;
+    FLinearColor Color1 = FLinearColor::White;
+    FLinearColor Color2 = FLinearColor::White;
+    int32 Priority = 0;
+    int32 MergedCount = 1; // how many requests this command stands for
+};
+
+struct FPresentationWidgetCommand
+{
+    TSubclassOf<UUserWidget> WidgetClass;
+    UUserWidget** OutWidget = nullptr; // optional slot that receives the created widget
+};
+
+/**
+ * Presentation requests written by gameplay code during a frame and executed once at the end of it.
+ *
+ * Gameplay code no longer starts shakes or spawns particle systems directly; it records what it wants here and
+ * the grid flushes the buffer from Tick. Before execution:
+ *  - camera shakes collapse into one shake with the strongest requested scale
+ *  - VFX of the same system closer than VfxMergeDistance merge into one at their centroid
+ *  - the surviving VFX are sorted by priority and cut to MaxVfxPerFrame
+ *  - sounds and widget popups are deduplicated
+ */
+struct FPresentationCommandBuffer
+{
+    float VfxMergeDistance = 150.0f;
+    int32 MaxVfxPerFrame = 6;
+
+    void RequestCameraShake(float Scale = 1.0f)
+    {
+        CameraShakeScale = FMath::Max(CameraShakeScale, Scale);
+    }
+
+    void RequestVfx(const FString& SystemPath, const FVector& Location, const FLinearColor& Color1, const FLinearColor& Color2, int32 Priority = 0);
+
+    void RequestSound(USoundBase* Sound)
+    {
+        if (Sound)
+        {
+            Sounds.AddUnique(Sound);
+        }
+    }
+
+    void RequestWidget(TSubclassOf<UUserWidget> WidgetClass, UUserWidget** OutWidget = nullptr);
+
+    bool IsEmpty() const
+    {
+        return CameraShakeScale <= 0.0f && Vfx.Num() == 0 && Sounds.Num() == 0 && Widgets.Num() == 0;
+    }
+
+    // Sorts and trims the VFX list to the frame budget; call once before executing
+    void Resolve();
+
+    void Reset()
+    {
+        CameraShakeScale = 0.0f;
+        Vfx.Reset();
+        Sounds.Reset();
+        Widgets.Reset();
+    }
+
+    float CameraShakeScale = 0.0f;
+    TArray<FPresentationVfxCommand> Vfx;
+    TArray<USoundBase*> Sounds;
+    TArray<FPresentationWidgetCommand> Widgets;
+};
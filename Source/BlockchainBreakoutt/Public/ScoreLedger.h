@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScoreLedger.generated.h"
+
+UENUM(BlueprintType)
+enum class EScoreSource : uint8
+{
+    Row = 0,
+    PairExplosion = 1,
+    ThreeRowClear = 2,
+    Bomb = 3,
+    SuperBlock = 4,
+    Other = 5,
+    Count UMETA(Hidden)
+};
+
+/**
+ * Collects score earned during a resolution pass, tagged by where it came from.
+ *
+ * Nothing touches ATetrisGrid::Score until Commit, which the grid calls once per frame, so a chain
+ * reaction that destroys many blocks produces one score change and one victory check.
+ */
+struct FScoreLedger
+{
+    static constexpr int32 NumSources = (int32)EScoreSource::Count;
+
+    void Add(EScoreSource Source, int64 Value)
+    {
+        Pending[(int32)Source] += Value;
+        bHasPending = true;
+    }
+
+    bool HasPending() const { return bHasPending; }
+
+    // Moves pending entries into the level totals and returns their sum
+    int64 Commit()
+    {
+        int64 Total = 0;
+        for (int32 i = 0; i < NumSources; i++)
+        {
+            Total += Pending[i];
+            LevelTotals[i] += Pending[i];
+            Pending[i] = 0;
+        }
+        bHasPending = false;
+        return Total;
+    }
+
+    int64 GetLevelTotal(EScoreSource Source) const { return LevelTotals[(int32)Source]; }
+
+    // Rewind frames
+    void Serialize(FArchive& Ar)
+    {
+        for (int32 i = 0; i < NumSources; i++)
+        {
+            Ar << Pending[i];
+            Ar << LevelTotals[i];
+        }
+        Ar << bHasPending;
+    }
+
+    void Reset()
+    {
+        for (int32 i = 0; i < NumSources; i++)
+        {
+            Pending[i] = 0;
+            LevelTotals[i] = 0;
+        }
+        bHasPending = false;
+    }
+
+private:
+    int64 Pending[NumSources] = {};
+    int64 LevelTotals[NumSources] = {};
+    bool bHasPending = false;
+};
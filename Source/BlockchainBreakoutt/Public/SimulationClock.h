@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TimerManager.h"
+
+/**
+ * Turns frame time into a whole number of fixed simulation steps.
+ *
+ * Frame time is scaled and added to an accumulator; each full FixedStep in it is one step. A long frame adds at
+ * most MaxCatchUpSteps steps' worth of time, so a hitch slows the game down for a moment instead of replaying
+ * the missed time in one burst. While paused no time accumulates, but Step still queues single steps.
+ */
+class BLOCKCHAINBREAKOUTT_API FSimulationClock
+{
+public:
+    float FixedStep = 1.0f / 60.0f;
+    int32 MaxCatchUpSteps = 4;
+    float TimeScale = 1.0f;
+
+    // Steps to run this frame
+    int32 Advance(float RealDeltaSeconds);
+
+    void Pause() { bPaused = true; }
+    void Resume() { bPaused = false; }
+    bool IsPaused() const { return bPaused; }
+
+    // Runs Steps extra steps on the next Advance, paused or not
+    void Step(int32 Steps = 1) { QueuedSteps += FMath::Max(Steps, 0); }
+
+    uint64 GetStepCount() const { return StepCount; }
+    double GetTime() const { return StepCount * (double)FixedStep; }
+
+private:
+    double Accumulator = 0.0;
+    bool bPaused = false;
+    int32 QueuedSteps = 0;
+    uint64 StepCount = 0;
+};
+
+struct FSimTimerHandle
+{
+    uint64 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+    void Invalidate() { Id = 0; }
+};
+
+/**
+ * Timers on simulation time, driven by the board's fixed steps rather than the world clock, so pausing or
+ * scaling the simulation pauses or scales them and nothing else.
+ *
+ * Same calls as FTimerManager. Timers that fall due within one Advance fire in due-time order (ties in the order
+ * they were set), and a looping timer fires once for every interval that passed, so the sequence of callbacks
+ * only depends on the number of steps run.
+ */
+class BLOCKCHAINBREAKOUTT_API FSimTimerManager
+{
+public:
+    // Rate <= 0 clears the timer; FirstDelay < 0 means Rate
+    void SetTimer(FSimTimerHandle& InOutHandle, FTimerDelegate Delegate, float Rate, bool bLoop, float FirstDelay = -1.0f);
+
+    template<class UserClass>
+    void SetTimer(FSimTimerHandle& InOutHandle, UserClass* Object, typename FTimerDelegate::template TMethodPtr<UserClass> Method, float Rate, bool bLoop, float FirstDelay = -1.0f)
+    {
+        SetTimer(InOutHandle, FTimerDelegate::CreateUObject(Object, Method), Rate, bLoop, FirstDelay);
+    }
+
+    void ClearTimer(FSimTimerHandle& InOutHandle);
+    bool IsTimerActive(const FSimTimerHandle& Handle) const;
+    int32 GetNumActive() const { return Timers.Num(); }
+
+    // Moves simulation time forward and fires everything that fell due
+    void Advance(double DeltaSeconds);
+
+    double GetTime() const { return Time; }
+
+private:
+    struct FSimTimer
+    {
+        uint64 Id;
+        FTimerDelegate Delegate;
+        double DueTime;
+        float Rate;
+        bool bLoop;
+    };
+
+    int32 FindTimer(uint64 Id) const;
+
+    TArray<FSimTimer> Timers;
+    double Time = 0.0;
+    uint64 LastId = 0;
+};
@@ -30,8 +30,4 @@ struct FTetrisBlockValue
     UTexture2D* StockTickerTexture;
 
     FLinearColor Color;
-
-    bool ForceVolatilityToGoUp;
-
-    bool ForceVolatilityToGoDown;
 };
\ No newline at end of file
@@ -7,29 +7,11 @@
 #include "TetrisPlayerController.generated.h"
 
 /**
- * 
+ * Board input is bound by the possessed ATetrisGrid through Enhanced Input; the controller binds nothing itself
+ * so every key press reaches the board exactly once.
  */
 UCLASS()
 class BLOCKCHAINBREAKOUTT_API ATetrisPlayerController : public APlayerController
 {
 	GENERATED_BODY()
-
-protected:
-	virtual void SetupInputComponent() override;
-
-public:
-	UFUNCTION()
-	void MoveTetrominoLeft();
-
-	UFUNCTION()
-	void MoveTetrominoRight();
-
-	UFUNCTION()
-	void RotateTetromino();
-
-	UFUNCTION()
-	void StartFastDrop();
-
-	UFUNCTION()
-	void StopFastDrop();
 };
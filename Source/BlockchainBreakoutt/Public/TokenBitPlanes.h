@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Two orthogonally adjacent cells holding the same token; B is right of or above A
+struct FTokenPair
+{
+    int32 Token = INDEX_NONE;
+    FIntPoint A;
+    FIntPoint B;
+};
+
+/**
+ * Board occupancy split into one bit-plane per token: a row is WordsPerRow 64-bit words, and bit x % 64 of word
+ * x / 64 of row (Token, y) is set when cell (x, y) holds that token. Any board width fits; boards up to 64 wide
+ * take one word per row.
+ *
+ * Same-token neighbours fall out of word operations on each plane: Row & (Row >> 1) marks every horizontal pair by
+ * its left cell, Row[y] & Row[y + 1] every vertical pair by its lower cell. That is two ANDs and a shift per row
+ * word and token, instead of a name lookup per block and direction.
+ */
+class BLOCKCHAINBREAKOUTT_API FTokenBitPlanes
+{
+public:
+    static constexpr int32 MaxTokens = 64; // OutTokens of FindPairs is one word
+
+    void Reset(int32 InNumTokens, int32 InWidth, int32 InHeight);
+
+    // Token may be INDEX_NONE, which empties the cell
+    void SetCell(int32 X, int32 Y, int32 Token);
+    int32 GetCell(int32 X, int32 Y) const;
+
+    TConstArrayView<uint64> GetRow(int32 Token, int32 Y) const { return MakeArrayView(&Rows[(Token * Height + Y) * WordsPerRow], WordsPerRow); }
+    int32 GetNumTokens() const { return NumTokens; }
+    int32 GetWordsPerRow() const { return WordsPerRow; }
+
+    /**
+     * Appends every same-token pair whose first cell is set in FirstCellRows (WordsPerRow words per row, laid out
+     * like a plane), token by token,
+     * bottom to top, left to right, horizontal before vertical for the same cell. OutTokens gets a bit per token
+     * that paired.
+     */
+    void FindPairs(TConstArrayView<uint64> FirstCellRows, TArray<FTokenPair>& OutPairs, uint64& OutTokens) const;
+
+private:
+    int32 NumTokens = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 WordsPerRow = 0;
+
+    TArray<uint64> Rows;
+    TArray<int8> Cells; // token per cell, INDEX_NONE when empty, so a cell can be cleared without knowing its token
+};
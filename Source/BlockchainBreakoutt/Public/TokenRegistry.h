@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/Texture2D.h"
+#include "TokenRegistry.generated.h"
+
+// How a token moves with the market, and what a pair of it does to the market when it explodes
+UENUM(BlueprintType)
+enum class ETokenMarketClass : uint8
+{
+    Standard,
+    HighRisk,   // beta 1.5; an exploding pair crashes the market
+    Stablecoin, // beta 0.1; an exploding pair lifts the market
+};
+
+USTRUCT(BlueprintType)
+struct FTokenDefinition
+{
+    GENERATED_BODY()
+
+    // Lower-case key, also the file name of the token's historical price series
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    FString BlockName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    FString DisplayName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    FString Symbol;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    float BasePrice = 100.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    bool bStartsTrendingUp = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    ETokenMarketClass MarketClass = ETokenMarketClass::Standard;
+
+    // Explosion and row clear effect colour (HDR)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    FLinearColor Color = FLinearColor::White;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TSoftClassPtr<AActor> BlockClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TSoftClassPtr<AActor> SuperBlockClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TSoftObjectPtr<UTexture2D> TickerTexture;
+};
+
+/**
+ * The coins a board deals. A token's id is its index in Tokens, so everything per token (classes, colour, price
+ * lane, bit-plane) is found by indexing; adding a coin is a new entry here and nothing else.
+ *
+ * Classes and textures are soft references, loaded together in one async request before the board starts.
+ */
+UCLASS(BlueprintType)
+class BLOCKCHAINBREAKOUTT_API UTokenRegistry : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // Ids are uint8 and the board keeps one bit per token in a 64-bit mask
+    static constexpr int32 MaxTokens = 64;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tokens")
+    TArray<FTokenDefinition> Tokens;
+
+    // The seven coins the game shipped with, for boards that don't name a registry asset
+    void FillWithDefaults();
+
+    // Assets of the first MaxCount tokens
+    void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths, int32 MaxCount) const;
+
+    virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+};
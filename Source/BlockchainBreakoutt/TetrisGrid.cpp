@@ -17,11 +17,23 @@
 #include "TetrisBlock.h"
 #include "TetrisBlockValue.h"
 #include "DropState.h"
+#include "Engine/AssetManager.h"
+#include "Engine/LocalPlayer.h"
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Net/UnrealNetwork.h"
+#include "BreakoutVersusGameMode.h"
+#include "BoardMemoryTags.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "limits"
-#include "EngineUtils.h"
 
 ATetrisGrid::ATetrisGrid()
 {
@@ -59,9 +71,16 @@ ATetrisGrid::ATetrisGrid()
     }
 
     SpawnLocation = FVector(-200.0f, 0.0f, GridHeight * 100.0f);
-    NextTetrominoSpawnLocation = FVector(7890.0f, 3610.0f, 1240.0f);
 
-    MarketEventsInterval = FMath::RandRange(30.0f, 45.0f);
+    // The board replicates as packed cells and a piece description; blocks are local actors on every machine
+    bReplicates = true;
+    bAlwaysRelevant = true;
+    SetReplicateMovement(false);
+
+    AudioService = CreateDefaultSubobject<UBoardAudioService>(TEXT("AudioService"));
+    BlockPool = CreateDefaultSubobject<UBlockPoolComponent>(TEXT("BlockPool"));
+    BlockInstances = CreateDefaultSubobject<UBoardBlockInstances>(TEXT("BlockInstances"));
+    BoardStateQuad = CreateDefaultSubobject<UBoardStateQuad>(TEXT("BoardStateQuad"));
 
     static ConstructorHelpers::FObjectFinder<USoundBase> NudgeBase(TEXT("/Game/Audio/zip_Cue"));
     if (NudgeBase.Succeeded())
@@ -116,10 +135,30 @@ ATetrisGrid::ATetrisGrid()
 
 void ATetrisGrid::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Board);
+
     try {
         Super::BeginPlay();
 
-        OnUpdateScore.Broadcast();
+        SimClock.FixedStep = 1.0f / SimulationStepRate;
+        SimClock.MaxCatchUpSteps = MaxSimulationCatchUpSteps;
+        Rewind.SetCapacity(RewindCapacity);
+
+        const int32 Seed = RandomSeed != 0 ? RandomSeed : (int32)FPlatformTime::Cycles();
+        BoardRandom.Initialize(Seed);
+        // Garbage keeps its own stream so versus boards, which share a seed, are still dealt the same pieces
+        GarbageRandom.Initialize(Seed ^ 0x5A17C0DE);
+        UE_LOG(LogTemp, Log, TEXT("%s: random seed %d"), *GetName(), Seed);
+        MarketEventsInterval = BoardRandom.FRandRange(30.0f, 45.0f);
+
+        MarkScoreChanged();
+        RegisterAudioCues();
+
+        if (bRecordGameplayEvents || FParse::Param(FCommandLine::Get(), TEXT("GameplayEventLog")))
+        {
+            const FString EventLogPath = FPaths::ProjectLogDir() / FString::Printf(TEXT("GameplayEvents-%s.bbev"), *FDateTime::Now().ToString());
+            bEventLogStarted = FGameplayEventLog::Get().Start(EventLogPath);
+        }
 
         FString Path = TEXT("/Game/Blueprints/BP_TetrisBlock.BP_TetrisBlock_C");
         TetrisBlockBP = StaticLoadClass(UObject::StaticClass(), nullptr, *Path);
@@ -128,7 +167,8 @@ void ATetrisGrid::BeginPlay()
             UE_LOG(LogTemp, Warning, TEXT("Failed to set TetrisBlockBP class in BeginPlay"));
         }
 
-        APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+        // A client's copy of a board is possessed through replication, if at all
+        APlayerController* PlayerController = bPossessFirstPlayer && HasAuthority() ? GetWorld()->GetFirstPlayerController() : nullptr;
         if (PlayerController)
         {
             PlayerController->bShowMouseCursor = true;
@@ -137,167 +177,16 @@ void ATetrisGrid::BeginPlay()
             EnableInput(PlayerController);
             UE_LOG(LogTemp, Warning, TEXT("Enabling player input"));
         }
-        else{
-            UE_LOG(LogTemp, Warning, TEXT("Failed to enable player input"));
-        }
-
-        TetrominoShapes.Add({ { FVector2D(0, -1), FVector2D(0, 0), FVector2D(0, 1), FVector2D(0, 2) } }); // I Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(0, 1), FVector2D(1, 1) } }); // O Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(1, 0), FVector2D(0, 1) } }); // T Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(0, 1), FVector2D(-1, 1) } }); // S Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(0, 1), FVector2D(1, 1) } }); // Z Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(-1, 1), FVector2D(1, 0) } }); // J Shape
-        TetrominoShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(1, 1), FVector2D(-1, 0) } }); // L Shape
-
-        UTexture2D* BitcoinTickerTexture = GetTexture("/Game/Images/stock_market_textures/bitcoin_circ");
-        UTexture2D* EthereumTickerTexture = GetTexture("/Game/Images/stock_market_textures/ethereum_circ");
-        UTexture2D* XRPTickerTexture = GetTexture("/Game/Images/stock_market_textures/xrp_circ");
-        UTexture2D* PolkadotTickerTexture = GetTexture("/Game/Images/stock_market_textures/polkadot_circ");
-        UTexture2D* SolanaTickerTexture = GetTexture("/Game/Images/stock_market_textures/solana_circ");
-        UTexture2D* TetherTickerTexture = GetTexture("/Game/Images/stock_market_textures/tether_circ");
-        UTexture2D* USDCTickerTexture = GetTexture("/Game/Images/stock_market_textures/usdc_circ");
-
-        PointValues.Add({ "bitcoin", "Bitcoin", "BTC", "$20,000", true, BitcoinTickerTexture, FLinearColor(20.0f, 11.0f, 3.0f) }); // bitcoin
-        PointValues.Add({ "ethereum", "Ethereum", "ETH", "$12,000", false, EthereumTickerTexture, FLinearColor(15.0f, 15.0f, 15.0f) }); // ethereum
-        PointValues.Add({ "xrp", "XRP", "XRP", "$15,000", true, XRPTickerTexture, FLinearColor::White }); // xrp
-        PointValues.Add({ "polkadot", "Polkadot", "DOT", "$10", false, PolkadotTickerTexture, FLinearColor(10.0f, 5.0f, 5.0f) }); // polkadot
-        PointValues.Add({ "solana", "Solana", "SOL", "$505", true, SolanaTickerTexture, FLinearColor(2.0f, 17.0f, 14.0f) }); // solana
-        PointValues.Add({ "tether", "Tether", "USDT", "$100", true, TetherTickerTexture, FLinearColor(0.0f, 15.0f, 15.0f) }); // tether
-        PointValues.Add({ "usdc", "USDC", "USDC", "$110", true, USDCTickerTexture, FLinearColor(10.0f, 5.0f, 15.0f) }); // usdc
-
-        UpdateComboTarget();
-
-        FString bitcoinPath = TEXT("/Game/Blueprints/BP_bitcoin.BP_bitcoin_C");
-        UClass* BitcoinBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *bitcoinPath));
-        if (BitcoinBPClass)
-        {
-            TetrominoBlueprints.Add(BitcoinBPClass);
-        }
-
-        FString ethereumPath = TEXT("/Game/Blueprints/BP_ethereum.BP_ethereum_C");
-        UClass* EthereumBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *ethereumPath));
-        if (EthereumBPClass)
-        {
-            TetrominoBlueprints.Add(EthereumBPClass);
-        }
-
-        FString xrpPath = TEXT("/Game/Blueprints/BP_xrp.BP_xrp_C");
-        UClass* XrpBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *xrpPath));
-        if (XrpBPClass)
-        {
-            TetrominoBlueprints.Add(XrpBPClass);
-        }
-
-        FString polkadotPath = TEXT("/Game/Blueprints/BP_polkadot.BP_polkadot_C");
-        UClass* PolkadotBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *polkadotPath));
-        if (PolkadotBPClass)
-        {
-            TetrominoBlueprints.Add(PolkadotBPClass);
-        }
-
-        FString solanaPath = TEXT("/Game/Blueprints/BP_solana.BP_solana_C");
-        UClass* SolanaBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *solanaPath));
-        if (SolanaBPClass)
-        {
-            TetrominoBlueprints.Add(SolanaBPClass);
-        }
-
-        FString tetherPath = TEXT("/Game/Blueprints/BP_tether.BP_tether_C");
-        UClass* TetherBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *tetherPath));
-        if (TetherBPClass)
+        else if (bPossessFirstPlayer)
         {
-            TetrominoBlueprints.Add(TetherBPClass);
+            UE_LOG(LogTemp, Warning, TEXT("Failed to enable player input"));
         }
 
-        FString usdcPath = TEXT("/Game/Blueprints/BP_usdc.BP_usdc_C");
-        UClass* UsdcBPClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *usdcPath));
-        if (UsdcBPClass)
-        {
-            TetrominoBlueprints.Add(UsdcBPClass);
-        }
+        AddDefaultTetrominoShapes(TetrominoShapes);
 
         FString secPath = TEXT("/Game/Blueprints/BP_SEC.BP_SEC_C");
         SecClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *secPath));
 
-        // add superblocks
-
-        FString superBitcoinPath = TEXT("/Game/Blueprints/BP_superbitcoin.BP_superbitcoin_C");
-        UClass* SuperBitcoinClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superBitcoinPath));
-        if (SuperBitcoinClass)
-        {
-            SuperBlocks.Add(SuperBitcoinClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super bitcoin class");
-        }
-
-        FString superEthereumPath = TEXT("/Game/Blueprints/BP_superethereum.BP_superethereum_C");
-        UClass* SuperEthereumClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superEthereumPath));
-        if (SuperEthereumClass)
-        {
-            SuperBlocks.Add(SuperEthereumClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super ethereum class");
-        }
-
-        FString superXrpPath = TEXT("/Game/Blueprints/BP_superxrp.BP_superxrp_C");
-        UClass* SuperXrpClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superXrpPath));
-        if (SuperXrpClass)
-        {
-            SuperBlocks.Add(SuperXrpClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super xrp class");
-        }
-
-        FString superPolkadotPath = TEXT("/Game/Blueprints/BP_superpolkadot.BP_superpolkadot_C");
-        UClass* SuperPolkadotClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superPolkadotPath));
-        if (SuperPolkadotClass)
-        {
-            SuperBlocks.Add(SuperPolkadotClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super polkadot class");
-        }
-
-        FString superSolanaPath = TEXT("/Game/Blueprints/BP_supersolana.BP_supersolana_C");
-        UClass* SuperSolanaClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superSolanaPath));
-        if (SuperSolanaClass)
-        {
-            SuperBlocks.Add(SuperSolanaClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super solana class");
-        }
-
-        FString superTetherPath = TEXT("/Game/Blueprints/BP_supertether.BP_supertether_C");
-        UClass* SuperTetherClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superTetherPath));
-        if (SuperTetherClass)
-        {
-            SuperBlocks.Add(SuperTetherClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super tether class");
-        }
-
-        FString superUsdcPath = TEXT("/Game/Blueprints/BP_superusdc.BP_superusdc_C");
-        UClass* SuperUsdcClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *superUsdcPath));
-        if (SuperUsdcClass)
-        {
-            SuperBlocks.Add(SuperUsdcClass);
-        }
-        else
-        {
-			PrintScreen("Failed to load super usdc class");
-        }
-
         FString bombBlockPath = TEXT("/Game/Blueprints/BP_bomb.BP_bomb_C");
         BombBlockClass = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, *bombBlockPath));
 
@@ -312,14 +201,19 @@ void ATetrisGrid::BeginPlay()
 
         TetrisBoard = Cast<UClass>(StaticLoadObject(UClass::StaticClass(), nullptr, TEXT("/Game/Blueprints/BP_TetrisGrid.BP_TetrisGrid_C")));
 
-        UMaterialInterface* GlowBoardInst = Cast<UMaterialInterface>(StaticLoadObject(UMaterialInterface::StaticClass(), nullptr, TEXT("/Game/Materials/M_glow_inst.M_glow_inst")));
-		GlowMaterialForBoard = UMaterialInstanceDynamic::Create(GlowBoardInst, this);
+        {
+            LLM_SCOPE_BYTAG(BlockchainBreakout_Glow);
+            UMaterialInterface* GlowBoardInst = Cast<UMaterialInterface>(StaticLoadObject(UMaterialInterface::StaticClass(), nullptr, TEXT("/Game/Materials/M_glow_inst.M_glow_inst")));
+            GlowMaterialForBoard = UMaterialInstanceDynamic::Create(GlowBoardInst, this);
 
-		UMaterialInterface* BackgroundBoardInst = Cast<UMaterialInterface>(StaticLoadObject(UMaterialInterface::StaticClass(), nullptr, TEXT("/Game/Materials/M_hologram_board.M_hologram_board")));
-		BackgroundMaterialForBoard = UMaterialInstanceDynamic::Create(BackgroundBoardInst, this);
+            UMaterialInterface* BackgroundBoardInst = Cast<UMaterialInterface>(StaticLoadObject(UMaterialInterface::StaticClass(), nullptr, TEXT("/Game/Materials/M_hologram_board.M_hologram_board")));
+            BackgroundMaterialForBoard = UMaterialInstanceDynamic::Create(BackgroundBoardInst, this);
+            PerfCounters.DynamicMaterialInstances += 2;
+        }
 
         FActorSpawnParameters SpawnParams;
-        TetrisBoardInstance = GetWorld()->SpawnActor<AActor>(TetrisBoard, FVector(-500.0f, 0.0f, 0.0f), FRotator::ZeroRotator, SpawnParams);
+        SpawnParams.Owner = this;
+        TetrisBoardInstance = GetWorld()->SpawnActor<AActor>(TetrisBoard, BoardToWorld(FVector(-500.0f, 0.0f, 0.0f)), GetActorRotation(), SpawnParams);
 
         if (TetrisBoardInstance)
         {
@@ -351,395 +245,1987 @@ void ATetrisGrid::BeginPlay()
             }
         }
 
-        GetWorldTimerManager().SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, CurrentFallInterval, true);
-
-        UpdateMarketValues();
-        GetWorldTimerManager().SetTimer(UpdateMarketValuesTimer, this, &ATetrisGrid::UpdateMarketValues, 1.0f, true, 0.0f);
+        // The board starts once the token classes and textures are in
+        LoadTokenRegistry();
+    }
+    catch (const std::exception& e) {
+        UE_LOG(LogTemp, Error, TEXT("An exception was thrown in BeginPlay.  e: %s"), ANSI_TO_TCHAR(e.what()));
+    }
+}
 
-        GetWorldTimerManager().SetTimer(UpdateMarketEventsTimer, this, &ATetrisGrid::UpdateMarketEvents, MarketEventsInterval, true, -1.0f);
+void ATetrisGrid::AddDefaultTetrominoShapes(TArray<FTetrominoShape>& OutShapes)
+{
+    OutShapes.Add({ { FVector2D(0, -1), FVector2D(0, 0), FVector2D(0, 1), FVector2D(0, 2) } }); // I Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(0, 1), FVector2D(1, 1) } }); // O Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(1, 0), FVector2D(0, 1) } }); // T Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(0, 1), FVector2D(-1, 1) } }); // S Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(0, 1), FVector2D(1, 1) } }); // Z Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(-1, 0), FVector2D(-1, 1), FVector2D(1, 0) } }); // J Shape
+    OutShapes.Add({ { FVector2D(0, 0), FVector2D(1, 0), FVector2D(1, 1), FVector2D(-1, 0) } }); // L Shape
+}
 
-        GetWorldTimerManager().SetTimer(UpdateComboTargetTimer, this, &ATetrisGrid::UpdateComboTarget, FMath::RandRange(30.0f, 45.0f), true, -1.0f);
+void ATetrisGrid::FillSimulationConfig(int32 LevelIndex, const UTokenRegistry& Registry, FBreakoutSimConfig& OutConfig) const
+{
+    OutConfig.Width = GridWidth;
+    OutConfig.Height = GridHeight;
+    OutConfig.SpawnX = FMath::RoundToInt((SpawnLocation.X - BoardOffsetX) / CellSize);
+    OutConfig.Level = LevelsDataTable[FMath::Clamp(LevelIndex, 0, LevelsDataTable.Num() - 1)];
 
-        GetWorldTimerManager().SetTimer(MoveBlocksTimerHandle, this, &ATetrisGrid::MoveBlocksToDropDown, 0.1f, true, 0.0f);
+    // BeginPlay adds the defaults to whatever the asset lists
+    TArray<FTetrominoShape> Shapes = TetrominoShapes;
+    AddDefaultTetrominoShapes(Shapes);
+    OutConfig.Shapes.Reset();
+    for (const FTetrominoShape& Shape : Shapes)
+    {
+        TArray<FIntPoint>& Offsets = OutConfig.Shapes.AddDefaulted_GetRef();
+        for (const FVector2D& Offset : Shape.BlockOffsets)
+        {
+            Offsets.Add(FIntPoint(FMath::RoundToInt(Offset.X), FMath::RoundToInt(Offset.Y)));
+        }
+    }
 
+    // Same lanes as InitializeMarket
+    OutConfig.BasePrices.Reset();
+    OutConfig.Betas.Reset();
+    OutConfig.HighRiskMask = 0;
+    OutConfig.StablecoinMask = 0;
+    const int32 NumTokens = FMath::Min(Registry.Tokens.Num(), UTokenRegistry::MaxTokens);
+    for (int32 TokenId = 0; TokenId < NumTokens; TokenId++)
+    {
+        const FTokenDefinition& Token = Registry.Tokens[TokenId];
+        const bool bHighRisk = Token.MarketClass == ETokenMarketClass::HighRisk;
+        const bool bStablecoin = Token.MarketClass == ETokenMarketClass::Stablecoin;
 
-        int32 NextTetrominoIndex = FMath::RandRange(0, TetrominoShapes.Num() - 1);
-        NextTetrominoShape = TetrominoShapes[NextTetrominoIndex];
+        OutConfig.BasePrices.Add(Token.BasePrice);
+        OutConfig.Betas.Add(bHighRisk ? 1.5f : bStablecoin ? 0.1f : 1.0f);
+        OutConfig.HighRiskMask |= bHighRisk ? 1ull << TokenId : 0;
+        OutConfig.StablecoinMask |= bStablecoin ? 1ull << TokenId : 0;
+    }
 
-        // PrepareFirstTetromino();
-        PrepareNextTetromino();
+    OutConfig.MarketTickInterval = MarketTickInterval;
+    OutConfig.MarketVolatility = MarketVolatility;
+    OutConfig.MarketEventDrift = MarketEventDrift;
+    OutConfig.BullRunFallInterval = BullRunFallInterval;
+    OutConfig.CryptoCrashFallInterval = CryptoCrashFallInterval;
+    OutConfig.FastFallInterval = FastFallInterval;
+    OutConfig.RoundsBeforeSecSpawn = RoundsBeforeSecSpawn;
+}
 
-        SpawnTetromino();
-        RoundsLeftBeforeSecSpawn--;
-    }
-    catch (const std::exception& e) {
-        UE_LOG(LogTemp, Error, TEXT("An exception was thrown in BeginPlay.  e: %s"), ANSI_TO_TCHAR(e.what()));
+void ATetrisGrid::LoadTokenRegistry()
+{
+    if (TokenRegistryAsset.IsNull())
+    {
+        TokenRegistry = NewObject<UTokenRegistry>(this);
+        TokenRegistry->FillWithDefaults();
+        LoadTokenAssets();
+        return;
     }
+
+    TokenLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(TokenRegistryAsset.ToSoftObjectPath(),
+        FStreamableDelegate::CreateUObject(this, &ATetrisGrid::OnTokenRegistryLoaded));
 }
 
-void ATetrisGrid::Tick(float DeltaTime)
+void ATetrisGrid::OnTokenRegistryLoaded()
 {
-    Super::Tick(DeltaTime);
+    TokenRegistry = TokenRegistryAsset.Get();
+    if (!TokenRegistry || TokenRegistry->Tokens.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Token registry %s failed to load or is empty; using the default tokens"), *TokenRegistryAsset.ToString());
+        TokenRegistry = NewObject<UTokenRegistry>(this);
+        TokenRegistry->FillWithDefaults();
+    }
+
+    LoadTokenAssets();
 }
 
-UTexture2D* ATetrisGrid::GetTexture(FString source)
+void ATetrisGrid::LoadTokenAssets()
 {
-    UTexture2D* texture = nullptr;
-    
-    FStringAssetReference TextureAssetRef(source);
-    texture = Cast<UTexture2D>(TextureAssetRef.TryLoad());
-
-    if (texture == nullptr)
+    // The registry is a loaded asset, so extra tokens are skipped here rather than trimmed off it
+    if (TokenRegistry->Tokens.Num() > UTokenRegistry::MaxTokens)
     {
-        UE_LOG(LogTemp, Log, TEXT("Failed to load image texture %s"), *source);
+        UE_LOG(LogTemp, Warning, TEXT("Token registry lists %d tokens; only the first %d are used"), TokenRegistry->Tokens.Num(), UTokenRegistry::MaxTokens);
     }
 
-    return texture;
+    TArray<FSoftObjectPath> Paths;
+    TokenRegistry->GetAssetsToLoad(Paths, UTokenRegistry::MaxTokens);
+    TokenLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, FStreamableDelegate::CreateUObject(this, &ATetrisGrid::OnTokenAssetsLoaded));
 }
 
-void ATetrisGrid::PrepareFirstTetromino()
+void ATetrisGrid::OnTokenAssetsLoaded()
 {
-    if (UWorld* World = GetWorld())
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Board);
+
+    PointValues.Reset();
+    TetrominoBlueprints.Reset();
+    SuperBlocks.Reset();
+    TokenIdByClass.Reset();
+
+    const int32 NumTokens = FMath::Min(TokenRegistry->Tokens.Num(), UTokenRegistry::MaxTokens);
+    for (int32 TokenId = 0; TokenId < NumTokens; TokenId++)
     {
-        for (AActor* NextBlockActor : NextTetrominoBlocks)
-        {
-            NextBlockActor->Destroy();
-        }
+        const FTokenDefinition& Token = TokenRegistry->Tokens[TokenId];
 
-        NextTetrominoBlocks.Empty();
+        FTetrisBlockValue& PointValue = PointValues.AddDefaulted_GetRef();
+        PointValue.BlockName = Token.BlockName;
+        PointValue.BlockNameDisplay = Token.DisplayName;
+        PointValue.BlockSymbol = Token.Symbol;
+        PointValue.ScoreValue = FString::Printf(TEXT("$%d"), (int32)Token.BasePrice);
+        PointValue.VolatilityGoingUp = Token.bStartsTrendingUp;
+        PointValue.StockTickerTexture = Token.TickerTexture.Get();
+        PointValue.Color = Token.Color;
 
-        const FTetrominoShape& SelectedShape = NextTetrominoShape;
-        TSubclassOf<AActor> TetrominoBlueprint;
-        
-        int32 ShapeIndex = FMath::RandRange(0, TetrominoShapes.Num() - 1);
-        NextTetrominoShape = TetrominoShapes[ShapeIndex];
+        // Entries stay in id order even when a class is missing, so ids keep indexing every array
+        UClass* BlockClass = Token.BlockClass.Get();
+        UClass* SuperBlockClass = Token.SuperBlockClass.Get();
+        TetrominoBlueprints.Add(BlockClass);
+        SuperBlocks.Add(SuperBlockClass);
 
-        int32 CryptoBlockIndex;
+        if (BlockClass)
+        {
+            TokenIdByClass.Add(BlockClass, (uint8)TokenId);
+        }
+        else
+        {
+            PrintScreen(FString::Printf(TEXT("Failed to load %s block class"), *Token.BlockName));
+        }
 
-        for (const FVector2D& Offset : NextTetrominoShape.BlockOffsets)
+        if (SuperBlockClass)
+        {
+            TokenIdByClass.Add(SuperBlockClass, (uint8)TokenId);
+        }
+        else
         {
-            CryptoBlockIndex = 0;
-            TetrominoBlueprint = TetrominoBlueprints[CryptoBlockIndex];
+            PrintScreen(FString::Printf(TEXT("Failed to load super %s class"), *Token.BlockName));
+        }
+    }
 
-            FVector BlockLocation = NextTetrominoSpawnLocation + FVector(Offset.X * 100.0f, 0.0f, Offset.Y * 100.0f);
-            AActor* Block = World->SpawnActor<AActor>(TetrominoBlueprint, BlockLocation, FRotator::ZeroRotator);
+    UpdateComboTarget();
+    InitializeMarket();
+    TokenPlanes.Reset(PointValues.Num(), GridWidth, GridHeight);
+    BoardHash.Reset(GridWidth, GridHeight);
+    BlockInstances->Initialize(GridWidth, GridHeight, PointValues.Num());
+    bBlockInstancesStale = true;
+    BoardStateQuad->Initialize(GridWidth, GridHeight, PointValues.Num(), GridToWorld(0, 0), GridToWorld(GridWidth - 1, GridHeight - 1), CellSize);
 
-            if (Block)
-            {
-                NextTetrominoBlocks.Add(Block);
-            }
-        }
-        UE_LOG(LogTemp, Warning, TEXT("Preparing regular tetromino"));
+    // Clients only draw what the server replicates
+    if (!HasAuthority())
+    {
+        ApplyNetBoard();
+        ApplyNetPiece();
+        return;
     }
+
+    if (bUseHistoricalReplay)
+    {
+        OpenHistoricalReplay();
+    }
+
+    StartBoard();
 }
 
-void ATetrisGrid::PrepareNextTetromino()
+int32 ATetrisGrid::GetTokenId(const AActor* Actor) const
 {
-    if (UWorld* World = GetWorld())
-    {
-        for (AActor* NextBlockActor : NextTetrominoBlocks)
-        {
-            NextBlockActor->Destroy();
-        }
+    const uint8* TokenId = Actor ? TokenIdByClass.Find(Actor->GetClass()) : nullptr;
+    return TokenId ? *TokenId : INDEX_NONE;
+}
 
-        NextTetrominoBlocks.Empty();
+void ATetrisGrid::StartBoard()
+{
+    SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, CurrentFallInterval, true);
 
-        const FTetrominoShape& SelectedShape = NextTetrominoShape;
-        TSubclassOf<AActor> TetrominoBlueprint;
-        
-        int32 ShapeIndex = FMath::RandRange(0, TetrominoShapes.Num() - 1);
-        NextTetrominoShape = TetrominoShapes[ShapeIndex];
+    UpdateMarketValues();
+    SimTimers.SetTimer(UpdateMarketValuesTimer, this, &ATetrisGrid::UpdateMarketValues, MarketTickInterval, true, 0.0f);
+
+    SimTimers.SetTimer(UpdateMarketEventsTimer, this, &ATetrisGrid::UpdateMarketEvents, MarketEventsInterval, true, -1.0f);
+
+    SimTimers.SetTimer(UpdateComboTargetTimer, this, &ATetrisGrid::UpdateComboTarget, BoardRandom.FRandRange(30.0f, 45.0f), true, -1.0f);
 
-        int32 CryptoBlockIndex;
+    SimTimers.SetTimer(MoveBlocksTimerHandle, this, &ATetrisGrid::MoveBlocksToDropDown, 0.1f, true, 0.0f);
 
-        for (const FVector2D& Offset : NextTetrominoShape.BlockOffsets)
+
+    if (bPossessFirstPlayer)
+    {
+        PiecePreviewCache = NewObject<UPiecePreviewCache>(this);
+        TSubclassOf<UNextPiecePreviewWidget> PreviewClass = NextPiecePreviewClass ? NextPiecePreviewClass : TSubclassOf<UNextPiecePreviewWidget>(UNextPiecePreviewWidget::StaticClass());
+        LLM_SCOPE_BYTAG(BlockchainBreakout_UI);
+        NextPiecePreviewWidget = CreateWidget<UNextPiecePreviewWidget>(GetWorld(), PreviewClass);
+        if (NextPiecePreviewWidget)
         {
-            CryptoBlockIndex = FMath::RandRange(0, TetrominoBlueprints.Num() - 1);
-            TetrominoBlueprint = TetrominoBlueprints[CryptoBlockIndex];
+            NextPiecePreviewWidget->AddToViewport();
+        }
+    }
 
-            FVector BlockLocation = NextTetrominoSpawnLocation + FVector(Offset.X * 100.0f, 0.0f, Offset.Y * 100.0f);
-            AActor* Block = World->SpawnActor<AActor>(TetrominoBlueprint, BlockLocation, FRotator::ZeroRotator);
+    RefillUpcomingPieces();
 
-            if (Block)
-            {
-                NextTetrominoBlocks.Add(Block);
-            }
+    SpawnTetromino();
+    RoundsLeftBeforeSecSpawn--;
+
+    int32 SoakPieces = 0;
+    if (bPossessFirstPlayer && FParse::Value(FCommandLine::Get(), TEXT("BoardSoak="), SoakPieces))
+    {
+        bSoakExitWhenDone = FParse::Param(FCommandLine::Get(), TEXT("BoardSoakExit"));
+        int32 SoakSeed = 0;
+        FParse::Value(FCommandLine::Get(), TEXT("BoardSoakSeed="), SoakSeed);
+        if (FParse::Param(FCommandLine::Get(), TEXT("BoardSoakParity")))
+        {
+            StartSimulationParityCheck(SoakPieces, SoakSeed);
+        }
+        else
+        {
+            StartBoardSoak(SoakPieces, SoakSeed);
         }
-        UE_LOG(LogTemp, Warning, TEXT("Preparing regular tetromino"));
+    }
+    else if (bPossessFirstPlayer && FParse::Param(FCommandLine::Get(), TEXT("BoardBombCheck")))
+    {
+        bSoakExitWhenDone = FParse::Param(FCommandLine::Get(), TEXT("BoardSoakExit"));
+        StartBombCheck();
     }
 }
 
-void ATetrisGrid::PrepareOfficerTetromino()
+void ATetrisGrid::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    if (UWorld* World = GetWorld())
+    if (bEventLogStarted)
     {
-        if (SecClass)
-        {
-            for (AActor* NextBlockActor : NextTetrominoBlocks)
-            {
-                NextBlockActor->Destroy();
-            }
+        FGameplayEventLog::Get().Stop();
+        bEventLogStarted = false;
+    }
 
-            NextTetrominoBlocks.Empty();
+    Super::EndPlay(EndPlayReason);
+}
 
-            TArray<FVector2D> BlockOffsets;
+void ATetrisGrid::RegisterAudioCues()
+{
+    // Voices per cue: input sounds overlap on fast repeats, big effects rarely need more than a couple at once
+    AudioService->RegisterCue(ShuffleCue2, 2);
+    AudioService->RegisterCue(ExplosionCue, 3);
+    AudioService->RegisterCue(LaserBurstCue, 2);
+    AudioService->RegisterCue(NudgeCue, 1);
+    AudioService->RegisterCue(RotateCue, 1);
+    AudioService->RegisterCue(ButtonPushCue, 1);
+    AudioService->RegisterCue(ClickCue, 1);
+    AudioService->RegisterCue(StoneCue2, 2);
+}
 
-            for (int32 x = -8; x < GridWidth - 8; ++x)
-            {
-                BlockOffsets.Add(FVector2D(x, 0));
-            }
+void ATetrisGrid::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Board);
 
-            NextTetrominoShape = { BlockOffsets };
+    // Rule temporaries made this frame on the game thread are handed back when it ends
+    FBoardArenaMark FrameArenaMark;
 
-            TSubclassOf<AActor> TetrominoBlueprint = SecClass;
-            
-            for (const FVector2D& Offset : BlockOffsets)
-            {
-                FVector BlockLocation = NextTetrominoSpawnLocation + FVector(Offset.X * 100.0f, 0.0f, Offset.Y * 100.0f);
-                AActor* Block = World->SpawnActor<AActor>(TetrominoBlueprint, BlockLocation, FRotator::ZeroRotator);
+    const int32 Steps = SimClock.Advance(DeltaTime);
+    const uint64 FirstStep = SimClock.GetStepCount() - Steps;
+    for (int32 i = 0; i < Steps; i++)
+    {
+        RunSimulationStep(FirstStep + i);
+    }
 
-                if (Block)
-                {
-                    NextTetrominoBlocks.Add(Block);
-                }
-            }
+    // A paused board runs no steps, but soft drop still has to follow the key
+    if (Steps == 0 && SimClock.IsPaused())
+    {
+        ProcessInputCommands(SimClock.GetStepCount());
+    }
 
-            UE_LOG(LogTemp, Warning, TEXT("Preparing officer tetromino"));
-        }
+    if (HasAuthority() && GetNetMode() != NM_Standalone)
+    {
+        PublishNetBoard();
+        PublishNetPiece();
     }
-}
 
-void ATetrisGrid::SpawnTetromino()
-{
-    if (!bIsClearing)
+    FlushPresentation();
+    FlushUIDelta();
+
+    if (BoardStateQuad->IsRenderingBoard())
     {
-        if (UWorld* World = GetWorld())
-        {
-            for (int32 i = 0; i < NextTetrominoShape.BlockOffsets.Num(); ++i)
-            {
-                FVector2D Offset = NextTetrominoShape.BlockOffsets[i];
-                TSubclassOf<AActor> TetrominoBlueprint = NextTetrominoBlocks[i]->GetClass();
-                if (TetrominoBlueprint == SecClass)
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Whyyy?"));
-                }
-                FVector BlockLocation = SpawnLocation + FVector(Offset.X * 100.0f, 0.0f, Offset.Y * 100.0f);
-                AActor* NextBlock = World->SpawnActor<AActor>(TetrominoBlueprint, BlockLocation, FRotator::ZeroRotator);
+        LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+        BoardStateQuad->Flush(CurrentGlowFactor, CurrentGlowPower);
+    }
+    else if (BlockInstances->IsRenderingBlocks() && (bBlockInstancesStale || bIsAnimating || SimTimers.IsTimerActive(GlowTimerHandle)))
+    {
+        LLM_SCOPE_BYTAG(BlockchainBreakout_Blocks);
+        bBlockInstancesStale = false;
+        BlockInstances->Sync(Grid, [this](int32 x, int32 y) { return GetNetCellCode(x, y); }, CurrentGlowFactor, CurrentGlowPower);
+    }
 
-                if (NextBlock)
-                {
-                    NextBlock->Tags.Add(FName("TetrisBlock"));
-                    CurrentTetrominoBlocks.Add(NextBlock);
-                }
-            }
+    bool bSoakPassed = false;
+    if (SoakMonitor.IsActive() && SoakMonitor.Tick(GetWorld(), bSoakPassed))
+    {
+        ReportBoardSoak(bSoakPassed);
+    }
 
-            if (RoundsLeftBeforeSecSpawn != 1)
-            {
-                for (AActor* NextBlock : NextTetrominoBlocks)
-                {
-                    NextBlock->Destroy();
-                }
-                NextTetrominoBlocks.Empty();
-                PrepareNextTetromino();
-            }
-            else
-            {
-                for (AActor* NextBlock : NextTetrominoBlocks)
-                {
-                    NextBlock->Destroy();
-                }
-                NextTetrominoBlocks.Empty();
-                PrepareOfficerTetromino();
-            }
-        }
+    MemorySampleAge += DeltaTime;
+    if (MemorySampleAge >= 1.0f)
+    {
+        MemorySampleAge = 0.0f;
+        FBoardMemoryReport::Sample();
+    }
+
+    PerfCounters.EndFrame();
+    PerfSnapshotAge += DeltaTime;
+    if (PerfHUDWidget && PerfSnapshotAge >= 0.25f)
+    {
+        RefreshPerfSnapshot();
     }
 }
 
-void ATetrisGrid::MoveTetromino(const FVector2D& Direction)
+void ATetrisGrid::RunSimulationStep(uint64 Step)
 {
-    try {
-        bool bCanMove = true;
+    CurrentSimStep = Step;
 
-        for (AActor* Block : CurrentTetrominoBlocks)
-        {
-            FVector CurrentLocation = Block->GetActorLocation();
-            FVector2D GridPosition = FVector2D((CurrentLocation.X + 1000.0f) / 100.0f, CurrentLocation.Z / 100.0f);
-            FVector2D NewGridPosition = GridPosition + Direction;
+    if (SoakMonitor.IsRunning())
+    {
+        TickSoakInput();
+    }
+    ProcessInputCommands(Step);
 
-            if (NewGridPosition.X < 0 || NewGridPosition.X >= GridWidth || NewGridPosition.Y < 0 || IsGridOccupied(NewGridPosition.X, NewGridPosition.Y) != nullptr)
-            {
-                bCanMove = false;
-                break;
-            }
-        }
+    if (bBombCheckPending && SimClock.GetTime() > BombCheckDeadline)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: no piece dealt after the bomb went off"), *GetName());
+        FinishBombCheck(false);
+    }
 
-        if (bCanMove)
-        {
-            if (ShuffleCue2)
-            {
-                UGameplayStatics::PlaySoundAtLocation(this, ShuffleCue2, GetActorLocation());
-            }
+    ApplyRuleTasks();
+    SimTimers.Advance(SimClock.FixedStep);
+    CommitScore();
+}
 
-            for (AActor* Block : CurrentTetrominoBlocks)
-            {
-                FVector CurrentLocation = Block->GetActorLocation();
-                FVector NewLocation = CurrentLocation + FVector(Direction.X * 100.0f, 0.0f, Direction.Y * 100.0f);
-                Block->SetActorLocation(NewLocation);
-            }
-        }
-    }
-    catch (const std::exception& e) {
-        UE_LOG(LogTemp, Error, TEXT("An exception was thrown.  e: %s"), ANSI_TO_TCHAR(e.what()));
-    }
+void ATetrisGrid::StepSimulation(int32 Steps)
+{
+    SimClock.Step(Steps);
 }
 
-void ATetrisGrid::MoveTetrominoLeft()
+void ATetrisGrid::SetSimulationSpeed(float Speed)
 {
-    MoveTetromino(FVector2D(-1, 0));
+    SimClock.TimeScale = FMath::Max(Speed, 0.0f);
 }
 
-void ATetrisGrid::MoveTetrominoRight()
+void ATetrisGrid::RewindPieces(int32 Pieces)
 {
-    MoveTetromino(FVector2D(1, 0));
+    RestoreRewindFrame(FMath::Clamp(Pieces, 0, Rewind.Num() - 1));
 }
 
-void ATetrisGrid::MoveTetrominoDown()
+void ATetrisGrid::RewindSeconds(float Seconds)
 {
-    bool bCanMove = true;
+    RestoreRewindFrame(Rewind.FindStepsBack(SimClock.GetTime(), Seconds));
+}
 
-    // Check if movement is possible
-    for (AActor* Block : CurrentTetrominoBlocks)
+namespace
+{
+    // Tags a block can carry that aren't on its class; a frame keeps one bit per entry
+    TConstArrayView<FName> GetRewindTags()
     {
-        FVector CurrentLocation = Block->GetActorLocation();
-        FVector2D GridPosition = FVector2D((CurrentLocation.X + 1000.0f) / 100.0f, CurrentLocation.Z / 100.0f);
-        FVector2D NewGridPosition = GridPosition + FVector2D(0, -1);
+        static const FName Tags[] = {
+            FName("TetrisBlock"), FName("SuperBlock"), FName("SuperDuperBlock"), FName("BombBlock"),
+            FName("CanClearThreeRows"), FName("CannotBlowUpYet"), FName("CanSuperDuper"), FName("ToGlow"),
+            FName("GlowBlock"), FName("OfficerBlock"), FName("Destroy")
+        };
+        return Tags;
+    }
 
-        if (NewGridPosition.Y < 0 || IsGridOccupied(NewGridPosition.X, NewGridPosition.Y) != nullptr)
-        {
-            bCanMove = false;
-            break;
-        }
+    // Which already restored neighbour a cell shares its actor with (bombs cover 2x2 cells)
+    enum class ERewindCellPart : uint8
+    {
+        Anchor,
+        Left,
+        Below,
+        BelowLeft,
+    };
+}
+
+void ATetrisGrid::SerializeRewindState(FArchive& Ar)
+{
+    Ar << CurrentLevelIndex;
+    Ar << Score;
+    ScoreLedger.Serialize(Ar);
+    Ar << Combos;
+    Ar << ComboTargetToken;
+    if (Ar.IsLoading())
+    {
+        ComboTarget = GetComboTargetName();
+    }
+    Ar << RoundsLeftBeforeSecSpawn;
+    Ar << ShouldSpawnOfficerTetromino;
+    Ar << InOfficerBlocksRound;
+    Ar << CurrentFallInterval;
+    Ar << MarketEventsInterval;
+
+    uint8 MarketEvent = (uint8)CurrentMarketEvent;
+    Ar << MarketEvent;
+    CurrentMarketEvent = (EMarketEvent)MarketEvent;
+
+    Market.Serialize(Ar);
+
+    // A stream continues exactly from its current seed
+    int32 BoardSeed = BoardRandom.GetCurrentSeed();
+    int32 MarketSeed = MarketRandom.GetCurrentSeed();
+    int32 GarbageSeed = GarbageRandom.GetCurrentSeed();
+    Ar << BoardSeed;
+    Ar << MarketSeed;
+    Ar << GarbageSeed;
+    if (Ar.IsLoading())
+    {
+        BoardRandom.Initialize(BoardSeed);
+        MarketRandom.Initialize(MarketSeed);
+        GarbageRandom.Initialize(GarbageSeed);
+    }
+
+    int32 NumUpcoming = UpcomingPieces.Num();
+    Ar << NumUpcoming;
+    UpcomingPieces.SetNum(NumUpcoming);
+    for (FUpcomingPiece& Piece : UpcomingPieces)
+    {
+        Ar << Piece.BlockOffsets;
+        Ar << Piece.TokenIndices;
+        Ar << Piece.ShapeIndex;
+        Ar << Piece.bOfficer;
+    }
+}
+
+uint8 ATetrisGrid::GetRewindClassId(UClass* Class)
+{
+    if (const uint8* Id = RewindClassIds.Find(Class))
+    {
+        return *Id;
+    }
+
+    if (RewindClasses.Num() == 0)
+    {
+        RewindClasses.Add(nullptr);
+    }
+    if (RewindClasses.Num() > MAX_uint8)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Rewind: too many block classes, %s is not recorded"), *Class->GetName());
+        return 0;
+    }
+
+    const uint8 Id = (uint8)RewindClasses.Add(Class);
+    RewindClassIds.Add(Class, Id);
+    return Id;
+}
+
+void ATetrisGrid::RecordRewindFrame()
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Rewind);
+
+    TArray<uint8> Frame;
+    FMemoryWriter Ar(Frame);
+    SerializeRewindState(Ar);
+
+    const TConstArrayView<FName> RewindTags = GetRewindTags();
+
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            AActor* Block = Grid[x][y];
+            uint8 ClassId = 0;
+            uint8 Part = (uint8)ERewindCellPart::Anchor;
+            uint16 TagBits = 0;
+
+            if (IsValid(Block))
+            {
+                Part = x > 0 && Grid[x - 1][y] == Block ? (uint8)ERewindCellPart::Left
+                    : y > 0 && Grid[x][y - 1] == Block ? (uint8)ERewindCellPart::Below
+                    : x > 0 && y > 0 && Grid[x - 1][y - 1] == Block ? (uint8)ERewindCellPart::BelowLeft
+                    : (uint8)ERewindCellPart::Anchor;
+
+                ClassId = GetRewindClassId(Block->GetClass());
+                for (int32 Bit = 0; Bit < RewindTags.Num(); Bit++)
+                {
+                    TagBits |= Block->Tags.Contains(RewindTags[Bit]) ? (1 << Bit) : 0;
+                }
+            }
+
+            Ar << ClassId;
+            Ar << Part;
+            Ar << TagBits;
+        }
+    }
+
+    Rewind.Push(MoveTemp(Frame), SimClock.GetTime());
+}
+
+bool ATetrisGrid::RestoreRewindFrame(int32 StepsBack)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Rewind);
+
+    TArray<uint8> Frame;
+    if (!Rewind.GetFrame(StepsBack, Frame))
+    {
+        PrintScreen(TEXT("Nothing to rewind to"));
+        return false;
+    }
+
+    // Nothing in flight applies to the restored board
+    if (ComboTask.IsValid())
+    {
+        ComboTask.Wait();
+        ComboTask = UE::Tasks::TTask<FBoardEvaluation>();
+    }
+    if (MarketTask.IsValid())
+    {
+        MarketTask.Wait();
+        MarketTask = UE::Tasks::TTask<FMarketTickResult>();
+    }
+    for (FSimTimerHandle* Handle : { &CheckIfReadyToSpawnTetromino, &DropTimerHandle, &GlowTimerHandle, &VictoryTimerHandle, &BlinkBoardTimerHandle })
+    {
+        SimTimers.ClearTimer(*Handle);
+    }
+    GlowMaterials.Empty();
+    CurrentGlowFactor = 0.0f;
+    CurrentGlowPower = 1.0f;
+    TargetActors.GlowBlocks.Empty();
+    BlocksToDrop.Empty();
+    BlocksToMove.Empty();
+    RowsToMove.Empty();
+    DropsArray.Empty();
+    bAnyDropInProgress = false;
+    bIsCheckingForCombos = false;
+    bIsClearing = false;
+    ElapsedBlinking = 0.0f;
+
+    // Same actors, new cells: releasing and acquiring a class in turn hands back the block just released
+    TArray<AActor*> Released = MoveTemp(CurrentTetrominoBlocks);
+    CurrentTetrominoBlocks.Reset();
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            if (Grid[x][y] != nullptr)
+            {
+                Released.AddUnique(Grid[x][y]);
+                SetGrid(x, y, nullptr);
+            }
+        }
+    }
+    for (AActor* Block : Released)
+    {
+        BlockPool->Release(Block);
+    }
+
+    FMemoryReader Ar(Frame);
+    SerializeRewindState(Ar);
+
+    const TConstArrayView<FName> RewindTags = GetRewindTags();
+
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            uint8 ClassId = 0;
+            uint8 Part = 0;
+            uint16 TagBits = 0;
+            Ar << ClassId;
+            Ar << Part;
+            Ar << TagBits;
+
+            if (ClassId == 0 || !RewindClasses.IsValidIndex(ClassId))
+            {
+                continue;
+            }
+
+            switch ((ERewindCellPart)Part)
+            {
+            case ERewindCellPart::Left:
+                SetGrid(x, y, Grid[x - 1][y]);
+                continue;
+            case ERewindCellPart::Below:
+                SetGrid(x, y, Grid[x][y - 1]);
+                continue;
+            case ERewindCellPart::BelowLeft:
+                SetGrid(x, y, Grid[x - 1][y - 1]);
+                continue;
+            default:
+                break;
+            }
+
+            AActor* Block = BlockPool->Acquire(RewindClasses[ClassId], GridToWorld(x, y), GetActorRotation());
+            if (!Block)
+            {
+                continue;
+            }
+            for (int32 Bit = 0; Bit < RewindTags.Num(); Bit++)
+            {
+                if (TagBits & (1 << Bit))
+                {
+                    Block->Tags.AddUnique(RewindTags[Bit]);
+                }
+            }
+            SetGrid(x, y, Block);
+        }
+    }
+
+    CurrentLevel = LevelsDataTable[FMath::Clamp(CurrentLevelIndex, 0, LevelsDataTable.Num() - 1)];
+    DefaultFallInterval = CurrentLevel.FallingSpeed;
+    CurrentColorPickerValue = 0.0f;
+    SetVictoryBoardMaterial(0.0f, CurrentLevel.BackgroundColor, 0.0f);
+
+    SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, IsFastDropping ? FastFallInterval : CurrentFallInterval, true);
+    SimTimers.SetTimer(MoveBlocksTimerHandle, this, &ATetrisGrid::MoveBlocksToDropDown, 0.1f, true, 0.0f);
+
+    bPreviewUpToDate = false;
+    for (int32 TokenIndex = 0; TokenIndex < PointValues.Num(); TokenIndex++)
+    {
+        MarkTokenChanged(TokenIndex);
+    }
+    MarkScoreChanged();
+    MarkNotchesChanged();
+
+    UE_LOG(LogTemp, Log, TEXT("%s: rewound %d pieces"), *GetName(), StepsBack);
+
+    // Dealing records the restored frame again as the newest
+    Rewind.DiscardNewest(StepsBack + 1);
+    DealNextPiece();
+    return true;
+}
+
+void ATetrisGrid::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(ATetrisGrid, NetKeyframe);
+    DOREPLIFETIME(ATetrisGrid, NetDelta);
+    DOREPLIFETIME(ATetrisGrid, NetPiece);
+    DOREPLIFETIME(ATetrisGrid, Score);
+    DOREPLIFETIME(ATetrisGrid, Combos);
+    DOREPLIFETIME(ATetrisGrid, VersusOpponent);
+}
+
+uint16 ATetrisGrid::GetNetCellCode(int32 x, int32 y) const
+{
+    const AActor* Block = Grid[x][y];
+    if (!IsValid(Block))
+    {
+        return 0;
+    }
+
+    const EBoardNetCellKind Kind = Block->Tags.Contains(FName("OfficerBlock")) ? EBoardNetCellKind::Officer
+        : Block->Tags.Contains(FName("BombBlock")) ? EBoardNetCellKind::Bomb
+        : Block->Tags.Contains(FName("SuperBlock")) ? EBoardNetCellKind::SuperBlock
+        : EBoardNetCellKind::Block;
+
+    uint16 Flags = 0;
+    Flags |= Block->Tags.Contains(FName("CanClearThreeRows")) ? BoardNetCell::CanClearThreeRows : 0;
+    Flags |= Block->Tags.Contains(FName("CannotBlowUpYet")) ? BoardNetCell::CannotBlowUpYet : 0;
+    Flags |= Block->Tags.Contains(FName("ToGlow")) || Block->Tags.Contains(FName("GlowBlock")) ? BoardNetCell::Glow : 0;
+
+    return BoardNetCell::Make(Kind, GetTokenId(Block), Flags);
+}
+
+UClass* ATetrisGrid::GetNetCellClass(uint16 Code) const
+{
+    const int32 TokenIndex = BoardNetCell::GetToken(Code);
+    switch (BoardNetCell::GetKind(Code))
+    {
+    case EBoardNetCellKind::Block:
+        return TetrominoBlueprints.IsValidIndex(TokenIndex) ? TetrominoBlueprints[TokenIndex].Get() : nullptr;
+    case EBoardNetCellKind::SuperBlock:
+        return SuperBlocks.IsValidIndex(TokenIndex) ? SuperBlocks[TokenIndex].Get() : nullptr;
+    case EBoardNetCellKind::Officer:
+        return SecClass;
+    case EBoardNetCellKind::Bomb:
+        return BombBlockClass;
+    default:
+        return nullptr;
+    }
+}
+
+void ATetrisGrid::PublishNetBoard()
+{
+    // Any change to a cell goes through SetGrid, so an unchanged generation means nothing to send
+    if (BoardGeneration == NetPublishedGeneration && NetKeyframe.Sequence != 0)
+    {
+        return;
+    }
+    NetPublishedGeneration = BoardGeneration;
+
+    TArray<uint16> Cells;
+    Cells.SetNumUninitialized(GridWidth * GridHeight);
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            Cells[x * GridHeight + y] = GetNetCellCode(x, y);
+        }
+    }
+
+    if (NetKeyframeCells.Num() != Cells.Num())
+    {
+        NetKeyframeCells.Init(0, Cells.Num());
+    }
+
+    ++NetSequence;
+    TArray<uint8> Bits;
+    FBoardNetCodec::Encode(NetKeyframeCells, Cells, Bits);
+
+    if (NetKeyframe.Sequence == 0 || Bits.Num() * 2 > FMath::Max(NetKeyframe.Bits.Num(), 32))
+    {
+        TArray<uint16> EmptyCells;
+        EmptyCells.SetNumZeroed(Cells.Num());
+
+        NetKeyframe.Sequence = NetSequence;
+        NetKeyframe.BaseSequence = 0;
+        NetKeyframe.Hash = BoardHash.GetCellsHash();
+        FBoardNetCodec::Encode(EmptyCells, Cells, NetKeyframe.Bits);
+        NetKeyframeCells = MoveTemp(Cells);
+
+        NetDelta.Sequence = NetSequence;
+        NetDelta.BaseSequence = NetSequence;
+        NetDelta.Bits.Reset();
+    }
+    else
+    {
+        NetDelta.Sequence = NetSequence;
+        NetDelta.BaseSequence = NetKeyframe.Sequence;
+        NetDelta.Bits = MoveTemp(Bits);
+    }
+    NetKeyframeSequence = NetKeyframe.Sequence;
+    NetDelta.Hash = BoardHash.GetCellsHash();
+
+    NetBytesSent += NetDelta.Bits.Num();
+    NetUpdatesSent++;
+}
+
+void ATetrisGrid::MakeNetPiece(FBoardNetPiece& OutPiece) const
+{
+    if (CurrentTetrominoBlocks.Num() > 0 && IsValid(CurrentTetrominoBlocks[0]))
+    {
+        const FIntPoint Pivot = WorldToGrid(CurrentTetrominoBlocks[0]->GetActorLocation());
+        OutPiece.Shape = InOfficerBlocksRound ? FBoardNetPiece::OfficerShape
+            : TetrominoShapes.IsValidIndex(CurrentPieceShape) ? (uint8)CurrentPieceShape : FBoardNetPiece::NoPiece;
+        OutPiece.Rotation = (uint8)CurrentPieceRotation;
+        OutPiece.X = (int8)Pivot.X;
+        OutPiece.Y = (int8)Pivot.Y;
+
+        if (!InOfficerBlocksRound)
+        {
+            for (const AActor* Block : CurrentTetrominoBlocks)
+            {
+                OutPiece.Tokens.Add((uint8)FMath::Max(GetTokenId(Block), 0));
+            }
+        }
+    }
+}
+
+void ATetrisGrid::PublishNetPiece()
+{
+    FBoardNetPiece Piece;
+    MakeNetPiece(Piece);
+
+    if (!(Piece == NetPiece))
+    {
+        NetPiece = MoveTemp(Piece);
+    }
+}
+
+void ATetrisGrid::OnRep_NetKeyframe()
+{
+    ApplyNetBoard();
+}
+
+void ATetrisGrid::OnRep_NetDelta()
+{
+    ApplyNetBoard();
+}
+
+void ATetrisGrid::OnRep_NetPiece()
+{
+    ApplyNetPiece();
+}
+
+void ATetrisGrid::OnRep_Score()
+{
+    MarkScoreChanged();
+}
+
+void ATetrisGrid::OnRep_Combos()
+{
+    MarkNotchesChanged();
+}
+
+void ATetrisGrid::ApplyNetBoard()
+{
+    // Until the token classes are in there is nothing to draw with; OnTokenAssetsLoaded calls back
+    if (HasAuthority() || NetKeyframe.Sequence == 0 || TetrominoBlueprints.Num() == 0)
+    {
+        return;
+    }
+
+    const int32 NumCells = GridWidth * GridHeight;
+    if (NetKeyframeSequence != NetKeyframe.Sequence)
+    {
+        TArray<uint16> EmptyCells;
+        EmptyCells.SetNumZeroed(NumCells);
+        if (!FBoardNetCodec::Decode(EmptyCells, NetKeyframe.Bits, NetKeyframeCells))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: bad board keyframe %u"), *GetName(), NetKeyframe.Sequence);
+            return;
+        }
+        NetKeyframeSequence = NetKeyframe.Sequence;
+    }
+
+    // The delta may be for a keyframe still on its way (wait for it) or one already replaced (the keyframe is newer)
+    TArray<uint16> Cells;
+    uint64 ExpectedHash = NetDelta.Hash;
+    if (NetDelta.BaseSequence == NetKeyframeSequence)
+    {
+        if (!FBoardNetCodec::Decode(NetKeyframeCells, NetDelta.Bits, Cells))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: bad board delta %u"), *GetName(), NetDelta.Sequence);
+            return;
+        }
+    }
+    else if (NetDelta.Sequence < NetKeyframeSequence)
+    {
+        Cells = NetKeyframeCells;
+        ExpectedHash = NetKeyframe.Hash;
+    }
+    else
+    {
+        return;
+    }
+
+    if (NetShownCells.Num() != NumCells)
+    {
+        NetShownCells.Init(0, NumCells);
+    }
+
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            const int32 Index = x * GridHeight + y;
+            const uint16 Code = Cells[Index];
+            if (Code == NetShownCells[Index])
+            {
+                continue;
+            }
+            NetShownCells[Index] = Code;
+
+            if (AActor* OldBlock = Grid[x][y])
+            {
+                SetGrid(x, y, nullptr);
+                BlockPool->Release(OldBlock);
+            }
+
+            UClass* BlockClass = GetNetCellClass(Code);
+            AActor* Block = BlockClass ? BlockPool->Acquire(BlockClass, GridToWorld(x, y), GetActorRotation()) : nullptr;
+            if (!Block)
+            {
+                continue;
+            }
+
+            switch (BoardNetCell::GetKind(Code))
+            {
+            case EBoardNetCellKind::Officer:
+                Block->Tags.Add(FName("OfficerBlock"));
+                break;
+            case EBoardNetCellKind::Bomb:
+                Block->Tags.Add(FName("BombBlock"));
+                break;
+            case EBoardNetCellKind::SuperBlock:
+                Block->Tags.Add(FName("SuperBlock"));
+                Block->Tags.Add(FName("TetrisBlock"));
+                break;
+            default:
+                Block->Tags.Add(FName("TetrisBlock"));
+                break;
+            }
+            if (Code & BoardNetCell::CanClearThreeRows)
+            {
+                Block->Tags.Add(FName("CanClearThreeRows"));
+            }
+            if (Code & BoardNetCell::CannotBlowUpYet)
+            {
+                Block->Tags.Add(FName("CannotBlowUpYet"));
+            }
+            SetGrid(x, y, Block);
+        }
+    }
+
+    if (BoardHash.GetCellsHash() != ExpectedHash)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: board desync at update %u, hash %016llx, server has %016llx"),
+            *GetName(), NetDelta.Sequence, BoardHash.GetCellsHash(), ExpectedHash);
+    }
+}
+
+void ATetrisGrid::ApplyNetPiece()
+{
+    if (HasAuthority() || TetrominoBlueprints.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FVector2D> Offsets;
+    if (NetPiece.Shape == FBoardNetPiece::OfficerShape)
+    {
+        Offsets = MakeOfficerPiece().BlockOffsets;
+    }
+    else if (TetrominoShapes.IsValidIndex(NetPiece.Shape))
+    {
+        Offsets = TetrominoShapes[NetPiece.Shape].BlockOffsets;
+    }
+
+    // Same shape and tokens: the blocks just move
+    if (NetPieceBlocks.Num() != Offsets.Num() || NetShownPiece.Shape != NetPiece.Shape || NetShownPiece.Tokens != NetPiece.Tokens)
+    {
+        for (AActor* Block : NetPieceBlocks)
+        {
+            BlockPool->Release(Block);
+        }
+        NetPieceBlocks.Reset();
+
+        for (int32 i = 0; i < Offsets.Num(); i++)
+        {
+            const int32 TokenIndex = NetPiece.Tokens.IsValidIndex(i) ? NetPiece.Tokens[i] : INDEX_NONE;
+            UClass* BlockClass = NetPiece.Shape == FBoardNetPiece::OfficerShape ? SecClass
+                : TetrominoBlueprints.IsValidIndex(TokenIndex) ? TetrominoBlueprints[TokenIndex].Get() : nullptr;
+            if (AActor* Block = BlockClass ? BlockPool->Acquire(BlockClass, GetActorLocation(), GetActorRotation()) : nullptr)
+            {
+                NetPieceBlocks.Add(Block);
+            }
+        }
+    }
+
+    // Turned about block 0 the way RotateTetromino turns it
+    for (int32 i = 0; i < NetPieceBlocks.Num() && i < Offsets.Num(); i++)
+    {
+        FIntPoint Relative(FMath::RoundToInt(Offsets[i].X - Offsets[0].X), FMath::RoundToInt(Offsets[i].Y - Offsets[0].Y));
+        for (int32 Turn = 0; Turn < NetPiece.Rotation % 4; Turn++)
+        {
+            Relative = FIntPoint(-Relative.Y, Relative.X);
+        }
+        NetPieceBlocks[i]->SetActorLocation(GridToWorld(NetPiece.X + Relative.X, NetPiece.Y + Relative.Y));
+    }
+
+    NetShownPiece = NetPiece;
+}
+
+void ATetrisGrid::ReceiveGarbageRows(int32 Rows)
+{
+    PendingGarbageRows += FMath::Max(Rows, 0);
+}
+
+bool ATetrisGrid::ApplyPendingGarbage()
+{
+    const int32 Rows = FMath::Min(PendingGarbageRows, GridHeight);
+    PendingGarbageRows = 0;
+    if (Rows <= 0)
+    {
+        return true;
+    }
+
+    // Blocks pushed out of the top end the game, like a lock there
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = GridHeight - Rows; y < GridHeight; ++y)
+        {
+            if (Grid[x][y] != nullptr)
+            {
+                GameOver();
+                return false;
+            }
+        }
+    }
+
+    // A bomb sits in four cells but moves once, by the same offset as everything else, so it keeps its anchor
+    TArray<AActor*> Moved;
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = GridHeight - 1 - Rows; y >= 0; --y)
+        {
+            if (AActor* Block = Grid[x][y])
+            {
+                SetGrid(x, y + Rows, Block);
+                SetGrid(x, y, nullptr);
+                Moved.AddUnique(Block);
+            }
+        }
+    }
+    const FVector RaiseOffset = GridToWorld(0, Rows) - GridToWorld(0, 0);
+    for (AActor* Block : Moved)
+    {
+        Block->SetActorLocation(Block->GetActorLocation() + RaiseOffset);
+    }
+
+    // Garbage is ordinary blocks with one gap per batch, so it can still pair and clear
+    const int32 GapX = GarbageRandom.RandRange(0, GridWidth - 1);
+    for (int32 y = 0; y < Rows; ++y)
+    {
+        for (int32 x = 0; x < GridWidth; ++x)
+        {
+            const int32 TokenIndex = GarbageRandom.RandRange(0, TetrominoBlueprints.Num() - 1);
+            if (x == GapX || !TetrominoBlueprints.IsValidIndex(TokenIndex))
+            {
+                continue;
+            }
+
+            if (AActor* Block = BlockPool->Acquire(TetrominoBlueprints[TokenIndex], GridToWorld(x, y), GetActorRotation()))
+            {
+                Block->Tags.Add(FName("TetrisBlock"));
+                SetGrid(x, y, Block);
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("%s: %d garbage rows"), *GetName(), Rows);
+    return true;
+}
+
+void ATetrisGrid::ToggleBoardPerfHUD()
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_UI);
+
+    if (PerfHUDWidget)
+    {
+        PerfHUDWidget->RemoveFromParent();
+        PerfHUDWidget = nullptr;
+        return;
+    }
+
+    TSubclassOf<UBoardPerfHUDWidget> WidgetClass = PerfHUDClass ? PerfHUDClass : TSubclassOf<UBoardPerfHUDWidget>(UBoardPerfHUDWidget::StaticClass());
+    PerfHUDWidget = CreateWidget<UBoardPerfHUDWidget>(GetWorld(), WidgetClass);
+    if (PerfHUDWidget)
+    {
+        PerfHUDWidget->SetGrid(this);
+        PerfHUDWidget->AddToViewport(100);
+        RefreshPerfSnapshot();
+    }
+}
+
+void ATetrisGrid::PruneNiagaraComponents()
+{
+    ActiveNiagaraComponents.RemoveAllSwap([](const TWeakObjectPtr<UNiagaraComponent>& Component)
+    {
+        return !Component.IsValid() || !Component->IsActive();
+    });
+}
+
+void ATetrisGrid::TrackNiagaraComponent(UNiagaraComponent* Component)
+{
+    // Finished effects go on every add, so the list stays as long as what is playing with the perf HUD closed too
+    PruneNiagaraComponents();
+    if (Component)
+    {
+        ActiveNiagaraComponents.Add(Component);
+    }
+}
+
+void ATetrisGrid::StartBoardSoak(int32 Pieces, int32 Seed)
+{
+    // Logged so a failing run can be played again with -BoardSoakSeed=<seed>
+    Seed = Seed != 0 ? Seed : (int32)FPlatformTime::Cycles();
+    SoakRandom.Initialize(Seed);
+    UE_LOG(LogTemp, Display, TEXT("%s: board soak seed %d"), *GetName(), Seed);
+
+    SoakMonitor.Start(Pieces);
+    SetSimulationSpeed(SoakTimeDilation);
+    QueueBoardInput(EBoardCommand::SoftDropStart, true, FPlatformTime::Seconds());
+}
+
+void ATetrisGrid::TickSoakInput()
+{
+    // A random nudge or turn now and then is enough to reach clears, combos and super blocks. They go through the
+    // input queue like a player's and are applied right after, in the same step.
+    const double Now = FPlatformTime::Seconds();
+    switch (SoakRandom.RandRange(0, 7))
+    {
+    case 0:
+        QueueBoardInput(EBoardCommand::MoveLeft, true, Now);
+        QueueBoardInput(EBoardCommand::MoveLeft, false, Now);
+        break;
+    case 1:
+        QueueBoardInput(EBoardCommand::MoveRight, true, Now);
+        QueueBoardInput(EBoardCommand::MoveRight, false, Now);
+        break;
+    case 2:
+        QueueBoardInput(EBoardCommand::Rotate, true, Now);
+        break;
+    default:
+        break;
+    }
+}
+
+void ATetrisGrid::FinishBoardSoak()
+{
+    SetSimulationSpeed(1.0f);
+    QueueBoardInput(EBoardCommand::SoftDropStop, true, FPlatformTime::Seconds());
+    SoakMonitor.RequestFinish();
+}
+
+void ATetrisGrid::ReportBoardSoak(bool bPassed)
+{
+    if (bCheckSimulationParity)
+    {
+        UE_LOG(LogTemp, Display, TEXT("Simulation parity: %d locks matched, %d differed, %d skipped while unsettled"), ParityMatched, ParityMismatched, ParitySkipped);
+        bPassed &= ParityMismatched == 0;
+    }
+
+    PrintScreen(bPassed ? TEXT("Board soak passed") : TEXT("Board soak FAILED, see log"), 30.0f);
+
+    if (bSoakExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+    }
+}
+
+void ATetrisGrid::StartBombCheck()
+{
+    if (!BombBlockClass || Grid[0][0] || Grid[1][0] || Grid[0][1] || Grid[1][1])
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s: bomb check needs a bomb block class and an empty bottom-left corner"), *GetName());
+        FinishBombCheck(false);
+        return;
+    }
+
+    // Placed the way MakeSuperDuperBlock places one; it goes off in the combo pass after the piece locks
+    AActor* Bomb = BlockPool->Acquire(BombBlockClass, GridToWorld(0, 0), GetActorRotation());
+    if (!Bomb)
+    {
+        FinishBombCheck(false);
+        return;
+    }
+    Bomb->Tags.Add(FName("BombBlock"));
+    Bomb->Tags.Add(FName("SuperDuperBlock"));
+    SetGrid(0, 0, Bomb);
+    SetGrid(1, 0, Bomb);
+    SetGrid(0, 1, Bomb);
+    SetGrid(1, 1, Bomb);
+
+    bBombCheckPending = true;
+    BombCheckDeadline = SimClock.GetTime() + 60.0;
+    SetSimulationSpeed(SoakTimeDilation);
+    QueueBoardInput(EBoardCommand::SoftDropStart, true, FPlatformTime::Seconds());
+}
+
+void ATetrisGrid::FinishBombCheck(bool bPassed)
+{
+    bBombCheckPending = false;
+    SetSimulationSpeed(1.0f);
+    QueueBoardInput(EBoardCommand::SoftDropStop, true, FPlatformTime::Seconds());
+
+    PrintScreen(bPassed ? TEXT("Bomb check passed") : TEXT("Bomb check FAILED, see log"), 30.0f);
+
+    if (bSoakExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+    }
+}
+
+void ATetrisGrid::RefreshPerfSnapshot()
+{
+    PerfSnapshotAge = 0.0f;
+    PerfCounters.FillSnapshot(PerfSnapshot);
+
+    int32 LiveBlocks = CurrentTetrominoBlocks.Num();
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            LiveBlocks += Grid[x][y] != nullptr ? 1 : 0;
+        }
+    }
+    PerfSnapshot.LiveBlockActors = LiveBlocks;
+    PerfSnapshot.SpawnedBlocks = BlockPool->GetNumSpawned();
+    PerfSnapshot.PooledBlocks = BlockPool->GetNumFree();
+
+    PruneNiagaraComponents();
+    PerfSnapshot.ActiveNiagaraComponents = ActiveNiagaraComponents.Num();
+
+    // Every gameplay timer runs on the simulation clock; only the row clear sweep is on world time
+    PerfSnapshot.RewindFrames = Rewind.Num();
+    PerfSnapshot.RewindBytes = (int32)Rewind.GetAllocatedSize();
+    PerfSnapshot.NetBytesPerUpdate = NetUpdatesSent > 0 ? (float)((double)NetBytesSent / NetUpdatesSent) : 0.0f;
+    PerfSnapshot.NetKeyframeBytes = NetKeyframe.Bits.Num();
+    const FBoardArenaStats ArenaStats = FBoardFrameArena::GetStats();
+    PerfSnapshot.ArenaAllocations = (int32)(ArenaStats.Allocations - PerfArenaStats.Allocations);
+    PerfSnapshot.ArenaBytes = ArenaStats.Bytes - PerfArenaStats.Bytes;
+    PerfSnapshot.ArenaHeapAllocations = (int32)(ArenaStats.HeapAllocations - PerfArenaStats.HeapAllocations);
+    PerfArenaStats = ArenaStats;
+    PerfSnapshot.ActiveTimers = SimTimers.GetNumActive() + (GetWorldTimerManager().IsTimerActive(LerpTimerHandle) ? 1 : 0);
+}
+
+void ATetrisGrid::FlushPresentation()
+{
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Effects);
+
+    if (Presentation.IsEmpty())
+    {
+        return;
+    }
+
+    Presentation.MaxVfxPerFrame = MaxVfxPerFrame;
+    Presentation.Resolve();
+
+    if (Presentation.CameraShakeScale > 0.0f)
+    {
+        APlayerController* PlayerController = Cast<APlayerController>(GetController());
+        if (PlayerController && CameraShakeClass.IsValid())
+        {
+            PlayerController->ClientStartCameraShake(CameraShakeClass.Get(), Presentation.CameraShakeScale);
+        }
+    }
+
+    for (const FPresentationVfxCommand& Command : Presentation.Vfx)
+    {
+        SpawnNiagaraSystem(Command.SystemPath, Command.Location, Command.Color1, Command.Color2);
+    }
+
+    for (USoundBase* Sound : Presentation.Sounds)
+    {
+        AudioService->PlayCue(Sound);
+    }
+
+    for (const FPresentationWidgetCommand& Command : Presentation.Widgets)
+    {
+        LLM_SCOPE_BYTAG(BlockchainBreakout_UI);
+
+        // A slot holds one popup; the one it replaces leaves the viewport so it can be collected
+        if (Command.OutWidget && *Command.OutWidget)
+        {
+            (*Command.OutWidget)->RemoveFromParent();
+            *Command.OutWidget = nullptr;
+        }
+
+        UUserWidget* Widget = CreateWidget<UUserWidget>(GetWorld(), Command.WidgetClass);
+        if (Widget)
+        {
+            Widget->AddToViewport();
+        }
+        if (Command.OutWidget)
+        {
+            *Command.OutWidget = Widget;
+        }
+    }
+
+    Presentation.Reset();
+}
+
+void ATetrisGrid::MarkTokenChanged(int32 TokenIndex)
+{
+    PendingUIDelta.ChangedTokens.AddUnique(TokenIndex);
+}
+
+void ATetrisGrid::MarkScoreChanged()
+{
+    PendingUIDelta.bScoreChanged = true;
+}
+
+void ATetrisGrid::MarkNotchesChanged()
+{
+    PendingUIDelta.bNotchesChanged = true;
+}
+
+void ATetrisGrid::FlushUIDelta()
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_UI);
+
+    if (PendingUIDelta.IsEmpty())
+    {
+        return;
+    }
+
+    PendingUIDelta.Score = Score;
+    PendingUIDelta.Combos = Combos;
+
+    OnBoardUIDeltaNative.Broadcast(PendingUIDelta);
+    OnBoardUIDelta.Broadcast(PendingUIDelta);
+
+    // Whole-UI events for widgets that haven't moved to the delta yet
+    if (PendingUIDelta.ChangedTokens.Num() > 0)
+    {
+        OnUpdateUI.Broadcast();
+    }
+    if (PendingUIDelta.bScoreChanged)
+    {
+        OnUpdateScore.Broadcast();
+    }
+    if (PendingUIDelta.bNotchesChanged)
+    {
+        OnUpdateNotches.Broadcast();
+    }
+
+    PendingUIDelta.Reset();
+}
+
+FUpcomingPiece ATetrisGrid::MakeRandomPiece() const
+{
+    FUpcomingPiece Piece;
+    Piece.ShapeIndex = BoardRandom.RandRange(0, TetrominoShapes.Num() - 1);
+    Piece.BlockOffsets = TetrominoShapes[Piece.ShapeIndex].BlockOffsets;
+
+    for (int32 i = 0; i < Piece.BlockOffsets.Num(); ++i)
+    {
+        Piece.TokenIndices.Add(BoardRandom.RandRange(0, TetrominoBlueprints.Num() - 1));
+    }
+
+    return Piece;
+}
+
+FUpcomingPiece ATetrisGrid::MakeOfficerPiece() const
+{
+    FUpcomingPiece Piece;
+    Piece.bOfficer = true;
+
+    for (int32 x = -8; x < GridWidth - 8; ++x)
+    {
+        Piece.BlockOffsets.Add(FVector2D(x, 0));
+        Piece.TokenIndices.Add(INDEX_NONE);
+    }
+
+    return Piece;
+}
+
+FUpcomingPiece ATetrisGrid::PopUpcomingPiece()
+{
+    RefillUpcomingPieces();
+    FUpcomingPiece Piece = UpcomingPieces[0];
+    UpcomingPieces.RemoveAt(0);
+    bPreviewUpToDate = false;
+
+    // The officer row is announced one piece ahead, as it always has been
+    if (RoundsLeftBeforeSecSpawn == 1)
+    {
+        UpcomingPieces.Insert(MakeOfficerPiece(), 0);
+        UpcomingPieces.SetNum(FMath::Min(UpcomingPieces.Num(), FMath::Max(PreviewQueueLength, 1)));
+    }
+
+    RefillUpcomingPieces();
+    return Piece;
+}
+
+void ATetrisGrid::RefillUpcomingPieces()
+{
+    bool bChanged = false;
+    while (UpcomingPieces.Num() < FMath::Max(PreviewQueueLength, 1))
+    {
+        UpcomingPieces.Add(MakeRandomPiece());
+        bChanged = true;
+    }
+
+    if (bChanged || !bPreviewUpToDate)
+    {
+        UpdatePiecePreview();
+    }
+}
+
+void ATetrisGrid::UpdatePiecePreview()
+{
+    bPreviewUpToDate = true;
+
+    if (!NextPiecePreviewWidget || !PiecePreviewCache)
+    {
+        return;
+    }
+
+    TArray<UTexture2D*> TokenIcons;
+    for (const FTetrisBlockValue& PointValue : PointValues)
+    {
+        TokenIcons.Add(PointValue.StockTickerTexture);
+    }
+
+    TArray<UTextureRenderTarget2D*> Thumbnails;
+    for (const FUpcomingPiece& Piece : UpcomingPieces)
+    {
+        Thumbnails.Add(PiecePreviewCache->GetThumbnail(Piece, 0, TokenIcons, OfficerPreviewIcon));
+    }
+    NextPiecePreviewWidget->SetThumbnails(Thumbnails);
+}
+
+void ATetrisGrid::SpawnTetromino()
+{
+    if (!bIsClearing)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            RecordRewindFrame();
+            const FUpcomingPiece Piece = PopUpcomingPiece();
+            CurrentPieceShape = Piece.ShapeIndex;
+            CurrentPieceRotation = 0;
+
+            for (int32 i = 0; i < Piece.BlockOffsets.Num(); ++i)
+            {
+                FVector2D Offset = Piece.BlockOffsets[i];
+                const int32 TokenIndex = Piece.TokenIndices[i];
+                TSubclassOf<AActor> TetrominoBlueprint = TetrominoBlueprints.IsValidIndex(TokenIndex) ? TetrominoBlueprints[TokenIndex] : TSubclassOf<AActor>(SecClass);
+                FVector BlockLocation = BoardToWorld(SpawnLocation + FVector(Offset.X * CellSize, 0.0f, Offset.Y * CellSize));
+                AActor* NextBlock = BlockPool->Acquire(TetrominoBlueprint, BlockLocation, GetActorRotation());
+
+                if (NextBlock)
+                {
+                    NextBlock->Tags.Add(FName("TetrisBlock"));
+                    CurrentTetrominoBlocks.Add(NextBlock);
+                }
+            }
+
+            const FIntPoint SpawnCell = WorldToGrid(BoardToWorld(SpawnLocation));
+            RecordEvent(EGameplayEventType::Spawn, SpawnCell.X, SpawnCell.Y, CurrentTetrominoBlocks.Num());
+
+            if (SoakMonitor.IsRunning() && SoakMonitor.OnPieceSpawned())
+            {
+                FinishBoardSoak();
+            }
+        }
+    }
+}
+
+bool ATetrisGrid::MoveTetromino(const FVector2D& Direction)
+{
+    if (CurrentTetrominoBlocks.Num() == 0)
+    {
+        return false;
+    }
+
+    try {
+        bool bCanMove = true;
+
+        const FIntPoint Step(FMath::RoundToInt(Direction.X), FMath::RoundToInt(Direction.Y));
+
+        for (AActor* Block : CurrentTetrominoBlocks)
+        {
+            FIntPoint NewGridPosition = WorldToGrid(Block->GetActorLocation()) + Step;
+
+            if (NewGridPosition.X < 0 || NewGridPosition.X >= GridWidth || NewGridPosition.Y < 0 || IsGridOccupied(NewGridPosition.X, NewGridPosition.Y) != nullptr)
+            {
+                bCanMove = false;
+                break;
+            }
+        }
+
+        if (bCanMove)
+        {
+            AudioService->PlayCue(ShuffleCue2);
+
+            for (AActor* Block : CurrentTetrominoBlocks)
+            {
+                FIntPoint NewGridPosition = WorldToGrid(Block->GetActorLocation()) + Step;
+                Block->SetActorLocation(GridToWorld(NewGridPosition.X, NewGridPosition.Y));
+            }
+
+            RecordEvent(EGameplayEventType::Move, Step.X, Step.Y);
+        }
+
+        return bCanMove;
+    }
+    catch (const std::exception& e) {
+        UE_LOG(LogTemp, Error, TEXT("An exception was thrown.  e: %s"), ANSI_TO_TCHAR(e.what()));
+    }
+
+    return false;
+}
+
+bool ATetrisGrid::MoveTetrominoLeft()
+{
+    return MoveTetromino(FVector2D(-1, 0));
+}
+
+bool ATetrisGrid::MoveTetrominoRight()
+{
+    return MoveTetromino(FVector2D(1, 0));
+}
+
+void ATetrisGrid::MoveTetrominoDown()
+{
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Fall);
+
+    bool bCanMove = true;
+
+    // Check if movement is possible
+    for (AActor* Block : CurrentTetrominoBlocks)
+    {
+        FIntPoint NewGridPosition = WorldToGrid(Block->GetActorLocation()) + FIntPoint(0, -1);
+
+        if (NewGridPosition.Y < 0 || IsGridOccupied(NewGridPosition.X, NewGridPosition.Y) != nullptr)
+        {
+            bCanMove = false;
+            break;
+        }
+    }
+
+    // Move Tetromino if possible
+    if (bCanMove)
+    {
+        for (AActor* Block : CurrentTetrominoBlocks)
+        {
+            FIntPoint GridPosition = WorldToGrid(Block->GetActorLocation());
+            Block->SetActorLocation(GridToWorld(GridPosition.X, GridPosition.Y - 1));
+        }
+    }
+    else
+    {
+        FScopedBoardStage LockScope(PerfCounters, EBoardStage::Lock);
+
+        if (bCheckSimulationParity)
+        {
+            CheckSimulationParity();
+            PredictLockInSimulation();
+        }
+
+        // Set the Tetromino blocks as occupied in the grid
+        for (AActor* Block : CurrentTetrominoBlocks)
+        {
+            FIntPoint GridPosition = WorldToGrid(Block->GetActorLocation());
+            int32 GridX = GridPosition.X;
+            int32 GridY = GridPosition.Y;
+
+            // Trigger game over if a block is placed at the top of the grid
+            if (GridY >= GridHeight - 1)
+            {
+                GameOver();
+                return;
+            }
+
+            SetGrid(GridX, GridY, Block);
+            RecordEvent(EGameplayEventType::Lock, GridX, GridY);
+        }
+
+        CurrentTetrominoBlocks.Empty();
+
+        for (int32 x = 0; x < GridWidth; ++x)
+        {
+            for (int32 y = 0; y < GridHeight; ++y)
+            {
+                if (Grid[x][y] && IsValid(Grid[x][y]))
+                {
+                    if (Grid[x][y]->Tags.Contains("CannotBlowUpYet"))
+                    {
+                        Grid[x][y]->Tags.Remove("CannotBlowUpYet");
+                        RehashCell(x, y);
+                    }
+                }
+            }
+        }
+
+        if (bCheckBoardHash)
+        {
+            VerifyBoardHash();
+        }
+        if (FGameplayEventLog::Get().IsRunning())
+        {
+            RecordEvent(EGameplayEventType::BoardHash, 0, 0, (int64)GetBoardHash());
+        }
+
+        CheckAndClearFullRows();
+
+        CheckForCombos();
+
+        RoundsLeftBeforeSecSpawn--;
+
+        if (RoundsLeftBeforeSecSpawn <= 0)
+        {
+            ShouldSpawnOfficerTetromino = true;
+            RoundsLeftBeforeSecSpawn = RoundsBeforeSecSpawn;
+        }
+
+        if (InOfficerBlocksRound)
+        {
+            ShouldSpawnOfficerTetromino = false;
+            InOfficerBlocksRound = false;
+        }
+
+        SimTimers.SetTimer(CheckIfReadyToSpawnTetromino, this, &ATetrisGrid::CheckIfReadyForNewTetromino, .2f, true);
+    }
+}
+
+void ATetrisGrid::CheckIfReadyForNewTetromino()
+{
+    if (!bAnyDropInProgress && !bIsCheckingForCombos)
+    {
+        SimTimers.ClearTimer(CheckIfReadyToSpawnTetromino);
+        DealNextPiece();
+    }
+}
+
+void ATetrisGrid::DealNextPiece()
+{
+    if (!ApplyPendingGarbage())
+    {
+        return;
+    }
+
+    if (ShouldSpawnOfficerTetromino)
+    {
+        SpawnOfficerTetromino();
+        InOfficerBlocksRound = true;
+    }
+    else
+    {
+        SpawnTetromino();
+    }
+
+    if (bBombCheckPending)
+    {
+        // Every cell of the bomb must be empty by now, not still pointing at the pooled actor
+        bool bBombLeftovers = false;
+        for (int32 x = 0; x < GridWidth; ++x)
+        {
+            for (int32 y = 0; y < GridHeight; ++y)
+            {
+                bBombLeftovers |= Grid[x][y] && Grid[x][y]->Tags.Contains(FName("BombBlock"));
+            }
+        }
+        if (bBombLeftovers)
+        {
+            UE_LOG(LogTemp, Error, TEXT("%s: piece dealt with bomb cells still in the grid"), *GetName());
+        }
+        FinishBombCheck(!bBombLeftovers);
+    }
+}
+
+void ATetrisGrid::SetGrid(int32 x, int32 y, AActor* actor = nullptr)
+{
+    if (x >= 0 && x < GridWidth && y >= 0 && y < GridHeight)
+    {
+        Grid[x][y] = actor;
+        BoardGeneration++;
+
+        // Super blocks, bombs and officer blocks never pair, so they stay out of the token planes
+        int32 Token = INDEX_NONE;
+        if (actor && actor->Tags.Contains(FName("TetrisBlock")) && !actor->Tags.Contains(FName("SuperBlock")))
+        {
+            Token = GetTokenId(actor);
+        }
+        TokenPlanes.SetCell(x, y, Token);
+        RehashCell(x, y);
+    }
+}
+
+void ATetrisGrid::RehashCell(int32 x, int32 y)
+{
+    const uint16 Code = GetNetCellCode(x, y);
+    bBlockInstancesStale = true;
+    BoardHash.SetCell(x, y, Code);
+    BoardStateQuad->SetCell(x, y, Grid[x][y], Code);
+}
+
+void ATetrisGrid::PredictLockInSimulation()
+{
+    // Garbage rows arrive between locks, which the simulation knows nothing of
+    if (VersusOpponent || !TokenRegistry || CurrentTetrominoBlocks.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<uint16> Cells;
+    Cells.SetNumUninitialized(GridWidth * GridHeight);
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            const uint16 Code = GetNetCellCode(x, y);
+            if (BoardNetCell::GetKind(Code) == EBoardNetCellKind::Bomb)
+            {
+                return;
+            }
+            Cells[x * GridHeight + y] = Code;
+        }
+    }
+
+    TArray<FIntPoint> PieceCells;
+    TArray<int32> PieceTokens;
+    bool bOfficer = false;
+    for (AActor* Block : CurrentTetrominoBlocks)
+    {
+        PieceCells.Add(WorldToGrid(Block->GetActorLocation()));
+        PieceTokens.Add(GetTokenId(Block));
+        bOfficer |= Block->Tags.Contains(FName("OfficerBlock"));
+    }
+
+    FillSimulationConfig(CurrentLevelIndex, *TokenRegistry, ParityConfig);
+    FBreakoutSimulation Simulation(ParityConfig, 0);
+    Simulation.SetCells(Cells);
+    Simulation.LockCells(PieceCells, PieceTokens, bOfficer);
+
+    ParityExpectedHash = Simulation.GetCellsHash();
+    bParityPending = true;
+}
+
+void ATetrisGrid::CheckSimulationParity()
+{
+    if (!bParityPending)
+    {
+        return;
+    }
+    bParityPending = false;
+
+    // A chain still playing out, or a super block still glowing, isn't the settled board yet
+    if (bAnyDropInProgress || bIsCheckingForCombos || SimTimers.IsTimerActive(GlowTimerHandle))
+    {
+        ParitySkipped++;
+        return;
+    }
+
+    if (BoardHash.GetCellsHash() == ParityExpectedHash)
+    {
+        ParityMatched++;
+        return;
+    }
+
+    ParityMismatched++;
+    UE_LOG(LogTemp, Error, TEXT("%s: board settled as %016llx but the simulation predicted %016llx for the lock before this one"),
+        *GetName(), BoardHash.GetCellsHash(), ParityExpectedHash);
+}
+
+void ATetrisGrid::StartSimulationParityCheck(int32 Pieces, int32 Seed)
+{
+    bCheckSimulationParity = true;
+    bParityPending = false;
+    ParityMatched = ParityMismatched = ParitySkipped = 0;
+    StartBoardSoak(Pieces, Seed);
+}
+
+bool ATetrisGrid::VerifyBoardHash()
+{
+    TArray<uint16> Cells;
+    Cells.SetNumUninitialized(GridWidth * GridHeight);
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            Cells[x * GridHeight + y] = GetNetCellCode(x, y);
+        }
+    }
+
+    const uint64 GridHash = BoardHash.HashCells(Cells);
+    if (GridHash == BoardHash.GetCellsHash())
+    {
+        return true;
+    }
+
+    UE_LOG(LogTemp, Error, TEXT("%s: board hash %016llx has drifted from the grid's %016llx"), *GetName(), BoardHash.GetCellsHash(), GridHash);
+    for (int32 x = 0; x < GridWidth; ++x)
+    {
+        for (int32 y = 0; y < GridHeight; ++y)
+        {
+            BoardHash.SetCell(x, y, Cells[x * GridHeight + y]);
+        }
+    }
+    return false;
+}
+
+uint64 ATetrisGrid::GetBoardHash() const
+{
+    FBoardNetPiece Piece;
+    MakeNetPiece(Piece);
+    return BoardHash.GetCellsHash() ^ BoardHash.GetPieceKey(Piece) ^ BoardHash.GetMarketKey(Market, (int32)CurrentMarketEvent);
+}
+
+AActor* ATetrisGrid::IsGridOccupied(int32 x, int32 y) const
+{
+    if (x >= 0 && x < GridWidth && y >= 0 && y < GridHeight)
+    {
+        return Grid[x][y];
+    }
+    return nullptr;
+}
+
+FVector ATetrisGrid::GridToWorld(int32 x, int32 y) const
+{
+    return BoardToWorld(FVector((x * CellSize) + BoardOffsetX, 0.0f, y * CellSize));
+}
+
+FIntPoint ATetrisGrid::WorldToGrid(const FVector& WorldLocation) const
+{
+    const FVector LocalLocation = GetActorTransform().InverseTransformPosition(WorldLocation);
+    return FIntPoint(FMath::RoundToInt((LocalLocation.X - BoardOffsetX) / CellSize), FMath::RoundToInt(LocalLocation.Z / CellSize));
+}
+
+FVector ATetrisGrid::BoardToWorld(const FVector& LocalLocation) const
+{
+    return GetActorTransform().TransformPosition(LocalLocation);
+}
+
+void ATetrisGrid::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+    Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+    UEnhancedInputComponent* EnhancedInput = Cast<UEnhancedInputComponent>(PlayerInputComponent);
+    if (!EnhancedInput)
+    {
+        UE_LOG(LogTemp, Error, TEXT("TetrisGrid needs EnhancedInputComponent as the default input component class"));
+        return;
     }
 
-    // Move Tetromino if possible
-    if (bCanMove)
+    CreateDefaultInputActions();
+
+    if (APlayerController* PlayerController = Cast<APlayerController>(GetController()))
     {
-        for (AActor* Block : CurrentTetrominoBlocks)
+        if (UEnhancedInputLocalPlayerSubsystem* InputSubsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
         {
-            FVector CurrentLocation = Block->GetActorLocation();
-            FVector NewLocation = CurrentLocation + FVector(0.0f, 0.0f, -100.0f);
-            Block->SetActorLocation(NewLocation);
+            InputSubsystem->AddMappingContext(BoardMappingContext, 0);
         }
     }
-    else
-    {
-        // Set the Tetromino blocks as occupied in the grid
-        for (AActor* Block : CurrentTetrominoBlocks)
-        {
-            FVector CurrentLocation = Block->GetActorLocation();
-            int32 GridX = FMath::RoundToInt((CurrentLocation.X + 1000.0f) / 100.0f);
-            int32 GridY = FMath::RoundToInt(CurrentLocation.Z / 100.0f);
 
-            // Trigger game over if a block is placed at the top of the grid
-            if (GridY >= GridHeight - 1)
-            {
-                GameOver();
-                return;
-            }
+    EnhancedInput->BindAction(MoveLeftAction, ETriggerEvent::Started, this, &ATetrisGrid::OnMoveLeftPressed);
+    EnhancedInput->BindAction(MoveLeftAction, ETriggerEvent::Completed, this, &ATetrisGrid::OnMoveLeftReleased);
+    EnhancedInput->BindAction(MoveRightAction, ETriggerEvent::Started, this, &ATetrisGrid::OnMoveRightPressed);
+    EnhancedInput->BindAction(MoveRightAction, ETriggerEvent::Completed, this, &ATetrisGrid::OnMoveRightReleased);
+    EnhancedInput->BindAction(RotateAction, ETriggerEvent::Started, this, &ATetrisGrid::OnRotatePressed);
+    EnhancedInput->BindAction(SoftDropAction, ETriggerEvent::Started, this, &ATetrisGrid::OnSoftDropPressed);
+    EnhancedInput->BindAction(SoftDropAction, ETriggerEvent::Completed, this, &ATetrisGrid::OnSoftDropReleased);
+}
 
-            SetGrid(GridX, GridY, Block);
+void ATetrisGrid::CreateDefaultInputActions()
+{
+    auto MakeAction = [this](UInputAction*& Action, const TCHAR* Name)
+    {
+        if (!Action)
+        {
+            Action = NewObject<UInputAction>(this, Name);
+            Action->ValueType = EInputActionValueType::Boolean;
         }
+    };
+    MakeAction(MoveLeftAction, TEXT("IA_MoveLeft"));
+    MakeAction(MoveRightAction, TEXT("IA_MoveRight"));
+    MakeAction(RotateAction, TEXT("IA_Rotate"));
+    MakeAction(SoftDropAction, TEXT("IA_SoftDrop"));
 
-        CurrentTetrominoBlocks.Empty();
+    if (BoardMappingContext)
+    {
+        return;
+    }
 
-        for (int32 x = 0; x < GridWidth; ++x)
-        {
-            for (int32 y = 0; y < GridHeight; ++y)
-            {
-                if (Grid[x][y] && IsValid(Grid[x][y]))
-                {
-                    if (Grid[x][y]->Tags.Contains("CannotBlowUpYet"))
-                    {
-                        Grid[x][y]->Tags.Remove("CannotBlowUpYet");
-                    }
-                }
-            }
-        }
+    BoardMappingContext = NewObject<UInputMappingContext>(this, TEXT("IMC_Board"));
+    BoardMappingContext->MapKey(MoveLeftAction, EKeys::A);
+    BoardMappingContext->MapKey(MoveLeftAction, EKeys::Left);
+    BoardMappingContext->MapKey(MoveRightAction, EKeys::D);
+    BoardMappingContext->MapKey(MoveRightAction, EKeys::Right);
+    BoardMappingContext->MapKey(RotateAction, EKeys::W);
+    BoardMappingContext->MapKey(RotateAction, EKeys::Up);
+    BoardMappingContext->MapKey(SoftDropAction, EKeys::S);
+    BoardMappingContext->MapKey(SoftDropAction, EKeys::Down);
+}
 
-        CheckAndClearFullRows();
+void ATetrisGrid::OnMoveLeftPressed()
+{
+    ReceiveBoardInput(EBoardCommand::MoveLeft, true);
+}
 
-        CheckForCombos();
+void ATetrisGrid::OnMoveLeftReleased()
+{
+    ReceiveBoardInput(EBoardCommand::MoveLeft, false);
+}
 
-        RoundsLeftBeforeSecSpawn--;
+void ATetrisGrid::OnMoveRightPressed()
+{
+    ReceiveBoardInput(EBoardCommand::MoveRight, true);
+}
 
-        if (RoundsLeftBeforeSecSpawn <= 0)
-        {
-            ShouldSpawnOfficerTetromino = true;
-            RoundsLeftBeforeSecSpawn = RoundsBeforeSecSpawn;
-        }
+void ATetrisGrid::OnMoveRightReleased()
+{
+    ReceiveBoardInput(EBoardCommand::MoveRight, false);
+}
 
-        if (InOfficerBlocksRound)
-        {
-            ShouldSpawnOfficerTetromino = false;
-            InOfficerBlocksRound = false;
-        }
+void ATetrisGrid::OnRotatePressed()
+{
+    ReceiveBoardInput(EBoardCommand::Rotate, true);
+}
 
-        GetWorldTimerManager().SetTimer(CheckIfReadyToSpawnTetromino, this, &ATetrisGrid::CheckIfReadyForNewTetromino, .2f, true);
-    }
+void ATetrisGrid::OnSoftDropPressed()
+{
+    ReceiveBoardInput(EBoardCommand::SoftDropStart, true);
 }
 
-void ATetrisGrid::CheckIfReadyForNewTetromino()
+void ATetrisGrid::OnSoftDropReleased()
 {
-    if (!bAnyDropInProgress)
-    {
-        GetWorldTimerManager().ClearTimer(CheckIfReadyToSpawnTetromino);
-        if (ShouldSpawnOfficerTetromino)
-        {
-            SpawnOfficerTetromino();
-            InOfficerBlocksRound = true;
-        }
-        else
-        {
-            SpawnTetromino();
-        }
-    }
+    ReceiveBoardInput(EBoardCommand::SoftDropStop, true);
 }
 
-void ATetrisGrid::SetGrid(int32 x, int32 y, AActor* actor = nullptr)
+void ATetrisGrid::ReceiveBoardInput(EBoardCommand Command, bool bPressed)
 {
-    if (x >= 0 && x < GridWidth && y >= 0 && y < GridHeight)
+    // A client's board is a copy; the server plays the move and replicates the result
+    if (!HasAuthority())
     {
-        Grid[x][y] = actor;
+        ServerBoardInput((uint8)Command, bPressed);
+        return;
     }
+
+    QueueBoardInput(Command, bPressed, FPlatformTime::Seconds());
 }
 
-AActor* ATetrisGrid::IsGridOccupied(int32 x, int32 y) const
+void ATetrisGrid::ServerBoardInput_Implementation(uint8 Command, bool bPressed)
 {
-    if (x >= 0 && x < GridWidth && y >= 0 && y < GridHeight)
+    if (Command <= (uint8)EBoardCommand::SoftDropStop)
     {
-        return Grid[x][y];
+        // Stamped on arrival, so input latency on the server covers its own part of the trip only
+        QueueBoardInput((EBoardCommand)Command, bPressed, FPlatformTime::Seconds());
     }
-    return nullptr;
 }
 
-FVector ATetrisGrid::GridToWorld(int32 x, int32 y) const
+void ATetrisGrid::QueueBoardInput(EBoardCommand Command, bool bPressed, double Timestamp)
 {
-    return FVector(x * 100.0f, 0.0f, y * 100.0f);
+    switch (Command)
+    {
+    case EBoardCommand::MoveLeft:
+    case EBoardCommand::MoveRight:
+        if (bPressed)
+        {
+            InputQueue.PressDirection(Command, Timestamp);
+        }
+        else
+        {
+            InputQueue.ReleaseDirection(Command, Timestamp);
+        }
+        break;
+    default:
+        InputQueue.Push(Command, Timestamp);
+        break;
+    }
 }
 
-void ATetrisGrid::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+void ATetrisGrid::ProcessInputCommands(uint64 Step)
 {
-    Super::SetupPlayerInputComponent(PlayerInputComponent);
+    // The controller ticks before its pawn, so everything pressed this frame is already queued; the first step of
+    // a frame takes it all
+    InputQueue.Update(FPlatformTime::Seconds(), AutoShiftDelay, AutoRepeatRate, GridWidth);
+
+    DrainedInput.Reset();
+    InputQueue.Drain(DrainedInput, Step);
 
-    PlayerInputComponent->BindAction("MoveLeft", IE_Pressed, this, &ATetrisGrid::MoveTetrominoLeft);
-    PlayerInputComponent->BindAction("MoveRight", IE_Pressed, this, &ATetrisGrid::MoveTetrominoRight);
-    PlayerInputComponent->BindAction("MoveUp", IE_Pressed, this, &ATetrisGrid::RotateTetromino);
-    PlayerInputComponent->BindAction("MoveDown", IE_Pressed, this, &ATetrisGrid::StartFastDrop);
-    PlayerInputComponent->BindAction("MoveDown", IE_Released, this, &ATetrisGrid::StopFastDrop);
+    for (const FBoardInputCommand& Input : DrainedInput)
+    {
+        // A paused board takes no moves, but soft drop still follows the key so it isn't stuck on at resume
+        const bool bMovesPiece = Input.Command != EBoardCommand::SoftDropStart && Input.Command != EBoardCommand::SoftDropStop;
+        if (bMovesPiece && SimClock.IsPaused())
+        {
+            continue;
+        }
+
+        bool bBoardChanged = false;
+        switch (Input.Command)
+        {
+        case EBoardCommand::MoveLeft:
+            bBoardChanged = MoveTetrominoLeft();
+            break;
+        case EBoardCommand::MoveRight:
+            bBoardChanged = MoveTetrominoRight();
+            break;
+        case EBoardCommand::Rotate:
+            bBoardChanged = RotateTetromino();
+            break;
+        case EBoardCommand::SoftDropStart:
+            StartFastDrop();
+            break;
+        case EBoardCommand::SoftDropStop:
+            StopFastDrop();
+            break;
+        }
+
+        // Blocked moves change nothing, so they don't count; an instant shift stops counting at the wall
+        if (bBoardChanged)
+        {
+            PerfCounters.AddInputLatency(Input.Timestamp, FPlatformTime::Seconds());
+        }
+    }
 }
 
 void ATetrisGrid::CheckAndClearFullRows()
 {
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Clears);
+
+    int32 RowsCleared = 0;
     for (int32 y = 0; y < GridHeight; ++y)
     {
         bool bIsRowFull = true;
@@ -765,66 +2251,58 @@ void ATetrisGrid::CheckAndClearFullRows()
 
             for (int32 x = 0; x < GridWidth; x++)
             {
-                FVector BlockLocation = FVector((x * 100.0f) - 1000.0f, 0.0f, y * 100.0f);
-                TArray<AActor*> FoundActors;
-                UGameplayStatics::GetAllActorsOfClass(GetWorld(), AActor::StaticClass(), FoundActors);
+                AActor* Actor = Grid[x][y];
+                int32 TokenIndex = GetTokenId(Actor);
 
-                for (AActor* Actor : FoundActors)
+                if (TokenIndex != INDEX_NONE)
                 {
-                    if (Actor->GetActorLocation() == BlockLocation)
-                    {
-                        FTetrisBlockValue* FoundValue = FindPointValueByName(*Actor->GetName());
-
-                        if (FoundValue)
-                        {
-                            int32 IntValue = FCString::Atoi(*FoundValue->ScoreValue.Replace(TEXT("$"), TEXT("")).Replace(TEXT(","), TEXT("")).Replace(TEXT("."), TEXT("")));
-
-                            if (CurrentMarketEvent == EMarketEvent::BullRun)
-                            {
-                                IntValue = FMath::Clamp(IntValue * 2, 0, maxInt32 - 1);
-                            }
-                            else if (CurrentMarketEvent == EMarketEvent::CryptoCrash)
-                            {
-                                IntValue /= 2;
-                            }
-
-                            RowScore = FMath::Clamp(RowScore + IntValue, 0, maxInt32 - 1);
-                        }
-                        else
-                        {
-                            UE_LOG(LogTemp, Error, TEXT("Could not find point value for actor %s"), *Actor->GetName());
-                        }
-                    }
+                    RowScore = (int32)FMath::Min<int64>((int64)RowScore + GetBlockScoreValue(TokenIndex), maxInt32 - 1);
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Could not find point value for actor %s"), *Actor->GetName());
                 }
             }
 
+            RecordEvent(EGameplayEventType::Clear, 0, y, RowScore);
+
             ClearRow(y);
             MoveRowsDown(y);
             Combos = FMath::Clamp(Combos + 1, 0, 5);
-            OnUpdateNotches.Broadcast();
+            MarkNotchesChanged();
 
             y--;
+            RowsCleared++;
 
-            IncrementScore(Score + RowScore);
+            AddScore(EScoreSource::Row, RowScore);
         }
     }
+
+    // Versus: every row cleared at once after the first is a garbage row for the opponent
+    if (VersusOpponent && RowsCleared > 1)
+    {
+        VersusOpponent->ReceiveGarbageRows(RowsCleared - 1);
+    }
 }
 
 void ATetrisGrid::MoveBlocksDownIncrementally()
 {
     bool bAnyBlockMoved = false;
 
-    for (AActor* Block : BlocksToMove)
+    for (const TWeakObjectPtr<AActor>& BlockPtr : BlocksToMove)
     {
-        FVector CurrentLocation = Block->GetActorLocation();
-        FVector NewLocation = CurrentLocation - FVector(0.0f, 0.0f, 100.0f); // Move down by 10 units
+        AActor* Block = BlockPtr.Get();
+        if (!Block)
+        {
+            continue;
+        }
 
-        FVector2D GridCoords = FVector2D((CurrentLocation.X + 1000.0f) / 100.0f, CurrentLocation.Z / 100.0f);
+        FIntPoint GridCoords = WorldToGrid(Block->GetActorLocation());
         bool CanDo = CanMoveDown(GridCoords.X, GridCoords.Y);
 
         if (CanDo)
         {
-            Block->SetActorLocation(NewLocation);
+            Block->SetActorLocation(GridToWorld(GridCoords.X, GridCoords.Y - 1));
             bAnyBlockMoved = true;
         }
     }
@@ -832,14 +2310,14 @@ void ATetrisGrid::MoveBlocksDownIncrementally()
     if (bAnyBlockMoved)
     {
         // Continue moving blocks down
-        GetWorldTimerManager().SetTimer(MoveBlocksTimerHandle, this, &ATetrisGrid::MoveBlocksDownIncrementally, 0.5f, false);
+        SimTimers.SetTimer(MoveBlocksTimerHandle, this, &ATetrisGrid::MoveBlocksDownIncrementally, 0.5f, false);
     }
     else
     {
-        // Stop the timer and clear the list of blocks to move
-        GetWorldTimerManager().ClearTimer(MoveBlocksTimerHandle);
-        BlocksToMove.Empty();
-        RowsToMove.Empty();
+        // Stop the timer and clear the list of blocks to move; the capacity stays for the next pass
+        SimTimers.ClearTimer(MoveBlocksTimerHandle);
+        BlocksToMove.Reset();
+        RowsToMove.Reset();
     }
 }
 
@@ -860,14 +2338,34 @@ void ATetrisGrid::ClearRow(int32 y)
 {
     for (int32 x = 0; x < GridWidth; ++x)
     {
-        AActor* GridActor = Grid[x][y];
-        if (GridActor)
+        if (Grid[x][y])
         {
-            GridActor->Destroy();
+            ReleaseGridBlock(x, y);
         }
+    }
+}
+
+void ATetrisGrid::ReleaseGridBlock(int32 x, int32 y)
+{
+    AActor* Block = Grid[x][y];
+    SetGrid(x, y, nullptr);
 
-        SetGrid(x, y, nullptr);
+    // A bomb fills four cells; none of them may keep pointing at it once the pool can hand it out again
+    if (Block && Block->Tags.Contains(FName("BombBlock")))
+    {
+        for (int32 BombX = FMath::Max(x - 1, 0); BombX <= FMath::Min(x + 1, GridWidth - 1); ++BombX)
+        {
+            for (int32 BombY = FMath::Max(y - 1, 0); BombY <= FMath::Min(y + 1, GridHeight - 1); ++BombY)
+            {
+                if (Grid[BombX][BombY] == Block)
+                {
+                    SetGrid(BombX, BombY, nullptr);
+                }
+            }
+        }
     }
+
+    BlockPool->Release(Block);
 }
 
 void ATetrisGrid::MoveRowsDown(int32 ClearedRow)
@@ -882,16 +2380,7 @@ void ATetrisGrid::MoveRowsDown(int32 ClearedRow)
 
             if (Grid[x][y])
             {
-                FVector NewLocation = GridToWorld(x - 10, y);
-                FVector OldLocation = GridToWorld(x - 10, y + 1);
-                FHitResult HitResult;
-                if (GetWorld()->LineTraceSingleByChannel(HitResult, OldLocation, OldLocation + (FVector::UpVector * 5), ECC_Visibility))
-                {
-                    if (AActor* BlockActor = HitResult.GetActor())
-                    {
-                        BlockActor->SetActorLocation(NewLocation);
-                    }
-                }
+                Grid[x][y]->SetActorLocation(GridToWorld(x, y));
             }
             else
             {
@@ -914,22 +2403,20 @@ std::tuple<bool, TArray<FVector2D>> ATetrisGrid::CanRotateTetromino(AActor* Pivo
         return std::make_tuple(false, TArray<FVector2D>());
     }
 
-    FVector PivotWorldLocation = PivotBlock->GetActorLocation();
-
     // Convert pivot world coordinates to grid coordinates
-    int32 PivotGridX = FMath::RoundToInt((PivotWorldLocation.X + 1000.0f) / 100.0f);
-    int32 PivotGridY = FMath::RoundToInt(PivotWorldLocation.Z / 100.0f);
+    FIntPoint PivotGridPosition = WorldToGrid(PivotBlock->GetActorLocation());
+    int32 PivotGridX = PivotGridPosition.X;
+    int32 PivotGridY = PivotGridPosition.Y;
 
     bool bCanRotate = true;
     TArray<FVector2D> NewGridPositions;
 
     for (AActor* Block : CurrentTetrominoBlocks)
     {
-        FVector WorldLocation = Block->GetActorLocation();
-
         // Convert world coordinates to grid coordinates
-        int32 GridX = FMath::RoundToInt((WorldLocation.X + 1000.0f) / 100.0f);
-        int32 GridY = FMath::RoundToInt(WorldLocation.Z / 100.0f);
+        FIntPoint GridPosition = WorldToGrid(Block->GetActorLocation());
+        int32 GridX = GridPosition.X;
+        int32 GridY = GridPosition.Y;
 
         // Calculate relative position to the pivot in grid space
         FVector2D RelativePosition = FVector2D(GridX - PivotGridX, GridY - PivotGridY);
@@ -955,7 +2442,7 @@ std::tuple<bool, TArray<FVector2D>> ATetrisGrid::CanRotateTetromino(AActor* Pivo
     return std::make_tuple(bCanRotate, NewGridPositions);
 }
 
-void ATetrisGrid::RotateTetromino()
+bool ATetrisGrid::RotateTetromino()
 {
     if (CurrentTetrominoBlocks.Num() > 0)
     {
@@ -979,44 +2466,64 @@ void ATetrisGrid::RotateTetromino()
         // Apply the new positions if the rotation is valid
         if (bCanRotate)
         {
-            if (ShuffleCue2)
-            {
-                UGameplayStatics::PlaySoundAtLocation(this, ShuffleCue2, GetActorLocation());
-            }
+            AudioService->PlayCue(ShuffleCue2);
 
             for (int32 i = 0; i < CurrentTetrominoBlocks.Num(); ++i)
             {
                 FVector2D GridPos = NewGridPositions[i];
 
                 // Convert grid coordinates back to world coordinates
-                FVector NewWorldLocation((GridPos.X * 100.0f) - 1000.0f, 0.0f, GridPos.Y * 100.0f);
+                FVector NewWorldLocation = GridToWorld(FMath::RoundToInt(GridPos.X), FMath::RoundToInt(GridPos.Y));
                 CurrentTetrominoBlocks[i]->SetActorLocation(NewWorldLocation);
             }
+            CurrentPieceRotation = (CurrentPieceRotation + 1) % 4;
+
+            RecordEvent(EGameplayEventType::Rotate);
+            return true;
         }
     }
+
+    return false;
 }
 
 void ATetrisGrid::StartFastDrop()
 {
-    GetWorldTimerManager().ClearTimer(TetrominoFallTimerHandle);
+    SimTimers.ClearTimer(TetrominoFallTimerHandle);
     IsFastDropping = true;
-    GetWorld()->GetTimerManager().SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, FastFallInterval, true);
+    SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, FastFallInterval, true);
 }
 
 void ATetrisGrid::StopFastDrop()
 {
-    GetWorldTimerManager().ClearTimer(TetrominoFallTimerHandle);
+    SimTimers.ClearTimer(TetrominoFallTimerHandle);
     IsFastDropping = false;
-    GetWorld()->GetTimerManager().SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, CurrentFallInterval, true);
+    SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, CurrentFallInterval, true);
 }
 
 void ATetrisGrid::GameOver()
 {
     // Clear the Tetromino fall timer
-    GetWorld()->GetTimerManager().ClearTimer(TetrominoFallTimerHandle);
+    SimTimers.ClearTimer(TetrominoFallTimerHandle);
+
+    // A soak run keeps going: wipe the board and carry on from the next level
+    if (SoakMonitor.IsRunning())
+    {
+        bParityPending = false;
+        ClearBoard();
+        NextLevel();
+        QueueBoardInput(EBoardCommand::SoftDropStart, true, FPlatformTime::Seconds());
+        return;
+    }
+
+    // Versus boards don't leave the map; the game mode settles the match
+    if (ABreakoutVersusGameMode* VersusGameMode = GetWorld()->GetAuthGameMode<ABreakoutVersusGameMode>())
+    {
+        VersusGameMode->OnBoardLost(this);
+        return;
+    }
 
-    // Ensure the player controller is valid before attempting to load the level
-    APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+    // Only the board the player is driving returns to the menu; other boards just stop
+    APlayerController* PlayerController = Cast<APlayerController>(GetController());
     if (PlayerController)
     {
         // Set the input mode to UI only and show the mouse cursor
@@ -1030,157 +2537,261 @@ void ATetrisGrid::GameOver()
     }
 }
 
-FTetrisBlockValue* ATetrisGrid::FindPointValueByName(const FString Input)
+void ATetrisGrid::InitializeMarket()
 {
-    for (FTetrisBlockValue& PointValue : PointValues)
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Market);
+
+    Market.Reset();
+    MarketRandom.Initialize(BoardRandom.RandHelper(MAX_int32));
+    HighRiskTokenMask = 0;
+    StablecoinTokenMask = 0;
+
+    // Listed tokens take the first lanes so token ids map straight onto the engine
+    const int32 NumTokens = FMath::Min(TokenRegistry->Tokens.Num(), UTokenRegistry::MaxTokens);
+    for (int32 TokenId = 0; TokenId < NumTokens; TokenId++)
     {
-        if (Input.Contains(PointValue.BlockName))
-        {
-            return &PointValue;
-        }
+        const FTokenDefinition& Token = TokenRegistry->Tokens[TokenId];
+        const bool bHighRisk = Token.MarketClass == ETokenMarketClass::HighRisk;
+        const bool bStablecoin = Token.MarketClass == ETokenMarketClass::Stablecoin;
+
+        Market.AddToken(Token.BasePrice, 0.0f, MarketVolatility, bHighRisk ? 1.5f : bStablecoin ? 0.1f : 1.0f);
+        HighRiskTokenMask |= bHighRisk ? 1ull << TokenId : 0;
+        StablecoinTokenMask |= bStablecoin ? 1ull << TokenId : 0;
+    }
+
+    // Synthetic listings for profiling the engine; they tick but are never shown or placed on the board
+    for (int32 i = 0; i < MarketStressTokenCount; i++)
+    {
+        Market.AddToken(MarketRandom.FRandRange(2.0f, 50000.0f), 0.0f, MarketVolatility, MarketRandom.FRandRange(0.1f, 1.5f));
     }
-    return nullptr; // Return nullptr if not found
 }
 
-int32 ATetrisGrid::FindPointValueIndexByName(const FString Input)
+int32 ATetrisGrid::GetBlockScoreValue(int32 TokenIndex) const
 {
-    for (int32 Index = 0; Index < PointValues.Num(); Index++)
+    int maxInt32 = std::numeric_limits<int>::max();
+    int32 IntValue = Market.GetPriceAsInt(TokenIndex);
+
+    if (CurrentMarketEvent == EMarketEvent::BullRun)
     {
-        if (Input.Contains(PointValues[Index].BlockName))
-        {
-            return Index;
-        }
+        IntValue = (int32)FMath::Min<int64>((int64)IntValue * 2, maxInt32 - 1);
+    }
+    else if (CurrentMarketEvent == EMarketEvent::CryptoCrash)
+    {
+        IntValue /= 2;
     }
-    return INDEX_NONE; // Return -1 if not found
+
+    return IntValue;
 }
 
 void ATetrisGrid::UpdateMarketValues()
 {
-    // Map to keep track of block counts
-    TMap<FString, int32> BlockCounts;
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Market);
 
-    // Initialize counts to 0
-    for (const FTetrisBlockValue& PointValue : PointValues)
+    // A tick still in flight covers this one
+    if (MarketTask.IsValid())
     {
-        BlockCounts.Add(PointValue.BlockName, 0);
+        return;
     }
 
-    // Count the blocks on the board
-    for (int32 x = 0; x < GridWidth; x++)
+    FMarketTickResult Start;
+    Start.Market = Market;
+    Start.Random = MarketRandom;
+    Start.BaseRevision = Market.GetRevision();
+
+    MarketTaskDueStep = CurrentSimStep + RuleTaskLatencySteps;
+    MarketTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Result = MoveTemp(Start)]() mutable
+    {
+        LLM_SCOPE_BYTAG(BlockchainBreakout_Market);
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        Result.Market.Tick(Result.Random);
+        Result.Microseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+        return MoveTemp(Result);
+    });
+}
+
+void ATetrisGrid::ApplyMarketTick(FMarketTickResult& Result)
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Market);
+
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Market);
+
+    // Replayed tokens report their trend against the price they had before this tick
+    TArray<float, TInlineAllocator<16>> PreviousPrices;
+    if (bUseHistoricalReplay)
     {
-        for (int32 y = 0; y < GridHeight; y++)
+        ReplayTime += ReplaySpeed * MarketTickInterval;
+
+        for (int32 Index = 0; Index < PointValues.Num(); Index++)
         {
-            FVector BlockLocation = FVector((x * 100.0f) - 1000.0f, 0.0f, y * 100.0f);
-            TArray<AActor*> FoundActors;
-            UGameplayStatics::GetAllActorsOfClass(GetWorld(), AActor::StaticClass(), FoundActors);
+            PreviousPrices.Add(Market.GetPrice(Index));
+        }
+    }
+
+    Market = MoveTemp(Result.Market);
+    MarketRandom = Result.Random;
 
-            for (AActor* Actor : FoundActors)
+    if (bUseHistoricalReplay)
+    {
+        for (int32 Index = 0; Index < PointValues.Num(); Index++)
+        {
+            double HistoricalPrice = 0.0;
+            if (PriceStreams.IsValidIndex(Index) && PriceStreams[Index] && PriceStreams[Index]->SampleAt((int64)ReplayTime, HistoricalPrice))
             {
-                if (Actor->GetActorLocation() == BlockLocation)
-                {
-                    FString ActorName = Actor->GetName();
-                    for (FTetrisBlockValue& PointValue : PointValues)
-                    {
-                        if (ActorName.Contains(PointValue.BlockName))
-                        {
-                            BlockCounts[PointValue.BlockName]++;
-                            break;
-                        }
-                    }
-                }
+                Market.SetPrice(Index, (float)HistoricalPrice, PreviousPrices[Index]);
             }
         }
     }
 
-    // Update scores based on counts
-    for (FTetrisBlockValue& PointValue : PointValues)
+    LastMarketTickMicroseconds = Result.Microseconds;
+    RecordEvent(EGameplayEventType::MarketTick, Market.Num(), (int32)CurrentMarketEvent, (int64)LastMarketTickMicroseconds);
+    if (MarketStressTokenCount > 0 && ++MarketStressTickCounter % 60 == 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Market tick: %d tokens in %.2f us"), Market.Num(), LastMarketTickMicroseconds);
+    }
+
+    // Only listed tokens are displayed, so only they get formatted, and only the ones that moved are sent to the UI
+    for (int32 Index = 0; Index < PointValues.Num(); Index++)
     {
-        float pointMultiplier = FMath::RandRange(0.8f, 1.2f);
+        FString NewScoreValue = FString::Printf(TEXT("$%d"), Market.GetPriceAsInt(Index));
+        const bool bTrendingUp = Market.IsTrendingUp(Index);
 
-        if (PointValue.ForceVolatilityToGoDown)
+        if (NewScoreValue != PointValues[Index].ScoreValue || bTrendingUp != PointValues[Index].VolatilityGoingUp)
         {
-            pointMultiplier = 0.99f;
-            PointValue.ForceVolatilityToGoDown = false;
+            PointValues[Index].ScoreValue = MoveTemp(NewScoreValue);
+            PointValues[Index].VolatilityGoingUp = bTrendingUp;
+            MarkTokenChanged(Index);
         }
-        else if (PointValue.ForceVolatilityToGoUp)
+    }
+}
+
+void ATetrisGrid::ApplyRuleTasks()
+{
+    // A task is applied RuleTaskLatencySteps after the step that launched it, never earlier because it happened to
+    // finish, so the outcome doesn't depend on how quickly a worker picked it up. On its due step the game thread
+    // waits for it if it isn't done: that is deliberate, for determinism, and only happens when several catch-up
+    // steps run in one frame or the task outlasts the latency.
+    if (MarketTask.IsValid() && CurrentSimStep >= MarketTaskDueStep)
+    {
+        FMarketTickResult Result = MoveTemp(MarketTask.GetResult());
+        MarketTask = UE::Tasks::TTask<FMarketTickResult>();
+
+        if (Result.BaseRevision == Market.GetRevision())
         {
-            pointMultiplier = 1.2f;
-            PointValue.ForceVolatilityToGoUp = false;
+            ApplyMarketTick(Result);
         }
+        else
+        {
+            // Forced by an explosion or a market event while ticking; tick again from the current state
+            UpdateMarketValues();
+        }
+    }
 
-        int32 IntValue = FCString::Atoi(*PointValue.ScoreValue.Replace(TEXT("$"), TEXT("")).Replace(TEXT(","), TEXT("")).Replace(TEXT("."), TEXT("")));
-        int maxInt32 = std::numeric_limits<int>::max();
-
-        // have at least $2 as a value so the value can go back up if possible
-        int32 NewScore = FMath::Clamp(IntValue * pointMultiplier, 2, maxInt32);
-        FString DollarAmount = FString::Printf(TEXT("$%d"), NewScore);
-        
-        int maxFloat = std::numeric_limits<float>::max();
-        PointValue.ScoreValue = DollarAmount;
+    if (ComboTask.IsValid() && CurrentSimStep >= ComboTaskDueStep)
+    {
+        FBoardEvaluation Evaluation = MoveTemp(ComboTask.GetResult());
+        ComboTask = UE::Tasks::TTask<FBoardEvaluation>();
 
-        if (pointMultiplier <= 1.0f)
+        if (Evaluation.Generation == BoardGeneration)
         {
-            PointValue.VolatilityGoingUp = false;
+            ApplyComboEvaluation(Evaluation);
         }
         else
         {
-            PointValue.VolatilityGoingUp = true;
+            LaunchComboEvaluation();
+        }
+    }
+}
+
+void ATetrisGrid::OpenHistoricalReplay()
+{
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Market);
+
+    PriceStreams.Reset();
+    PriceStreams.SetNum(PointValues.Num());
+
+    const FString Directory = FPaths::Combine(FPaths::ProjectContentDir(), HistoricalDataDirectory);
+    int64 EarliestTime = TNumericLimits<int64>::Max();
+
+    for (int32 Index = 0; Index < PointValues.Num(); Index++)
+    {
+        TUniquePtr<FHistoricalPriceStream> Stream = MakeUnique<FHistoricalPriceStream>();
+        const FString BinaryPath = FPaths::Combine(Directory, PointValues[Index].BlockName + TEXT(".bin"));
+        const FString CsvPath = FPaths::Combine(Directory, PointValues[Index].BlockName + TEXT(".csv"));
+
+        if (Stream->Open(FPaths::FileExists(BinaryPath) ? BinaryPath : CsvPath, ReplayRingCapacity))
+        {
+            EarliestTime = FMath::Min(EarliestTime, Stream->GetStartTime());
+            PriceStreams[Index] = MoveTemp(Stream);
         }
     }
 
-    OnUpdateUI.Broadcast();
+    if (EarliestTime == TNumericLimits<int64>::Max())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No historical price series found in %s, falling back to the random market"), *Directory);
+        bUseHistoricalReplay = false;
+        return;
+    }
+
+    ReplayTime = (double)EarliestTime;
+}
+
+void ATetrisGrid::SeekHistoricalReplay(FDateTime Time)
+{
+    ReplayTime = (double)Time.ToUnixTimestamp();
+
+    for (TUniquePtr<FHistoricalPriceStream>& Stream : PriceStreams)
+    {
+        if (Stream)
+        {
+            Stream->Seek((int64)ReplayTime);
+        }
+    }
 }
 
 void ATetrisGrid::UpdateMarketEvents() {
-    int RandomMarketEvent = FMath::RandRange(0, 1);
+    int RandomMarketEvent = BoardRandom.RandRange(0, 1);
 
-    switch (RandomMarketEvent)
+    // The new event replaces whichever popup the last one left up
+    for (UUserWidget** EventWidget : { &BullRunWidget, &CryptoCrashWidget })
     {
-    case 0:
-        if (BullRunClass)
+        if (*EventWidget)
         {
-            BullRunWidget = CreateWidget<UUserWidget>(GetWorld(), BullRunClass);
-            if (BullRunWidget)
-            {
-                BullRunWidget->AddToViewport();
-            }
+            (*EventWidget)->RemoveFromParent();
+            *EventWidget = nullptr;
         }
+    }
+
+    switch (RandomMarketEvent)
+    {
+    case 0:
+        Presentation.RequestWidget(BullRunClass, &BullRunWidget);
 
         CurrentMarketEvent = EMarketEvent::BullRun;
+        Market.SetMarketDrift(MarketEventDrift);
         // clear and reset the fall interval
         CurrentFallInterval = BullRunFallInterval;
-        GetWorldTimerManager().ClearTimer(TetrominoFallTimerHandle);
-        GetWorldTimerManager().SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, IsFastDropping ? FastFallInterval : CurrentFallInterval, true);
+        SimTimers.ClearTimer(TetrominoFallTimerHandle);
+        SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, IsFastDropping ? FastFallInterval : CurrentFallInterval, true);
         break;
     case 1:
-        if (CryptoCrashClass)
-        {
-            CryptoCrashWidget = CreateWidget<UUserWidget>(GetWorld(), CryptoCrashClass);
-            if (CryptoCrashWidget)
-            {
-                CryptoCrashWidget->AddToViewport();
-            }
-        }
+        Presentation.RequestWidget(CryptoCrashClass, &CryptoCrashWidget);
 
         CurrentMarketEvent = EMarketEvent::CryptoCrash;
+        Market.SetMarketDrift(-MarketEventDrift);
         // clear and reset the fall interval
         CurrentFallInterval = CryptoCrashFallInterval;
-        GetWorldTimerManager().ClearTimer(TetrominoFallTimerHandle);
-        GetWorldTimerManager().SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, IsFastDropping ? FastFallInterval : CurrentFallInterval, true);
+        SimTimers.ClearTimer(TetrominoFallTimerHandle);
+        SimTimers.SetTimer(TetrominoFallTimerHandle, this, &ATetrisGrid::MoveTetrominoDown, IsFastDropping ? FastFallInterval : CurrentFallInterval, true);
         break;
     }
-    
-    MarketEventsInterval = FMath::RandRange(30.0f, 45.0f);
-}
-
-void ATetrisGrid::TriggerExplosion(AActor* HighValueToken1, AActor* HighValueToken2, FLinearColor ExplosionColor1, FLinearColor ExplosionColor2)
-{
-    if (ExplosionCue)
-    {
-        UGameplayStatics::PlaySoundAtLocation(this, ExplosionCue, GetActorLocation());
-    }
+    
+    MarketEventsInterval = BoardRandom.FRandRange(30.0f, 45.0f);
+}
 
-    TArray<FVector> ExplosionOffsets = {
+namespace
+{
+    // The eight cells around an explosion, in board space
+    const FVector ExplosionOffsets[] = {
         FVector(100.0f, 0.0f, 0.0f),   // Right
         FVector(-100.0f, 0.0f, 0.0f),  // Left
         FVector(0.0f, 0.0f, 100.0f),   // Up
@@ -1190,38 +2801,42 @@ void ATetrisGrid::TriggerExplosion(AActor* HighValueToken1, AActor* HighValueTok
         FVector(100.0f, 0.0f, -100.0f),  // Bottom Right
         FVector(-100.0f, 0.0f, -100.0f)  // Bottom Left
     };
+}
+
+void ATetrisGrid::TriggerExplosion(AActor* HighValueToken1, AActor* HighValueToken2, FLinearColor ExplosionColor1, FLinearColor ExplosionColor2)
+{
+    Presentation.RequestSound(ExplosionCue);
 
     FVector Token1Location = HighValueToken1->GetActorLocation();
     FVector Token2Location = HighValueToken2->GetActorLocation();
 
+    const FIntPoint ExplosionCell = WorldToGrid(Token1Location);
+    RecordEvent(EGameplayEventType::Explosion, ExplosionCell.X, ExplosionCell.Y, 0);
+
     // Destroy high-value tokens and update grid
-    DestroyBlockAtLocation(Token1Location);
-    DestroyBlockAtLocation(Token2Location);
+    DestroyBlockAtLocation(Token1Location, EScoreSource::PairExplosion);
+    DestroyBlockAtLocation(Token2Location, EScoreSource::PairExplosion);
 
     // Trigger explosion effects at adjacent blocks
     for (const FVector& Offset : ExplosionOffsets)
     {
-        FVector ExplosionLocation1 = Token1Location + Offset;
-        FVector ExplosionLocation2 = Token2Location + Offset;
+        FVector ExplosionLocation1 = Token1Location + GetActorTransform().TransformVector(Offset);
+        FVector ExplosionLocation2 = Token2Location + GetActorTransform().TransformVector(Offset);
 
         // Directly update the grid at the expected explosion locations
         UpdateGridAtLocation(ExplosionLocation1);
         UpdateGridAtLocation(ExplosionLocation2);
-
-        APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
-        if (PlayerController && CameraShakeClass.IsValid())
-        {
-            UClass* LoadedCameraShakeClass = CameraShakeClass.Get();
-            PlayerController->ClientStartCameraShake(LoadedCameraShakeClass);
-        }
-
-        SpawnNiagaraSystem(TEXT("/Game/VFX/NS_Explosion"), (Token1Location + Token2Location) / 2.0f, ExplosionColor1, ExplosionColor2);
     }
+
+    Presentation.RequestCameraShake();
+    Presentation.RequestVfx(TEXT("/Game/VFX/NS_Explosion"), (Token1Location + Token2Location) / 2.0f, ExplosionColor1, ExplosionColor2);
 }
 
 void ATetrisGrid::CheckForBlocksToDrop()
 {
-    DropsArray.Empty();
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Drops);
+
+    DropsArray.Reset();
 
     for (int32 x = 0; x < GridWidth; ++x)
     {
@@ -1253,7 +2868,7 @@ void ATetrisGrid::CheckForBlocksToDrop()
     // Start the timer for the drops
     if (DropsArray.Num() > 0)
     {
-        GetWorldTimerManager().SetTimer(
+        SimTimers.SetTimer(
             DropTimerHandle, this,
             &ATetrisGrid::HandleMultipleDrops,
             0.2f, true
@@ -1269,14 +2884,20 @@ void ATetrisGrid::HandleMultipleDrops()
     {
         if (Drop.LoopIndex < Drop.DropDistance)
         {
+            // The block may have been destroyed by an explosion since the drop was planned
+            if (!Grid[Drop.X][Drop.Y1])
+            {
+                Drop.LoopIndex = Drop.DropDistance;
+                continue;
+            }
+
             bAnyDropInProgress = true;
 
             // Execute drop logic for the current block
-            FVector NewLocation = Grid[Drop.X][Drop.Y1]->GetActorLocation() - FVector(0.0f, 0.0f, 100.0f);
-            Grid[Drop.X][Drop.Y1]->SetActorLocation(NewLocation);
+            Grid[Drop.X][Drop.Y1]->SetActorLocation(GridToWorld(Drop.X, Drop.Y1 - 1));
 
-            Grid[Drop.X][Drop.Y1 - 1] = Grid[Drop.X][Drop.Y1];
-            Grid[Drop.X][Drop.Y1] = nullptr;
+            SetGrid(Drop.X, Drop.Y1 - 1, Grid[Drop.X][Drop.Y1]);
+            SetGrid(Drop.X, Drop.Y1, nullptr);
 
             Drop.Y1--;
             Drop.LoopIndex++;
@@ -1286,52 +2907,51 @@ void ATetrisGrid::HandleMultipleDrops()
     // Stop the timer if all drops are complete
     if (!bAnyDropInProgress)
     {
-        GetWorldTimerManager().ClearTimer(DropTimerHandle);
+        SimTimers.ClearTimer(DropTimerHandle);
         CheckForCombos();
     }
 }
 
 void ATetrisGrid::MoveBlocksToDropDown()
 {
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Drops);
+
     if (!bIsCheckingForCombos)
     {
-        UE_LOG(LogTemp, Warning, TEXT("BlocksToDrop length: %d"), BlocksToDrop.Num());
-
         bIsAnimating = true;
 
         bool bBlockMoved = false;
 
         for (auto& Elem : BlocksToDrop)
         {
-            AActor* Actor = Elem.Key;
+            AActor* Actor = Elem.Key.Get();
             int32& Value = Elem.Value;
 
-            if (Value > 0)
+            if (Actor && Value > 0)
             {
-                FVector CurrentLocation = Actor->GetActorLocation();
-                FVector NewLocation = CurrentLocation - FVector(0.0f, 0.0f, 100.0f);
+                FIntPoint NewGridPosition = WorldToGrid(Actor->GetActorLocation()) + FIntPoint(0, -1);
 
                 // Check if the new location is above the bottom of the board
-                if (NewLocation.Z >= 0.0f)
+                if (NewGridPosition.Y >= 0)
                 {
-                    Actor->SetActorLocation(NewLocation);
+                    Actor->SetActorLocation(GridToWorld(NewGridPosition.X, NewGridPosition.Y));
                     Value = Value - 1;
                     bBlockMoved = true;
 
-                    UE_LOG(LogTemp, Warning, TEXT("Dropping block %s, Value: %d"), *Actor->GetName(), Value);
+                    RecordEvent(EGameplayEventType::Drop, NewGridPosition.X, NewGridPosition.Y, Value);
                 }
                 else
                 {
                     Value = 0; // Set Value to 0 if it has reached the bottom
-                    UE_LOG(LogTemp, Warning, TEXT("Block %s has reached the bottom."), *Actor->GetName());
                 }
             }
         }
 
-        // If no blocks moved, end the animation
+        // If no blocks moved, end the animation and forget the settled blocks
         if (!bBlockMoved)
         {
             bIsAnimating = false;
+            BlocksToDrop.Reset();
         }
     }
 }
@@ -1339,146 +2959,151 @@ void ATetrisGrid::MoveBlocksToDropDown()
 void ATetrisGrid::CheckForCombos()
 {
     bIsCheckingForCombos = true;
-    bool bHasFoundCombo = false;
 
-    for (int x = 0; x < GridWidth - 1; x++)
+    // An evaluation in flight is redone anyway if the board changes before it finishes
+    if (!ComboTask.IsValid())
     {
-        for (int y = 0; y < GridHeight - 1; y++)
-        {
-            AActor* GridBlock = Grid[x][y];
-            if (GridBlock != nullptr)
-            {
-                if (IsValid(GridBlock) && GridBlock->Tags.Contains("TetrisBlock"))
-                {
-                    FTetrisBlockValue* FoundValue = FindPointValueByName(*GridBlock->GetName());
-
-                    if (GridBlock->Tags.Contains(FName("CanClearThreeRows")) && !GridBlock->Tags.Contains(FName("CannotBlowUpYet")))
-                    {
-                        if (FoundValue->BlockName + "_circ" == ComboTarget)
-                        {
-                            // Combos = FMath::Clamp(Combos + 1, 0, 5);
-                        }
-                        ClearThreeRows(y);
-                        SpawnNiagaraSystem(TEXT("/Game/VFX/NS_Explosion"), GridBlock->GetActorLocation(), FoundValue->Color, FoundValue->Color);
-                        SpawnRowClearEffect(GridBlock->GetActorLocation(), FoundValue->Color);
-                        bHasFoundCombo = true;
-                    }
-                }
-                else if (IsValid(GridBlock) && GridBlock->Tags.Contains("BombBlock"))
-                {
-                    SpawnBombExplosion(GridBlock);
-                }
-            }
-        }
+        LaunchComboEvaluation();
     }
+}
 
-    TArray<AActor*> BlocksToCheckForExplosions;
+void ATetrisGrid::LaunchComboEvaluation()
+{
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Combos);
+
+    FBoardSnapshot Snapshot;
+    Snapshot.Generation = BoardGeneration;
+    Snapshot.Width = GridWidth;
+    Snapshot.Height = GridHeight;
+    Snapshot.BlockPairingSet = CurrentLevel.BlockPairingSet;
+    Snapshot.Tokens = TokenPlanes;
+    Snapshot.Flags.SetNumZeroed(GridWidth * GridHeight);
 
     for (int32 x = 0; x < GridWidth; ++x)
     {
         for (int32 y = 0; y < GridHeight; ++y)
         {
             AActor* Block = Grid[x][y];
-
-            if (Block)
+            if (!IsValid(Block))
             {
-                if (CurrentLevel.BlockPairingSet <= 4)
-                {
-                    // Check for 4-of-a-kind
-                    if (CheckForSuperDuperBlockFormation(Block))
-                    {
-                        continue;
-                    }
-                }
-
-                if (CurrentLevel.BlockPairingSet <= 3)
-                {
-                    // Check for super blocks
-                    if (CheckForSuperBlockFormation(Block))
-                    {
-                        // If a super block is formed, skip checking for explosions for this block
-                        continue;
-                    }
-                }
+                continue;
+            }
 
-                // Add the block to the list for explosion checks
-                BlocksToCheckForExplosions.Add(Block);
+            EBoardCellFlags& Flags = Snapshot.Flags[x * GridHeight + y];
+            Flags = EBoardCellFlags::Occupied;
+            for (const FName& Tag : Block->Tags)
+            {
+                Flags |= Tag == FName("TetrisBlock") ? EBoardCellFlags::TetrisBlock
+                    : Tag == FName("SuperBlock") ? EBoardCellFlags::SuperBlock
+                    : Tag == FName("BombBlock") ? EBoardCellFlags::Bomb
+                    : Tag == FName("CanClearThreeRows") ? EBoardCellFlags::CanClearThreeRows
+                    : Tag == FName("CannotBlowUpYet") ? EBoardCellFlags::CannotBlowUpYet
+                    : Tag == FName("GlowBlock") ? EBoardCellFlags::Glow
+                    : EBoardCellFlags::None;
             }
         }
     }
 
-    if (CurrentLevel.BlockPairingSet <= 2)
+    ComboTaskDueStep = CurrentSimStep + RuleTaskLatencySteps;
+    ComboTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Snapshot = MoveTemp(Snapshot)]()
+    {
+        LLM_SCOPE_BYTAG(BlockchainBreakout_Board);
+        return Snapshot.Evaluate();
+    });
+}
+
+void ATetrisGrid::ApplyComboEvaluation(const FBoardEvaluation& Evaluation)
+{
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Combos);
+
+    bool bHasFoundCombo = false;
+
+    for (const FBoardBlast& Blast : Evaluation.Blasts)
     {
-        for (AActor* Block : BlocksToCheckForExplosions)
+        // An earlier blast in this pass may already have cleared it
+        AActor* GridBlock = Grid[Blast.Cell.X][Blast.Cell.Y];
+        if (!IsValid(GridBlock))
         {
-            // Check for horizontal and vertical high-value token combinations
-            bool bHorizontal = CheckForHorizontalExplosions(Block);
-            bool bVertical = CheckForVerticalExplosions(Block);
+            continue;
+        }
 
-            if (bHorizontal || bVertical)
-            {
-                bHasFoundCombo = true;
-            }
+        if (Blast.bBomb)
+        {
+            SpawnBombExplosion(GridBlock);
+            continue;
         }
+
+        const int32 TokenIndex = GetTokenId(GridBlock);
+        const FLinearColor Color = TokenIndex != INDEX_NONE ? PointValues[TokenIndex].Color : FLinearColor::White;
+        const FVector BlastLocation = GridBlock->GetActorLocation();
+
+        ClearThreeRows(Blast.Cell.Y);
+        Presentation.RequestVfx(TEXT("/Game/VFX/NS_Explosion"), BlastLocation, Color, Color, 1);
+        SpawnRowClearEffect(BlastLocation, Color);
+        bHasFoundCombo = true;
+    }
+
+    // Clusters and pairs are looked for on what the blasts left behind
+    if (Evaluation.Blasts.Num() > 0)
+    {
+        bComboPassFoundCombo |= bHasFoundCombo;
+        LaunchComboEvaluation();
+        return;
+    }
+
+    // One super block forms at a time, since the glow animation follows a single cluster; the others are found again
+    // once it lands
+    if (Evaluation.Clusters.Num() > 0)
+    {
+        FormCluster(Evaluation.Clusters[0]);
+    }
+
+    if (TriggerPairExplosions(Evaluation.Pairs))
+    {
+        bHasFoundCombo = true;
     }
 
-    if (bHasFoundCombo)
+    if (bHasFoundCombo || bComboPassFoundCombo)
     {
         CheckForBlocksToDrop();
     }
+    bComboPassFoundCombo = false;
 
     CheckAndClearFullRows();
 
     bIsCheckingForCombos = false;
 }
 
-void ATetrisGrid::DestroyBlockAtLocation(FVector Location)
+void ATetrisGrid::DestroyBlockAtLocation(FVector Location, EScoreSource ScoreSource)
 {
-    TArray<AActor*> FoundActors;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AActor::StaticClass(), FoundActors);
-    int maxInt32 = std::numeric_limits<int>::max();
+    // Convert world coordinates to grid coordinates; only this board's cells are considered
+    FIntPoint GridPosition = WorldToGrid(Location);
+    int32 GridX = GridPosition.X;
+    int32 GridY = GridPosition.Y;
 
-    for (AActor* Actor : FoundActors)
+    // Check if the coordinates are within grid bounds
+    if (GridX >= 0 && GridX < GridWidth && GridY >= 0 && GridY < GridHeight)
     {
-        FVector ActorLocation = Actor->GetActorLocation();
-        if ((Actor->Tags.Contains(FName("TetrisBlock")) || Actor->Tags.Contains("BombBlock")) && ActorLocation == Location)
+        AActor* Actor = Grid[GridX][GridY];
+        if (Actor && IsValid(Actor) && (Actor->Tags.Contains(FName("TetrisBlock")) || Actor->Tags.Contains("BombBlock")))
         {
-            // Convert world coordinates to grid coordinates
-            int32 GridX = FMath::RoundToInt((ActorLocation.X + 1000.0f) / 100.0f);
-            int32 GridY = FMath::RoundToInt(ActorLocation.Z / 100.0f);
+            int32 TokenIndex = GetTokenId(Actor);
 
-            // Check if the coordinates are within grid bounds
-            if (GridX >= 0 && GridX < GridWidth && GridY >= 0 && GridY < GridHeight)
+            if (TokenIndex != INDEX_NONE)
             {
-                FTetrisBlockValue* FoundValue = FindPointValueByName(*Actor->GetName());
-
-                if (FoundValue)
-                {
-                    int32 IntValue = FMath::Clamp(FCString::Atoi(*FoundValue->ScoreValue.Replace(TEXT("$"), TEXT("")).Replace(TEXT(","), TEXT("")).Replace(TEXT("."), TEXT(""))), 0, maxInt32 - 1);
-
-                    if (CurrentMarketEvent == EMarketEvent::BullRun)
-                    {
-                        IntValue = FMath::Clamp(IntValue * 2, 0, maxInt32 - 1);
-                    }
-                    else if (CurrentMarketEvent == EMarketEvent::CryptoCrash)
-                    {
-                        IntValue /= 2;
-                    }
-
-                    IncrementScore(Score + IntValue);
-                }
-
-                SetGrid(GridX, GridY, nullptr);
-                Actor->Destroy();
+                AddScore(ScoreSource, GetBlockScoreValue(TokenIndex));
             }
+
+            ReleaseGridBlock(GridX, GridY);
         }
     }
 }
 
 void ATetrisGrid::UpdateGridAtLocation(FVector Location)
 {
-    int32 GridX = FMath::RoundToInt((Location.X + 1000.0f) / 100.0f);
-    int32 GridY = FMath::RoundToInt(Location.Z / 100.0f);
+    FIntPoint GridPosition = WorldToGrid(Location);
+    int32 GridX = GridPosition.X;
+    int32 GridY = GridPosition.Y;
 
     if (GridX >= 0 && GridX < GridWidth && GridY >= 0 && GridY < GridHeight)
     {
@@ -1487,391 +3112,102 @@ void ATetrisGrid::UpdateGridAtLocation(FVector Location)
             if ((Grid[GridX][GridY]->Tags.Contains(FName("TetrisBlock")) || Grid[GridX][GridY]->Tags.Contains(FName("BombBlock"))) && 
             !Grid[GridX][GridY]->Tags.Contains(FName("SuperBlock")))
             {
-                Grid[GridX][GridY]->Destroy();
-                Grid[GridX][GridY] = nullptr;
+                ReleaseGridBlock(GridX, GridY);
             }
         }
     }
 }
 
-bool ATetrisGrid::CheckForExplosions(AActor* Actor, FVector Direction)
+bool ATetrisGrid::TriggerPairExplosions(const TArray<FTokenPair>& Pairs)
 {
-    if (Actor->Tags.Contains(FName("SuperBlock")) || Actor->Tags.Contains(FName("GlowBlock")))
-    {
-        return false;
-    }
-
-    bool bToReturn = false;
-    
-    FVector BlockLocation = Actor->GetActorLocation();
-    FVector TargetLocation = BlockLocation + Direction;
-
-    AActor* AdjacentActor = IsGridOccupied(FMath::RoundToInt((TargetLocation.X + 1000.0f) / 100.0f), FMath::RoundToInt(TargetLocation.Z / 100.0f));
-    if (AdjacentActor && AdjacentActor->Tags.Contains(FName("TetrisBlock")) && !AdjacentActor->Tags.Contains(FName("SuperBlock")))
+    uint64 ExplodedTokens = 0;
+    for (const FTokenPair& Pair : Pairs)
     {
-        FTetrisBlockValue* ActorValue = FindPointValueByName(*Actor->GetName());
-        FTetrisBlockValue* AdjacentValue = FindPointValueByName(*AdjacentActor->GetName());
-
-        if (ActorValue && AdjacentValue)
-        {
-            static const TArray<FString> HighRiskBlocks = { "bitcoin", "ethereum", "solana" };
-            static const TArray<FString> StablecoinBlocks = { "usdc", "tether" };
-            if (ActorValue->BlockName == AdjacentValue->BlockName)
-            {
-                if (Actor != AdjacentActor)
-                {
-                    bToReturn = true;
-                    TriggerExplosion(Actor, AdjacentActor, ActorValue->Color, AdjacentValue->Color);
-
-                    if (ActorValue->BlockName + "_circ" == ComboTarget || AdjacentValue->BlockName + "_circ" == ComboTarget)
-                    {
-                        // Combos = FMath::Clamp(Combos + 1, 0, 5);
-                    }
-
-                    // trigger market update
-                    if (HighRiskBlocks.Contains(ActorValue->BlockName) && HighRiskBlocks.Contains(AdjacentValue->BlockName))
-                    {
-                        // trigger market shutdown
-                        for (FTetrisBlockValue& PointValue : PointValues)
-                        {
-                            PointValue.ForceVolatilityToGoDown = true;
-                        }
-                    }
-                    else if (StablecoinBlocks.Contains(ActorValue->BlockName) && StablecoinBlocks.Contains(AdjacentValue->BlockName))
-                    {
-                        // trigger a market uptick
-                        for (FTetrisBlockValue& PointValue : PointValues)
-                        {
-                            PointValue.ForceVolatilityToGoUp = true;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    return bToReturn;
-}
-
-bool ATetrisGrid::CheckForHorizontalExplosions(AActor* Actor)
-{
-    return CheckForExplosions(Actor, FVector(100.0f, 0.0f, 0.0f));
-}
-
-bool ATetrisGrid::CheckForVerticalExplosions(AActor* Actor)
-{
-    return CheckForExplosions(Actor, FVector(0.0f, 0.0f, 100.0f));
-}
-
-// bool ATetrisGrid::CheckForSuperBlockFormation(AActor* Actor)
-// {
-//     if (IsValid(Actor))
-//     {
-//         // Define relative positions for possible super block formations
-//         static const TArray<TArray<FVector>> Directions = {
-//             // Horizontal
-//             { FVector(100.0f, 0.0f, 0.0f), FVector(200.0f, 0.0f, 0.0f) },
-//             // Vertical
-//             { FVector(0.0f, 0.0f, 100.0f), FVector(0.0f, 0.0f, 200.0f) },
-//             // L-shape configurations
-//             { FVector(100.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 100.0f) },
-//             { FVector(-100.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, 100.0f) },
-//             { FVector(100.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, -100.0f) },
-//             { FVector(-100.0f, 0.0f, 0.0f), FVector(0.0f, 0.0f, -100.0f) },
-//             { FVector(100.0f, 0.0f, 0.0f), FVector(100.0f, 0.0f, 100.0f) },
-//             { FVector(100.0f, 0.0f, 0.0f), FVector(100.0f, 0.0f, -100.0f) },
-//             { FVector(0.0f, 0.0f, 100.0f), FVector(100.0f, 0.0f, 100.0f) },
-//             { FVector(0.0f, 0.0f, -100.0f), FVector(100.0f, 0.0f, -100.0f) }
-//         };
-
-//         FVector BlockLocation = Actor->GetActorLocation();
-//         FTetrisBlockValue* ActorValue = FindPointValueByName(*Actor->GetName());
-//         if (!ActorValue) return false;
-
-//         TArray<AActor*> FoundActors;
-//         UGameplayStatics::GetAllActorsOfClass(GetWorld(), AActor::StaticClass(), FoundActors);
-
-//         for (const auto& DirectionSet : Directions)
-//         {
-//             FVector Loc1 = BlockLocation + DirectionSet[0];
-//             FVector Loc2 = BlockLocation + DirectionSet[1];
-
-//             AActor* Actor1 = nullptr;
-//             AActor* Actor2 = nullptr;
-
-//             for (AActor* FoundActor : FoundActors)
-//             {
-//                 if (FoundActor->Tags.Contains(FName("GlowBlock"))) continue;
-
-//                 FVector FoundLocation = FoundActor->GetActorLocation();
-//                 if (FoundLocation == Loc1)
-//                 {
-//                     Actor1 = FoundActor;
-//                 }
-//                 else if (FoundLocation == Loc2)
-//                 {
-//                     Actor2 = FoundActor;
-//                 }
-
-//                 if (Actor1 && Actor2)
-//                 {
-//                     break;
-//                 }
-//             }
-
-//             if (Actor1 && Actor2)
-//             {
-//                 FTetrisBlockValue* Value1 = FindPointValueByName(*Actor1->GetName());
-//                 FTetrisBlockValue* Value2 = FindPointValueByName(*Actor2->GetName());
-
-//                 if (Value1 && Value2 && ActorValue->BlockName == Value1->BlockName && ActorValue->BlockName == Value2->BlockName)
-//                 {
-//                     TargetActors = {
-//                         { Actor, Actor1, Actor2 },
-//                         0.0f,
-//                         Actor->GetName(),
-//                         { Actor->GetActorLocation(), Actor1->GetActorLocation(), Actor2->GetActorLocation() }
-//                     };
-//                     GlowBlocks();
-
-//                     return true;
-//                 }
-//             }
-//         }
-
-//         return false;
-//     }
-//     else
-//     {
-//         return false;
-//     }
-// }
-
-bool ATetrisGrid::CheckForSuperBlockFormation(AActor* Actor)
-{
-    if (!IsValid(Actor)) return false;
-    if (Actor->GetName().Contains("super")) return false;
-
-    FVector BlockLocation = Actor->GetActorLocation();
-    FTetrisBlockValue* ActorValue = FindPointValueByName(*Actor->GetName());
-    if (!ActorValue) return false;
-
-    // Stores blocks already visited to prevent infinite loops
-    TSet<AActor*> VisitedBlocks;
-    TArray<AActor*> MatchingBlocks;
-
-    // Lambda function for recursive DFS
-    auto DFS = [&](AActor* CurrentBlock, auto&& DFSRef) -> void
-    {
-        if (!IsValid(CurrentBlock) || VisitedBlocks.Contains(CurrentBlock)) return;
-
-        // Mark the current block as visited
-        VisitedBlocks.Add(CurrentBlock);
-        MatchingBlocks.Add(CurrentBlock);
-
-        FVector CurrentLocation = CurrentBlock->GetActorLocation();
-
-        // Check neighbors in four directions: left, right, up, down
-        static const TArray<FVector> Directions = {
-            FVector(100.0f, 0.0f, 0.0f),  // Right
-            FVector(-100.0f, 0.0f, 0.0f), // Left
-            FVector(0.0f, 0.0f, 100.0f),  // Up
-            FVector(0.0f, 0.0f, -100.0f)  // Down
-        };
-
-        for (const FVector& Direction : Directions)
+        // An earlier explosion this pass may already have taken one of the cells
+        if (TokenPlanes.GetCell(Pair.A.X, Pair.A.Y) != Pair.Token || TokenPlanes.GetCell(Pair.B.X, Pair.B.Y) != Pair.Token)
         {
-            FVector NeighborLocation = CurrentLocation + Direction;
-
-            // Find the neighbor block
-            AActor* NeighborBlock = nullptr;
-            for (AActor* FoundActor : TActorRange<AActor>(GetWorld()))
-            {
-                if (FoundActor->GetActorLocation() == NeighborLocation &&
-                    !VisitedBlocks.Contains(FoundActor))
-                {
-                    FTetrisBlockValue* NeighborValue = FindPointValueByName(*FoundActor->GetName());
-                    if (NeighborValue && NeighborValue->BlockName == ActorValue->BlockName && 
-                        !Actor->Tags.Contains("GlowBlock") && !FoundActor->Tags.Contains("GlowBlock") &&
-                        !Actor->GetName().Contains("super") && !FoundActor->GetName().Contains("super"))
-                    {
-                        NeighborBlock = FoundActor;
-                        break;
-                    }
-                }
-            }
-
-            // Recur to the neighbor block if it's valid
-            if (NeighborBlock)
-            {
-                DFSRef(NeighborBlock, DFSRef);
-            }
+            continue;
         }
-    };
 
-    // Start the DFS from the initial block
-    DFS(Actor, DFS);
+        const FLinearColor Color = PointValues[Pair.Token].Color;
+        TriggerExplosion(Grid[Pair.A.X][Pair.A.Y], Grid[Pair.B.X][Pair.B.Y], Color, Color);
+        ExplodedTokens |= 1ull << Pair.Token;
+    }
 
-    // Check if enough blocks were matched (e.g., 4 blocks for a "super duper block")
-    if (MatchingBlocks.Num() >= 3)
+    // High-risk pairs crash the market, stablecoin pairs lift it
+    if (ExplodedTokens & HighRiskTokenMask)
     {
-        // Collect block locations
-        TArray<FVector> BlockLocations;
-        TArray<AActor*> FirstMatchingBlocks;
-        // for (AActor* Block : MatchingBlocks)
-        for (int32 i = 0; i < 3; ++i)
-        {
-            AActor* Block = MatchingBlocks[i];
-            if (IsValid(Block))
-            {
-                FirstMatchingBlocks.Add(Block);
-                BlockLocations.Add(Block->GetActorLocation());
-                Block->Tags.Add(FName("ToGlow"));
-            }
-        }
-
-        // Store matching blocks and trigger effects
-        TargetActors = {
-            FirstMatchingBlocks,
-            0.0f,
-            Actor->GetName(),
-            BlockLocations
-        };
-        // GlowSuperDuperBlocks();
-        GlowBlocks();
-
-        return true;
+        Market.ForceAllDown();
+    }
+    else if (ExplodedTokens & StablecoinTokenMask)
+    {
+        Market.ForceAllUp();
     }
 
-    return false;
+    return ExplodedTokens != 0;
 }
 
-bool ATetrisGrid::CheckForSuperDuperBlockFormation(AActor* Actor)
+void ATetrisGrid::FormCluster(const FBoardCluster& Cluster)
 {
-    if (!IsValid(Actor)) return false;
-    if (Actor->GetName().Contains("super")) return false;
-
-    FVector BlockLocation = Actor->GetActorLocation();
-    FTetrisBlockValue* ActorValue = FindPointValueByName(*Actor->GetName());
-    if (!ActorValue) return false;
-
-    // Stores blocks already visited to prevent infinite loops
-    TSet<AActor*> VisitedBlocks;
-    TArray<AActor*> MatchingBlocks;
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Clusters);
+    FBoardArenaMark ArenaMark;
 
-    // Lambda function for recursive DFS
-    auto DFS = [&](AActor* CurrentBlock, auto&& DFSRef) -> void
+    TBoardArenaArray<AActor*> ClusterBlocks;
+    TBoardArenaArray<FVector> BlockLocations;
+    for (const FIntPoint& Cell : Cluster.Cells)
     {
-        if (!IsValid(CurrentBlock) || VisitedBlocks.Contains(CurrentBlock)) return;
-
-        // Mark the current block as visited
-        VisitedBlocks.Add(CurrentBlock);
-        MatchingBlocks.Add(CurrentBlock);
-
-        FVector CurrentLocation = CurrentBlock->GetActorLocation();
-
-        // Check neighbors in four directions: left, right, up, down
-        static const TArray<FVector> Directions = {
-            FVector(100.0f, 0.0f, 0.0f),  // Right
-            FVector(-100.0f, 0.0f, 0.0f), // Left
-            FVector(0.0f, 0.0f, 100.0f),  // Up
-            FVector(0.0f, 0.0f, -100.0f)  // Down
-        };
-
-        for (const FVector& Direction : Directions)
+        AActor* Block = Grid[Cell.X][Cell.Y];
+        if (IsValid(Block))
         {
-            FVector NeighborLocation = CurrentLocation + Direction;
-
-            // Find the neighbor block
-            AActor* NeighborBlock = nullptr;
-            for (AActor* FoundActor : TActorRange<AActor>(GetWorld()))
-            {
-                if (FoundActor->GetActorLocation() == NeighborLocation &&
-                    !VisitedBlocks.Contains(FoundActor))
-                {
-                    FTetrisBlockValue* NeighborValue = FindPointValueByName(*FoundActor->GetName());
-                    if (NeighborValue && NeighborValue->BlockName == ActorValue->BlockName && 
-                        !Actor->Tags.Contains("GlowBlock") && !FoundActor->Tags.Contains("GlowBlock") &&
-                        !Actor->GetName().Contains("super") && !FoundActor->GetName().Contains("super"))
-                    {
-                        NeighborBlock = FoundActor;
-                        break;
-                    }
-                }
-            }
-
-            // Recur to the neighbor block if it's valid
-            if (NeighborBlock)
-            {
-                DFSRef(NeighborBlock, DFSRef);
-            }
+            ClusterBlocks.Add(Block);
+            BlockLocations.Add(Block->GetActorLocation());
+            Block->Tags.Add(FName("ToGlow"));
         }
-    };
-
-    // Start the DFS from the initial block
-    DFS(Actor, DFS);
+    }
 
-    // Check if enough blocks were matched (e.g., 4 blocks for a "super duper block")
-    if (MatchingBlocks.Num() >= 4)
+    if (ClusterBlocks.Num() == 0)
     {
-        // Collect block locations
-        TArray<FVector> BlockLocations;
-        TArray<AActor*> FirstMatchingBlocks;
-        // for (AActor* Block : MatchingBlocks)
-        for (int32 i = 0; i < 4; ++i)
-        {
-            AActor* Block = MatchingBlocks[i];
-            if (IsValid(Block))
-            {
-                FirstMatchingBlocks.Add(Block);
-                BlockLocations.Add(Block->GetActorLocation());
-                Block->Tags.Add(FName("ToGlow"));
-            }
-        }
-
-        // Store matching blocks and trigger effects
-        TargetActors = {
-            FirstMatchingBlocks,
-            0.0f,
-            Actor->GetName(),
-            BlockLocations
-        };
-        // GlowSuperDuperBlocks();
-        GlowBlocks();
-
-        return true;
+        return;
     }
 
-    return false;
+    // Store matching blocks and trigger effects; the first block's token picks the super block. Copied in place, so
+    // the arrays keep their capacity from one cluster to the next.
+    TargetActors.GlowBlocks.Reset();
+    TargetActors.GlowBlocks.Append(ClusterBlocks);
+    TargetActors.ElapsedTime = 0.0f;
+    TargetActors.TokenId = GetTokenId(ClusterBlocks[0]);
+    TargetActors.SuperBlockDropSpots.Reset();
+    TargetActors.SuperBlockDropSpots.Append(BlockLocations);
+    GlowBlocks();
 }
 
 void ATetrisGrid::MakeSuperBlock()
 {
     if (!bIsClearing)
     {
-        int32 SuperBlockIndex = FindPointValueIndexByName(*TargetActors.BlockName);
-        if (SuperBlockIndex != INDEX_NONE && SuperBlockIndex > -1 && SuperBlockIndex < SuperBlocks.Num())
+        int32 SuperBlockIndex = TargetActors.TokenId;
+        if (SuperBlocks.IsValidIndex(SuperBlockIndex))
         {
             TSubclassOf<AActor> BlockClass = SuperBlocks[SuperBlockIndex];
 
             if (BlockClass)
             {
-                FActorSpawnParameters SpawnParams;
-                SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
                 FVector WorldLocation = TargetActors.SuperBlockDropSpots[0];
-                AActor* SuperBlock = GetWorld()->SpawnActor<AActor>(BlockClass, WorldLocation, FRotator::ZeroRotator, SpawnParams);
+                AActor* SuperBlock = BlockPool->Acquire(BlockClass, WorldLocation, GetActorRotation());
                 if (SuperBlock)
                 {
                     SuperBlock->Tags.Add(FName("TetrisBlock"));
                     SuperBlock->Tags.Add(FName("SuperBlock"));
                     SuperBlock->Tags.Add(FName("CannotBlowUpYet"));
 
-                    int32 GridX = FMath::RoundToInt((WorldLocation.X + 1000.0f) / 100.0f);
-                    int32 GridY = FMath::RoundToInt(WorldLocation.Z / 100.0f);
+                    FIntPoint GridPosition = WorldToGrid(WorldLocation);
+                    int32 GridX = GridPosition.X;
+                    int32 GridY = GridPosition.Y;
 
                     SetGrid(GridX, GridY, SuperBlock);
                     SuperBlock->Tags.Add(FName("CanClearThreeRows"));
+                    RehashCell(GridX, GridY);
+                    RecordEvent(EGameplayEventType::SuperBlock, GridX, GridY, 0);
                 }
                 else
                 {
@@ -1885,10 +3221,11 @@ void ATetrisGrid::MakeSuperBlock()
         }
         else
         {
-			PrintScreen(FString::Printf(TEXT("Failed to find Super Block index!  Block name: %s"), *TargetActors.BlockName));
+			PrintScreen(FString::Printf(TEXT("Failed to find Super Block index!  Token: %d"), TargetActors.TokenId));
         }
 
         CheckForBlocksToDrop();
+        CheckForCombosIfSettled();
     }
 }
 
@@ -1898,27 +3235,25 @@ void ATetrisGrid::MakeSuperDuperBlock()
     {
         if (BombBlockClass)
         {
-            FActorSpawnParameters SpawnParams;
-            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
             FVector WorldLocation = TargetActors.SuperBlockDropSpots[0];
-            AActor* BombBlock = GetWorld()->SpawnActor<AActor>(BombBlockClass, WorldLocation, FRotator::ZeroRotator, SpawnParams);
+            AActor* BombBlock = BlockPool->Acquire(BombBlockClass, WorldLocation, GetActorRotation());
             if (BombBlock)
             {
                 BombBlock->Tags.Add(FName("BombBlock"));
                 BombBlock->Tags.Add(FName("SuperDuperBlock"));
                 BombBlock->Tags.Add(FName("CannotBlowUpYet"));
 
-                int32 GridX = FMath::RoundToInt((WorldLocation.X + 1000.0f) / 100.0f);
-                int32 GridY = FMath::RoundToInt(WorldLocation.Z / 100.0f);
+                FIntPoint GridPosition = WorldToGrid(WorldLocation);
+                int32 GridX = GridPosition.X;
+                int32 GridY = GridPosition.Y;
 
                 SetGrid(GridX, GridY, BombBlock);
                 if (GridX + 1 < GridWidth)
                 {
                     if (Grid[GridX + 1][GridY] != nullptr)
                     {
-                        FVector Loc = FVector(((GridX + 1) * 100.0f) - 1000.0f, 0.0f, GridY * 100.0f);
-                        DestroyBlockAtLocation(Loc);
+                        FVector Loc = GridToWorld(GridX + 1, GridY);
+                        DestroyBlockAtLocation(Loc, EScoreSource::SuperBlock);
                         UpdateGridAtLocation(Loc);
                     }
                     SetGrid(GridX + 1, GridY, BombBlock);
@@ -1927,8 +3262,8 @@ void ATetrisGrid::MakeSuperDuperBlock()
                 {
                     if (Grid[GridX][GridY + 1] != nullptr)
                     {
-                        FVector Loc = FVector((GridX * 100.0f) - 1000.0f, 0.0f, (GridY + 1) * 100.0f);
-                        DestroyBlockAtLocation(Loc);
+                        FVector Loc = GridToWorld(GridX, GridY + 1);
+                        DestroyBlockAtLocation(Loc, EScoreSource::SuperBlock);
                         UpdateGridAtLocation(Loc);
                     }
                     SetGrid(GridX, GridY + 1, BombBlock);
@@ -1937,22 +3272,35 @@ void ATetrisGrid::MakeSuperDuperBlock()
                 {
                     if (Grid[GridX + 1][GridY + 1] != nullptr)
                     {
-                        FVector Loc = FVector(((GridX + 1) * 100.0f) - 1000.0f, 0.0f, (GridY + 1) * 100.0f);
-                        DestroyBlockAtLocation(Loc);
+                        FVector Loc = GridToWorld(GridX + 1, GridY + 1);
+                        DestroyBlockAtLocation(Loc, EScoreSource::SuperBlock);
                         UpdateGridAtLocation(Loc);
                     }
                     SetGrid(GridX + 1, GridY + 1, BombBlock);
                 }
                 BombBlock->Tags.Add(FName("CanSuperDuper"));
+                RecordEvent(EGameplayEventType::SuperBlock, GridX, GridY, 1);
             }
         }
 
         CheckForBlocksToDrop();
+        CheckForCombosIfSettled();
+    }
+}
+
+void ATetrisGrid::CheckForCombosIfSettled()
+{
+    // With drops under way the last one checks again; otherwise clusters left over from the pass are looked for now
+    if (DropsArray.Num() == 0)
+    {
+        CheckForCombos();
     }
 }
 
 void ATetrisGrid::GlowBlocks()
 {
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Glow);
+
     if (TargetActors.GlowBlocks.Num() < 3) return; // Ensure we have at least 3 actors
 
     for (AActor* Actor : TargetActors.GlowBlocks)
@@ -1960,7 +3308,9 @@ void ATetrisGrid::GlowBlocks()
         if (Actor && IsValid(Actor) && !Actor->Tags.Contains(FName("GlowBlock")) && Actor->Tags.Contains(FName("ToGlow")))
         {
             Actor->Tags.Add(FName("GlowBlock"));
-            UStaticMeshComponent* ActorMesh = Actor->FindComponentByClass<UStaticMeshComponent>();
+
+            // Instanced blocks glow through their custom data rather than a material of their own
+            UStaticMeshComponent* ActorMesh = IsBatchingSettledBlocks() ? nullptr : Actor->FindComponentByClass<UStaticMeshComponent>();
             if (ActorMesh)
             {
                 // Get the Material from the Static Mesh Component
@@ -1970,6 +3320,7 @@ void ATetrisGrid::GlowBlocks()
                     if (!ActorMaterial->GetName().Contains("MaterialInstanceDynamic"))
                     {
                         UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(ActorMaterial, this);
+                        PerfCounters.DynamicMaterialInstances++;
                         if (DynamicMaterial)
                         {
                             ActorMesh->SetMaterial(0, DynamicMaterial);
@@ -2007,7 +3358,7 @@ void ATetrisGrid::GlowBlocks()
     }
 
     // Start glow and animation timer
-    if (GlowMaterials.Num() > 0)
+    if (GlowMaterials.Num() > 0 || IsBatchingSettledBlocks())
     {
         GlowFactorStart = 0.0f;
         GlowFactorEnd = 1.0f;
@@ -2015,12 +3366,14 @@ void ATetrisGrid::GlowBlocks()
         GlowPowerEnd = 5.0f;
         AnimationDuration = 0.25f; // Duration in seconds
 
-        GetWorldTimerManager().SetTimer(GlowTimerHandle, this, &ATetrisGrid::UpdateGlowMaterial, 0.01f, true);
+        SimTimers.SetTimer(GlowTimerHandle, this, &ATetrisGrid::UpdateGlowMaterial, 0.01f, true);
     }
 }
 
 void ATetrisGrid::GlowSuperDuperBlocks()
 {
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Glow);
+
     if (TargetActors.GlowBlocks.Num() < 4) return; // Ensure we have at least 3 actors
 
     for (AActor* Actor : TargetActors.GlowBlocks)
@@ -2028,7 +3381,9 @@ void ATetrisGrid::GlowSuperDuperBlocks()
         if (Actor && IsValid(Actor) && !Actor->Tags.Contains(FName("GlowBlock")) && Actor->Tags.Contains(FName("ToGlow")))
         {
             Actor->Tags.Add(FName("GlowBlock"));
-            UStaticMeshComponent* ActorMesh = Actor->FindComponentByClass<UStaticMeshComponent>();
+
+            // Instanced blocks glow through their custom data rather than a material of their own
+            UStaticMeshComponent* ActorMesh = IsBatchingSettledBlocks() ? nullptr : Actor->FindComponentByClass<UStaticMeshComponent>();
             if (ActorMesh)
             {
                 // Get the Material from the Static Mesh Component
@@ -2038,6 +3393,7 @@ void ATetrisGrid::GlowSuperDuperBlocks()
                     if (!ActorMaterial->GetName().Contains("MaterialInstanceDynamic"))
                     {
                         UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(ActorMaterial, this);
+                        PerfCounters.DynamicMaterialInstances++;
                         if (DynamicMaterial)
                         {
                             ActorMesh->SetMaterial(0, DynamicMaterial);
@@ -2075,7 +3431,7 @@ void ATetrisGrid::GlowSuperDuperBlocks()
     }
 
     // Start glow and animation timer
-    if (GlowMaterials.Num() > 0)
+    if (GlowMaterials.Num() > 0 || IsBatchingSettledBlocks())
     {
         GlowFactorStart = 0.0f;
         GlowFactorEnd = 1.0f;
@@ -2083,13 +3439,15 @@ void ATetrisGrid::GlowSuperDuperBlocks()
         GlowPowerEnd = 5.0f;
         AnimationDuration = 0.25f; // Duration in seconds
 
-        GetWorldTimerManager().SetTimer(GlowTimerHandle, this, &ATetrisGrid::UpdateSuperDuperGlowMaterial, 0.01f, true);
+        SimTimers.SetTimer(GlowTimerHandle, this, &ATetrisGrid::UpdateSuperDuperGlowMaterial, 0.01f, true);
     }
 }
 
 void ATetrisGrid::UpdateGlowMaterial()
 {
-    if (GlowMaterials.Num() > 0 && TargetActors.GlowBlocks.Num() > 2)
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Effects);
+
+    if ((GlowMaterials.Num() > 0 || IsBatchingSettledBlocks()) && TargetActors.GlowBlocks.Num() > 2)
     {
         // Increment elapsed time
         TargetActors.ElapsedTime += 0.01f; // Increment matches the timer interval
@@ -2098,12 +3456,12 @@ void ATetrisGrid::UpdateGlowMaterial()
         float Alpha = FMath::Clamp(TargetActors.ElapsedTime / AnimationDuration, 0.0f, 1.0f);
 
         // Update glow parameters
+        CurrentGlowFactor = FMath::Lerp(GlowFactorStart, GlowFactorEnd, Alpha);
+        CurrentGlowPower = FMath::Lerp(GlowPowerStart, GlowPowerEnd, Alpha);
         for (UMaterialInstanceDynamic* GlowMaterial : GlowMaterials)
         {
-            float GlowFactor = FMath::Lerp(GlowFactorStart, GlowFactorEnd, Alpha);
-            float GlowPower = FMath::Lerp(GlowPowerStart, GlowPowerEnd, Alpha);
-            GlowMaterial->SetScalarParameterValue(TEXT("GlowFactor"), GlowFactor);
-            GlowMaterial->SetScalarParameterValue(TEXT("GlowPower"), GlowPower);
+            GlowMaterial->SetScalarParameterValue(TEXT("GlowFactor"), CurrentGlowFactor);
+            GlowMaterial->SetScalarParameterValue(TEXT("GlowPower"), CurrentGlowPower);
         }
 
         // Update scales and locations
@@ -2128,24 +3486,28 @@ void ATetrisGrid::UpdateGlowMaterial()
         if (Alpha >= 1.0f)
         {
             GlowMaterials.Empty();
+            CurrentGlowFactor = 0.0f;
+            CurrentGlowPower = 1.0f;
 
             // for (AActor* GlowBlockActor : TargetActors.GlowBlocks)
             for (int32 g = 0; g < TargetActors.GlowBlocks.Num(); ++g)
             {
-                DestroyBlockAtLocation(TargetActors.SuperBlockDropSpots[g]);
+                DestroyBlockAtLocation(TargetActors.SuperBlockDropSpots[g], EScoreSource::SuperBlock);
                 UpdateGridAtLocation(TargetActors.SuperBlockDropSpots[g]);
             }
 
-            TargetActors.GlowBlocks.Empty();
+            TargetActors.GlowBlocks.Reset();
             MakeSuperBlock();
-            GetWorldTimerManager().ClearTimer(GlowTimerHandle);
+            SimTimers.ClearTimer(GlowTimerHandle);
         }
     }
 }
 
 void ATetrisGrid::UpdateSuperDuperGlowMaterial()
 {
-    if (GlowMaterials.Num() > 0 && TargetActors.GlowBlocks.Num() > 2)
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Effects);
+
+    if ((GlowMaterials.Num() > 0 || IsBatchingSettledBlocks()) && TargetActors.GlowBlocks.Num() > 2)
     {
         // Increment elapsed time
         TargetActors.ElapsedTime += 0.01f; // Increment matches the timer interval
@@ -2154,12 +3516,12 @@ void ATetrisGrid::UpdateSuperDuperGlowMaterial()
         float Alpha = FMath::Clamp(TargetActors.ElapsedTime / AnimationDuration, 0.0f, 1.0f);
 
         // Update glow parameters
+        CurrentGlowFactor = FMath::Lerp(GlowFactorStart, GlowFactorEnd, Alpha);
+        CurrentGlowPower = FMath::Lerp(GlowPowerStart, GlowPowerEnd, Alpha);
         for (UMaterialInstanceDynamic* GlowMaterial : GlowMaterials)
         {
-            float GlowFactor = FMath::Lerp(GlowFactorStart, GlowFactorEnd, Alpha);
-            float GlowPower = FMath::Lerp(GlowPowerStart, GlowPowerEnd, Alpha);
-            GlowMaterial->SetScalarParameterValue(TEXT("GlowFactor"), GlowFactor);
-            GlowMaterial->SetScalarParameterValue(TEXT("GlowPower"), GlowPower);
+            GlowMaterial->SetScalarParameterValue(TEXT("GlowFactor"), CurrentGlowFactor);
+            GlowMaterial->SetScalarParameterValue(TEXT("GlowPower"), CurrentGlowPower);
         }
 
         // Update scales and locations
@@ -2184,17 +3546,19 @@ void ATetrisGrid::UpdateSuperDuperGlowMaterial()
         if (Alpha >= 1.0f)
         {
             GlowMaterials.Empty();
+            CurrentGlowFactor = 0.0f;
+            CurrentGlowPower = 1.0f;
 
             // for (AActor* GlowBlockActor : TargetActors.GlowBlocks)
             for (int32 g = 0; g < TargetActors.GlowBlocks.Num(); ++g)
             {
-                DestroyBlockAtLocation(TargetActors.SuperBlockDropSpots[g]);
+                DestroyBlockAtLocation(TargetActors.SuperBlockDropSpots[g], EScoreSource::SuperBlock);
                 UpdateGridAtLocation(TargetActors.SuperBlockDropSpots[g]);
             }
 
-            TargetActors.GlowBlocks.Empty();
+            TargetActors.GlowBlocks.Reset();
             MakeSuperDuperBlock();
-            GetWorldTimerManager().ClearTimer(GlowTimerHandle);
+            SimTimers.ClearTimer(GlowTimerHandle);
         }
     }
 }
@@ -2228,6 +3592,8 @@ void ATetrisGrid::ScaleAndMoveActors(AActor* Actor1, AActor* Actor2, AActor* Act
 
 void ATetrisGrid::SpawnNiagaraSystem(FString Source, FVector SpawnLoc, FLinearColor ExplosionColor1, FLinearColor ExplosionColor2)
 {
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Effects);
+
     UNiagaraSystem* NiagaraSystem = LoadObject<UNiagaraSystem>(nullptr, *Source);
 
     if (NiagaraSystem)
@@ -2238,6 +3604,8 @@ void ATetrisGrid::SpawnNiagaraSystem(FString Source, FVector SpawnLoc, FLinearCo
         
         if (NiagaraComponent)
         {
+            TrackNiagaraComponent(NiagaraComponent);
+
             // Set the user parameter on the Niagara component
             NiagaraComponent->SetVariableLinearColor(TEXT("User.ExplosionColor1"), ExplosionColor1);
             NiagaraComponent->SetVariableLinearColor(TEXT("User.ExplosionColor2"), ExplosionColor2);
@@ -2248,9 +3616,12 @@ void ATetrisGrid::SpawnNiagaraSystem(FString Source, FVector SpawnLoc, FLinearCo
 void ATetrisGrid::ClearThreeRows(int32 RowIndex)
 {
     PrintScreen("running clear three rows");
-    if (LaserBurstCue)
+    Presentation.RequestSound(LaserBurstCue);
+
+    // Versus: a super block blast sends the opponent an SEC row
+    if (VersusOpponent)
     {
-        UGameplayStatics::PlaySoundAtLocation(this, LaserBurstCue, GetActorLocation());
+        VersusOpponent->SpawnDeadlySecRow();
     }
 
     // Ensure the row index is within bounds
@@ -2287,8 +3658,8 @@ void ATetrisGrid::ClearThreeRows(int32 RowIndex)
                 AActor* GridBlock = Grid[x][y];
                 if (GridBlock->Tags.Contains(FName("Destroy")))
                 {
-                    DestroyBlockAtLocation(FVector((x * 100.0f) - 1000.0f, 0.0f, y * 100.0f));
-                    UpdateGridAtLocation(FVector((x * 100.0f) - 1000.0f, 0.0f, y * 100.0f));
+                    DestroyBlockAtLocation(GridToWorld(x, y), EScoreSource::ThreeRowClear);
+                    UpdateGridAtLocation(GridToWorld(x, y));
                 }
             }
         }
@@ -2297,8 +3668,8 @@ void ATetrisGrid::ClearThreeRows(int32 RowIndex)
 
 void ATetrisGrid::FreezeTimeForHackerMode()
 {
-    // Freeze time by setting the global time dilation to zero
-    UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 0.0f);
+    // Only the board's simulation stops; widgets, effects and audio keep running
+    SimClock.Pause();
 
     // Log the action for debugging purposes
     UE_LOG(LogTemp, Log, TEXT("Time has been frozen for Hacker Mode."));
@@ -2306,8 +3677,7 @@ void ATetrisGrid::FreezeTimeForHackerMode()
 
 void ATetrisGrid::ResumeTime()
 {
-    // Resume time by setting the global time dilation back to one
-    UGameplayStatics::SetGlobalTimeDilation(GetWorld(), 1.0f);
+    SimClock.Resume();
 
     // Log the action for debugging purposes
     UE_LOG(LogTemp, Log, TEXT("Time has been resumed."));
@@ -2328,13 +3698,16 @@ void ATetrisGrid::SpawnOfficerTetromino()
         {
             if (SecClass)
             {
-                for (int32 i = 0; i < NextTetrominoShape.BlockOffsets.Num(); ++i)
+                RecordRewindFrame();
+                const FUpcomingPiece Piece = PopUpcomingPiece();
+
+                for (int32 i = 0; i < Piece.BlockOffsets.Num(); ++i)
                 {
-                    FVector2D Offset = NextTetrominoShape.BlockOffsets[i];
+                    FVector2D Offset = Piece.BlockOffsets[i];
                     TSubclassOf<AActor> TetrominoBlueprint = SecClass;
 
-                    FVector BlockLocation = SpawnLocation + FVector(Offset.X * 100.0f, 0.0f, Offset.Y * 100.0f);
-                    AActor* Block = World->SpawnActor<AActor>(TetrominoBlueprint, BlockLocation, FRotator::ZeroRotator);
+                    FVector BlockLocation = BoardToWorld(SpawnLocation + FVector(Offset.X * CellSize, 0.0f, Offset.Y * CellSize));
+                    AActor* Block = BlockPool->Acquire(TetrominoBlueprint, BlockLocation, GetActorRotation());
 
                     if (Block)
                     {
@@ -2342,25 +3715,6 @@ void ATetrisGrid::SpawnOfficerTetromino()
                         CurrentTetrominoBlocks.Add(Block);
                     }
                 }
-
-                if (RoundsLeftBeforeSecSpawn != 1)
-                {
-                    for (AActor* NextBlock : NextTetrominoBlocks)
-                    {
-                        NextBlock->Destroy();
-                    }
-                    NextTetrominoBlocks.Empty();
-                    PrepareNextTetromino();
-                }
-                else
-                {
-                    for (AActor* NextBlock : NextTetrominoBlocks)
-                    {
-                        NextBlock->Destroy();
-                    }
-                    NextTetrominoBlocks.Empty();
-                    PrepareOfficerTetromino();
-                }
             }
         }
     }
@@ -2378,8 +3732,7 @@ void ATetrisGrid::ClearOfficerBlocks()
             {
                 if (GridActor->Tags.Contains(FName("OfficerBlock")))
                 {
-                    GridActor->Destroy();
-                    SetGrid(x, y, nullptr);
+                    ReleaseGridBlock(x, y);
                     OfficerBlockCount++;
                 }
             }
@@ -2389,20 +3742,34 @@ void ATetrisGrid::ClearOfficerBlocks()
     UE_LOG(LogTemp, Warning, TEXT("Cleared out %d officer blocks"), OfficerBlockCount);
     CheckForBlocksToDrop();
     Combos = 0;
+    MarkNotchesChanged();
 }
 
 void ATetrisGrid::UpdateComboTarget()
 {
-    int32 targetIndex = FMath::RandRange(0, PointValues.Num() - 1);
-    ComboTarget = PointValues[targetIndex].BlockName + "_circ";
+    ComboTargetToken = BoardRandom.RandRange(0, PointValues.Num() - 1);
+    ComboTarget = GetComboTargetName();
+}
+
+FString ATetrisGrid::GetComboTargetName() const
+{
+    return PointValues.IsValidIndex(ComboTargetToken) ? PointValues[ComboTargetToken].BlockName + TEXT("_circ") : FString();
+}
+
+UTexture2D* ATetrisGrid::GetComboTargetTexture() const
+{
+    return PointValues.IsValidIndex(ComboTargetToken) ? PointValues[ComboTargetToken].StockTickerTexture : nullptr;
 }
 
 void ATetrisGrid::SpawnRowClearEffect(FVector SpawnPoint, FLinearColor Color)
 {
+    LLM_SCOPE_BYTAG(BlockchainBreakout_Effects);
+
+    const float LocalZ = GetActorTransform().InverseTransformPosition(SpawnPoint).Z;
     StartLocationRight = SpawnPoint;
-    EndLocationRight = FVector(450.0f, 0.0f, SpawnPoint.Z);
+    EndLocationRight = BoardToWorld(FVector(450.0f, 0.0f, LocalZ));
     StartLocationLeft = SpawnPoint;
-    EndLocationLeft = FVector(-1050.0f, 0.0f, SpawnPoint.Z);
+    EndLocationLeft = BoardToWorld(FVector(-1050.0f, 0.0f, LocalZ));
     Duration = 0.5f;
     ElapsedTimeLeft = 0.0f;
     ElapsedTimeRight = 0.0f;
@@ -2411,8 +3778,8 @@ void ATetrisGrid::SpawnRowClearEffect(FVector SpawnPoint, FLinearColor Color)
 
     if (NiagaraSystem)
     {
-        FRotator SpawnRotationLeft = FRotator(0.0f, -90.0f, 0.0f);
-        FRotator SpawnRotationRight = FRotator(0.0f, 90.0f, 0.0f);
+        FRotator SpawnRotationLeft = (GetActorQuat() * FRotator(0.0f, -90.0f, 0.0f).Quaternion()).Rotator();
+        FRotator SpawnRotationRight = (GetActorQuat() * FRotator(0.0f, 90.0f, 0.0f).Quaternion()).Rotator();
 
         UNiagaraComponent* NiagaraComponentLeft = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), NiagaraSystem, StartLocationLeft, SpawnRotationLeft);
         UNiagaraComponent* NiagaraComponentRight = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), NiagaraSystem, StartLocationRight, SpawnRotationRight);
@@ -2429,6 +3796,8 @@ void ATetrisGrid::SpawnRowClearEffect(FVector SpawnPoint, FLinearColor Color)
 
         RowNiagaraComponentLeft = NiagaraComponentLeft;
         RowNiagaraComponentRight = NiagaraComponentRight;
+        TrackNiagaraComponent(NiagaraComponentLeft);
+        TrackNiagaraComponent(NiagaraComponentRight);
     }
 
     GetWorldTimerManager().SetTimer(LerpTimerHandle, this, &ATetrisGrid::UpdateNiagaraLocation, 0.01f, true);
@@ -2436,6 +3805,8 @@ void ATetrisGrid::SpawnRowClearEffect(FVector SpawnPoint, FLinearColor Color)
 
 void ATetrisGrid::UpdateNiagaraLocation()
 {
+    FScopedBoardStage StageScope(PerfCounters, EBoardStage::Effects);
+
     float DistanceLeft = FVector::Distance(StartLocationLeft, EndLocationLeft);
     float DistanceRight = FVector::Distance(StartLocationRight, EndLocationRight);
     float SpeedLeft = 1000.0f;
@@ -2482,28 +3853,53 @@ void ATetrisGrid::PrintScreen(FString message, float showDuration)
     }
 }
 
-void ATetrisGrid::IncrementScore(int32 NewScore)
+void ATetrisGrid::AddScore(EScoreSource Source, int32 Value)
 {
+    ScoreLedger.Add(Source, Value);
+}
+
+void ATetrisGrid::CommitScore()
+{
+    if (!ScoreLedger.HasPending())
+    {
+        return;
+    }
+
     int maxInt32 = std::numeric_limits<int>::max();
 
-    Score = FMath::Clamp(NewScore, 0, maxInt32 - 1);
+    Score = (int32)FMath::Clamp<int64>((int64)Score + ScoreLedger.Commit(), 0, maxInt32 - 1);
 
-    if (Score >= CurrentLevel.TargetScore)
+    // Evaluated once per commit, outside any pass that is still walking the grid
+    if (Score >= CurrentLevel.TargetScore && !bIsClearing)
     {
 		SetVictoryBoardMaterial(0.0f, CurrentLevel.BackgroundColor, 1.0f);
 
-        GetWorld()->GetTimerManager().SetTimer(VictoryTimerHandle, this, &ATetrisGrid::BlinkBoardColors, 0.2f, true, 2.0f);
+        SimTimers.SetTimer(VictoryTimerHandle, this, &ATetrisGrid::BlinkBoardColors, 0.2f, true, 2.0f);
 
         ClearBoard();
+        WarmUpNextLevel();
     }
 
-    OnUpdateScore.Broadcast();
+    MarkScoreChanged();
+}
+
+TMap<EScoreSource, int32> ATetrisGrid::GetScoreBreakdown() const
+{
+    int maxInt32 = std::numeric_limits<int>::max();
+
+    TMap<EScoreSource, int32> Breakdown;
+    for (int32 i = 0; i < FScoreLedger::NumSources; i++)
+    {
+        const EScoreSource Source = (EScoreSource)i;
+        Breakdown.Add(Source, (int32)FMath::Min<int64>(ScoreLedger.GetLevelTotal(Source), maxInt32 - 1));
+    }
+    return Breakdown;
 }
 
 void ATetrisGrid::BlinkBoardColors()
 {
-    GetWorld()->GetTimerManager().ClearTimer(VictoryTimerHandle);
-    GetWorld()->GetTimerManager().SetTimer(BlinkBoardTimerHandle, this, &ATetrisGrid::Blink, 0.2f, true, 0.0f);
+    SimTimers.ClearTimer(VictoryTimerHandle);
+    SimTimers.SetTimer(BlinkBoardTimerHandle, this, &ATetrisGrid::Blink, 0.2f, true, 0.0f);
 }
 
 void ATetrisGrid::Blink()
@@ -2527,7 +3923,7 @@ void ATetrisGrid::Blink()
 
     if (ElapsedBlinking >= BlinkDuration)
     {
-        GetWorld()->GetTimerManager().ClearTimer(BlinkBoardTimerHandle);
+        SimTimers.ClearTimer(BlinkBoardTimerHandle);
         ElapsedBlinking = 0.0f;
 
         NextLevel();
@@ -2569,31 +3965,75 @@ void ATetrisGrid::SetVictoryBoardMaterial(float ColorPickerValue, FVector Backgr
 
 void ATetrisGrid::ClearBoard()
 {
+    // Hidden now, handed back to the pool over the next frames
+    TArray<AActor*> Released = MoveTemp(CurrentTetrominoBlocks);
+    CurrentTetrominoBlocks.Reset();
+
     for (int32 x = 0; x < GridWidth; ++x)
     {
         for (int32 y = 0; y < GridHeight; ++y)
         {
             if (Grid[x][y] != nullptr)
             {
-                Grid[x][y]->Destroy();
-                Grid[x][y] = nullptr;
+                Released.AddUnique(Grid[x][y]);
+                SetGrid(x, y, nullptr);
             }
         }
     }
 
-    for (AActor* Block : CurrentTetrominoBlocks)
+    BlockPool->ReleaseGradually(Released);
+
+    UpcomingPieces.Empty();
+    bPreviewUpToDate = false;
+
+    // Nothing left for these to refer to
+    SimTimers.ClearTimer(GlowTimerHandle);
+    SimTimers.ClearTimer(DropTimerHandle);
+    GlowMaterials.Empty();
+    CurrentGlowFactor = 0.0f;
+    CurrentGlowPower = 1.0f;
+    TargetActors.GlowBlocks.Empty();
+    BlocksToDrop.Empty();
+    BlocksToMove.Empty();
+    DropsArray.Empty();
+    bAnyDropInProgress = false;
+
+    bIsClearing = true;
+}
+
+void ATetrisGrid::WarmUpNextLevel()
+{
+    const FLevelData& NextLevelData = LevelsDataTable[FMath::Clamp(CurrentLevelIndex + 1, 0, LevelsDataTable.Num() - 1)];
+
+    // Enough of every token for the opening pieces; the pool grows on demand after that
+    for (const TSubclassOf<AActor>& TokenClass : TetrominoBlueprints)
     {
-        Block->Destroy();
+        BlockPool->Prewarm(TokenClass, PrewarmBlocksPerToken);
     }
-    CurrentTetrominoBlocks.Empty();
+    BlockPool->Prewarm(SecClass, GridWidth);
 
-    for (AActor* NextBlock : NextTetrominoBlocks)
+    // Super blocks form at pairing set 3 and below, bombs at 4 and below; have a few ready before the first one
+    if (NextLevelData.BlockPairingSet <= 3)
+    {
+        for (const TSubclassOf<AActor>& SuperBlockClass : SuperBlocks)
+        {
+            BlockPool->Prewarm(SuperBlockClass, 2);
+        }
+    }
+    if (NextLevelData.BlockPairingSet <= 4)
     {
-        NextBlock->Destroy();
+        BlockPool->Prewarm(BombBlockClass, 2);
     }
-    NextTetrominoBlocks.Empty();
 
-    bIsClearing = true;
+    // Load the effects now rather than on the first clear of the new level
+    WarmAssets.Reset();
+    for (const TCHAR* Path : { TEXT("/Game/VFX/NS_Explosion"), TEXT("/Game/VFX/NS_Row_Clear_Effect") })
+    {
+        if (UNiagaraSystem* System = LoadObject<UNiagaraSystem>(nullptr, Path))
+        {
+            WarmAssets.Add(System);
+        }
+    }
 }
 
 void ATetrisGrid::NextLevel()
@@ -2603,39 +4043,33 @@ void ATetrisGrid::NextLevel()
     DefaultFallInterval = CurrentLevel.FallingSpeed;
     bIsClearing = false;
     Score = 0;
-    OnUpdateScore.Broadcast();
+    ScoreLedger.Reset();
+    MarkScoreChanged();
+    RecordEvent(EGameplayEventType::LevelChange, CurrentLevelIndex);
 
     RoundsLeftBeforeSecSpawn = RoundsBeforeSecSpawn;
 	SetVictoryBoardMaterial(0.0f, CurrentLevel.BackgroundColor, 0.0f);
     CurrentColorPickerValue = 0.0f;
-    PrepareNextTetromino();
+    RefillUpcomingPieces();
     SpawnTetromino();
 }
 
 void ATetrisGrid::SpawnBombExplosion(AActor* Actor)
 {
-    TArray<FVector> ExplosionOffsets = {
-        FVector(100.0f, 0.0f, 0.0f),   // Right
-        FVector(-100.0f, 0.0f, 0.0f),  // Left
-        FVector(0.0f, 0.0f, 100.0f),   // Up
-        FVector(0.0f, 0.0f, -100.0f),  // Down
-        FVector(100.0f, 0.0f, 100.0f),   // Top Right
-        FVector(-100.0f, 0.0f, 100.0f),  // Top Left
-        FVector(100.0f, 0.0f, -100.0f),  // Bottom Right
-        FVector(-100.0f, 0.0f, -100.0f)  // Bottom Left
-    };
-
     FVector Token1Location = Actor->GetActorLocation();
 
+    const FIntPoint BombCell = WorldToGrid(Token1Location);
+    RecordEvent(EGameplayEventType::Explosion, BombCell.X, BombCell.Y, 1);
+
     // Destroy high-value tokens and update grid
-    DestroyBlockAtLocation(Token1Location);
+    DestroyBlockAtLocation(Token1Location, EScoreSource::Bomb);
 
     // Trigger explosion effects at adjacent blocks
     for (const FVector& Offset : ExplosionOffsets)
     {
-        FVector ExplosionLocation1 = Token1Location + Offset;
+        FVector ExplosionLocation1 = Token1Location + GetActorTransform().TransformVector(Offset);
 
-        FVector2D GridLocation = FVector2D((ExplosionLocation1.X + 1000.0f) / 100.0f, ExplosionLocation1.Z / 100.0f);
+        FIntPoint GridLocation = WorldToGrid(ExplosionLocation1);
         if (GridLocation.X >= 0 && GridLocation.X < GridWidth && GridLocation.Y >= 0 && GridLocation.Y < GridHeight)
         {
             if (Grid[GridLocation.X][GridLocation.Y] != nullptr)
@@ -2647,15 +4081,8 @@ void ATetrisGrid::SpawnBombExplosion(AActor* Actor)
                 }
             }
         }
-
-        APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
-        if (PlayerController && CameraShakeClass.IsValid())
-        {
-            UClass* LoadedCameraShakeClass = CameraShakeClass.Get();
-            PlayerController->ClientStartCameraShake(LoadedCameraShakeClass);
-        }
-        PrintScreen("SPLODE!");
-
-        // SpawnNiagaraSystem(TEXT("/Game/VFX/NS_Explosion"), (Token1Location + Token2Location) / 2.0f, ExplosionColor1, ExplosionColor2);
     }
+
+    Presentation.RequestCameraShake();
+    PrintScreen("SPLODE!");
 }
@@ -18,9 +18,39 @@
 #include "DropState.h"
 #include "GlowBlockAnimationData.h"
 #include "LevelData.h"
+#include "HistoricalPriceStream.h"
+#include "MarketEngine.h"
+#include "BoardUIDelta.h"
+#include "ScoreLedger.h"
+#include "BoardAudioService.h"
+#include "PresentationCommandBuffer.h"
+#include "GameplayEventLog.h"
+#include "BoardPerfCounters.h"
+#include "BoardPerfHUDWidget.h"
+#include "BoardSoakMonitor.h"
+#include "PiecePreview.h"
+#include "NextPiecePreviewWidget.h"
+#include "BlockPoolComponent.h"
+#include "BoardBlockInstances.h"
+#include "BoardStateQuad.h"
+#include "TokenBitPlanes.h"
+#include "BoardEvaluation.h"
+#include "TokenRegistry.h"
+#include "BoardInputQueue.h"
+#include "SimulationClock.h"
+#include "BoardRewindBuffer.h"
+#include "BreakoutSimulation.h"
+#include "BoardNetState.h"
+#include "BoardZobrist.h"
+#include "BoardFrameArena.h"
+#include "Engine/StreamableManager.h"
+#include "Tasks/Task.h"
 
 #include "TetrisGrid.generated.h"
 
+class UInputAction;
+class UInputMappingContext;
+
 UENUM(BlueprintType)
 enum class EMarketEvent : uint8
 {
@@ -36,6 +66,7 @@ class BLOCKCHAINBREAKOUTT_API ATetrisGrid : public APawn
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     // Sets default values for this actor's properties
@@ -46,6 +77,8 @@ public:
     DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnUpdateUI);
     DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnUpdateScore);
     DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnUpdateNotches);
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBoardUIDelta, const FBoardUIDelta&, Delta);
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnBoardUIDeltaNative, const FBoardUIDelta&);
 
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnUpdateUI OnUpdateUI;
@@ -56,14 +89,30 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Events")
     FOnUpdateNotches OnUpdateNotches;
 
+    // Fired at most once per frame with only what changed; the three events above fire alongside it for the parts they cover
+    UPROPERTY(BlueprintAssignable, Category = "Events")
+    FOnBoardUIDelta OnBoardUIDelta;
+
+    FOnBoardUIDeltaNative OnBoardUIDeltaNative;
+
     // end delegate binding
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tetromino Shapes")
     TArray<FTetrominoShape> TetrominoShapes;
 
+    // The seven shapes the game ships with; block 0 is the rotation pivot
+    static void AddDefaultTetrominoShapes(TArray<FTetrominoShape>& OutShapes);
+
+    // This board's rules for one level, for the headless balance runs (-run=BreakoutSim)
+    void FillSimulationConfig(int32 LevelIndex, const UTokenRegistry& Registry, FBreakoutSimConfig& OutConfig) const;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Point Values")
     TArray<FTetrisBlockValue> PointValues;
 
+    // Coins this board deals; the built-in seven when unset
+    UPROPERTY(EditAnywhere, Category = "Point Values")
+    TSoftObjectPtr<UTokenRegistry> TokenRegistryAsset;
+
     virtual void Tick(float DeltaTime) override;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tetris")
@@ -75,13 +124,42 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tetris")
     TSubclassOf<AActor> TetrisBlockBP;
 
+    // How many upcoming pieces the preview shows (1-5); thumbnails are cached, so more costs no more per piece
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Preview", meta = (ClampMin = "1", ClampMax = "5"))
+    int32 PreviewQueueLength = 1;
+
+    UPROPERTY(EditAnywhere, Category = "Preview")
+    TSubclassOf<UNextPiecePreviewWidget> NextPiecePreviewClass;
+
+    // Icon drawn for SEC blocks in the preview; token blocks use their StockTickerTexture
+    UPROPERTY(EditAnywhere, Category = "Preview")
+    UTexture2D* OfficerPreviewIcon;
+
+    // Disable on extra boards (attract mode, bots, versus) so only one board takes the first player
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tetris")
+    bool bPossessFirstPlayer = true;
+
+    // Versus: the board that gets this one's garbage rows (rows cleared at once past the first) and SEC raids
+    // (super block blasts); set by ABreakoutVersusGameMode
+    UPROPERTY(Replicated, BlueprintReadOnly, Category = "Versus")
+    ATetrisGrid* VersusOpponent;
+
+    // Pushes Rows garbage rows in from the bottom before the next piece is dealt
+    void ReceiveGarbageRows(int32 Rows);
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
     UFUNCTION(BlueprintCallable, Category = "Tetris")
     void SpawnTetromino();
 
-    UPROPERTY(BlueprintReadWrite, Category = "Score")
+    UPROPERTY(BlueprintReadWrite, ReplicatedUsing = OnRep_Score, Category = "Score")
     int32 Score;
 
-    UPROPERTY(BlueprintReadWrite, Category = "Combos")
+    // Score earned this level, per source
+    UFUNCTION(BlueprintCallable, Category = "Score")
+    TMap<EScoreSource, int32> GetScoreBreakdown() const;
+
+    UPROPERTY(BlueprintReadWrite, ReplicatedUsing = OnRep_Combos, Category = "Combos")
     int32 Combos;
 
     UPROPERTY(EditAnywhere, Category = "Tetromino Blueprints")
@@ -115,6 +193,30 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effects")
     TSoftClassPtr<UCameraShakeBase> CameraShakeClass;
 
+    // Most particle systems started in one frame; nearby requests for the same effect are merged before this applies
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effects")
+    int32 MaxVfxPerFrame = 6;
+
+    // gameplay cues play through pooled voices; see RegisterAudioCues for the per-cue limits
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio")
+    UBoardAudioService* AudioService;
+
+    // block actors are recycled instead of spawned and destroyed; see WarmUpNextLevel
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Blocks")
+    UBlockPoolComponent* BlockPool;
+
+    // settled blocks drawn as instances of one master material; see UBoardBlockInstances
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Blocks")
+    UBoardBlockInstances* BlockInstances;
+
+    // the settled board as one quad over a cell texture; wins over BlockInstances when both are on
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Blocks")
+    UBoardStateQuad* BoardStateQuad;
+
+    // Hidden blocks of each token made ready during the victory blink
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Blocks")
+    int32 PrewarmBlocksPerToken = 24;
+
     UPROPERTY(BlueprintReadOnly, Category = "Audio")
     USoundBase* NudgeCue;
 
@@ -153,39 +255,200 @@ public:
 
     void CheckAndClearFullRows();
     void ClearRow(int32 y);
+    // Empties the cell, and every other cell of a bomb, before the block goes back to the pool
+    void ReleaseGridBlock(int32 x, int32 y);
     void MoveRowsDown(int32 ClearedRow);
-    void MoveTetrominoLeft();
-    void MoveTetrominoRight();
+    bool MoveTetrominoLeft();
+    bool MoveTetrominoRight();
     std::tuple<bool, TArray<FVector2D>> CanRotateTetromino(AActor* PivotBlock);
-    void RotateTetromino();
+    bool RotateTetromino();
     void StartFastDrop();
     void StopFastDrop();
 
+    // Enhanced Input; when the mapping context is unset one is built at runtime from the actions below
+    // (created too if unset) with A/Left, D/Right, W/Up and S/Down
+    UPROPERTY(EditAnywhere, Category = "Input")
+    UInputMappingContext* BoardMappingContext;
+
+    UPROPERTY(EditAnywhere, Category = "Input")
+    UInputAction* MoveLeftAction;
+
+    UPROPERTY(EditAnywhere, Category = "Input")
+    UInputAction* MoveRightAction;
+
+    UPROPERTY(EditAnywhere, Category = "Input")
+    UInputAction* RotateAction;
+
+    UPROPERTY(EditAnywhere, Category = "Input")
+    UInputAction* SoftDropAction;
+
+    // Seconds a direction is held before it starts repeating (DAS)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (ClampMin = "0"))
+    float AutoShiftDelay = 0.167f;
+
+    // Seconds between repeats once repeating (ARR); 0 slides to the wall at once
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input", meta = (ClampMin = "0"))
+    float AutoRepeatRate = 0.033f;
+
     void UpdateMarketValues();
     void UpdateMarketEvents();
     int MarketEventsInterval;
 
+    // Seconds between market ticks; the engine is cheap enough to run every frame
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market")
+    float MarketTickInterval = 1.0f;
+
+    // Half-width of each token's per-tick random move (0.2 = x0.8 to x1.2)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market")
+    float MarketVolatility = 0.2f;
+
+    // Correlated per-tick drift applied to every token (scaled by its beta) during Bull Run (+) and Crypto Crash (-)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market")
+    float MarketEventDrift = 0.02f;
+
+    // Extra synthetic tokens for profiling the market engine; 0 in normal play
+    UPROPERTY(EditAnywhere, Category = "Market")
+    int32 MarketStressTokenCount = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Market")
+    float LastMarketTickMicroseconds = 0.0f;
+
+    // Record gameplay events to Saved/Logs/GameplayEvents-<time>.bbev; also enabled by -GameplayEventLog on the command line
+    UPROPERTY(EditAnywhere, Category = "Diagnostics")
+    bool bRecordGameplayEvents = false;
+
+    // Widget used by ToggleBoardPerfHUD; defaults to the plain text overlay
+    UPROPERTY(EditAnywhere, Category = "Diagnostics")
+    TSubclassOf<UBoardPerfHUDWidget> PerfHUDClass;
+
+    // Rebuilds the board hash from scratch at every lock and logs any drift from the running one
+    UPROPERTY(EditAnywhere, Category = "Diagnostics")
+    bool bCheckBoardHash = false;
+
+    // 64-bit Zobrist hash of the settled cells, the falling piece and the market's price buckets; the same
+    // position hashes the same on every machine. Also written to the gameplay event log after every lock.
+    uint64 GetBoardHash() const;
+
+    // Shows or hides the stage timing overlay (console: ToggleBoardPerfHUD)
+    UFUNCTION(Exec, BlueprintCallable, Category = "Diagnostics")
+    void ToggleBoardPerfHUD();
+
+    const FBoardPerfSnapshot& GetPerfSnapshot() const { return PerfSnapshot; }
+
+    // Plays Pieces pieces with random input, sped up, and fails if object or memory counts grow without bound.
+    // Also started by -BoardSoak=<pieces> on the command line; add -BoardSoakExit to quit with the result as exit code.
+    // Input is random from Seed (0 picks one and logs it; -BoardSoakSeed=<seed> on the command line).
+    UFUNCTION(Exec, BlueprintCallable, Category = "Diagnostics")
+    void StartBoardSoak(int32 Pieces = 10000, int32 Seed = 0);
+
+    // A board soak that also replays every lock in FBreakoutSimulation and fails if the board settles to a different
+    // cells hash than the simulation predicted. Also started by adding -BoardSoakParity to -BoardSoak=<pieces>.
+    UFUNCTION(Exec, BlueprintCallable, Category = "Diagnostics")
+    void StartSimulationParityCheck(int32 Pieces = 200, int32 Seed = 0);
+
+    // Puts a live bomb in the empty bottom-left corner and soft-drops the piece onto the board; fails unless the
+    // bomb goes off, leaves no cell behind and the next piece is dealt. Also started by -BoardBombCheck.
+    UFUNCTION(Exec, BlueprintCallable, Category = "Diagnostics")
+    void StartBombCheck();
+
+    UPROPERTY(EditAnywhere, Category = "Diagnostics")
+    bool bCheckSimulationParity = false;
+
+    UPROPERTY(EditAnywhere, Category = "Diagnostics")
+    float SoakTimeDilation = 8.0f;
+
+    // historical replay: token prices follow recorded series instead of the random walk
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market Replay")
+    bool bUseHistoricalReplay = false;
+
+    // Folder under Content holding one "<blockname>.bin" or "<blockname>.csv" series per token
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market Replay")
+    FString HistoricalDataDirectory = TEXT("HistoricalData");
+
+    // Historical seconds played back per game second
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Market Replay")
+    float ReplaySpeed = 60.0f;
+
+    // Samples buffered per token; the rest of the series stays on disk
+    UPROPERTY(EditAnywhere, Category = "Market Replay")
+    int32 ReplayRingCapacity = 4096;
+
+    UFUNCTION(BlueprintCallable, Category = "Market Replay")
+    void SeekHistoricalReplay(FDateTime Time);
+
     EMarketEvent CurrentMarketEvent = EMarketEvent::None;
 
     // handle powerups and chain reactions
     void TriggerExplosion(AActor* HighValueToken1, AActor* HighValueToken2, FLinearColor ExplosionColor1, FLinearColor ExplosionColor2);
-    void DestroyBlockAtLocation(FVector Location);
-    bool CheckForHorizontalExplosions(AActor* Actor);
-    bool CheckForVerticalExplosions(AActor* Actor);
-    bool CheckForExplosions(AActor* Actor, FVector Direction);
-    bool CheckForSuperBlockFormation(AActor* Actor);
-    bool CheckForSuperDuperBlockFormation(AActor* Actor);
+    void DestroyBlockAtLocation(FVector Location, EScoreSource ScoreSource = EScoreSource::Other);
+    bool TriggerPairExplosions(const TArray<FTokenPair>& Pairs);
+    void FormCluster(const FBoardCluster& Cluster);
     void CheckForCombos();
 
+    // Combo rules and market ticks run as tasks on copies of the state; results are applied from Tick
+    UE::Tasks::TTask<FBoardEvaluation> ComboTask;
+    UE::Tasks::TTask<FMarketTickResult> MarketTask;
+    uint64 CurrentSimStep = 0;
+    uint64 ComboTaskDueStep = 0;
+    uint64 MarketTaskDueStep = 0;
+    uint32 BoardGeneration = 0; // bumped by every SetGrid
+    bool bBlockInstancesStale = true; // set by every RehashCell, so tag changes count too
+    bool bComboPassFoundCombo = false;
+    void LaunchComboEvaluation();
+    void ApplyComboEvaluation(const FBoardEvaluation& Evaluation);
+    void ApplyMarketTick(FMarketTickResult& Result);
+    void ApplyRuleTasks();
+
     TArray<TSubclassOf<AActor>> SuperBlocks;
 
     UFUNCTION(BlueprintCallable, Category = "HackerMode")
     void FreezeTimeForHackerMode();
     UFUNCTION(BlueprintCallable, Category = "HackerMode")
     void ResumeTime();
+
+    // Gravity, drops, glows, market ticks and level flow all run on this clock in fixed steps; UI, VFX and audio stay on world time
+    UPROPERTY(EditAnywhere, Category = "Simulation", meta = (ClampMin = "10", ClampMax = "240"))
+    float SimulationStepRate = 60.0f;
+
+    // Most steps one frame can catch up on; a longer hitch slows the game for that frame instead of bursting
+    UPROPERTY(EditAnywhere, Category = "Simulation", meta = (ClampMin = "1"))
+    int32 MaxSimulationCatchUpSteps = 4;
+
+    // Steps between launching a combo or market task and applying its result. Workers get that long before the
+    // game thread has to wait, which a frame running one step rarely does; the step itself never depends on them.
+    UPROPERTY(EditAnywhere, Category = "Simulation", meta = (ClampMin = "1"))
+    int32 RuleTaskLatencySteps = 2;
+
+    // Seed for pieces, market moves and events; 0 picks one at BeginPlay (logged, so a run can be replayed)
+    UPROPERTY(EditAnywhere, Category = "Simulation")
+    int32 RandomSeed = 0;
+
+    // Runs Steps simulation steps, also while paused (console: StepSimulation 1)
+    UFUNCTION(Exec, BlueprintCallable, Category = "Simulation")
+    void StepSimulation(int32 Steps = 1);
+
+    // Simulation speed multiplier, 1 = normal (console: SetSimulationSpeed 0.5)
+    UFUNCTION(Exec, BlueprintCallable, Category = "Simulation")
+    void SetSimulationSpeed(float Speed);
+
+    bool IsSimulationPaused() const { return SimClock.IsPaused(); }
+
+    // Settled boards kept for rewinding, one per piece dealt; a few hundred bytes each
+    UPROPERTY(EditAnywhere, Category = "Rewind", meta = (ClampMin = "1"))
+    int32 RewindCapacity = 256;
+
+    // Puts the board back as it was when the piece Pieces before the current one was dealt; 0 restarts the
+    // current piece (console: RewindPieces 1)
+    UFUNCTION(Exec, BlueprintCallable, Category = "Rewind")
+    void RewindPieces(int32 Pieces = 1);
+
+    // Goes back to the last piece dealt at least Seconds of game time ago (console: RewindSeconds 30)
+    UFUNCTION(Exec, BlueprintCallable, Category = "Rewind")
+    void RewindSeconds(float Seconds);
     UClass* SecClass;
-    FTetrominoShape NextTetrominoShape;
-    TArray<AActor*> NextTetrominoBlocks;
+    // upcoming pieces are data only; the preview draws them from cached thumbnails
+    TArray<FUpcomingPiece> UpcomingPieces;
+    bool bPreviewUpToDate = false;
     void SpawnDeadlySecRow();
     void SpawnOfficerTetromino();
     bool ShouldSpawnOfficerTetromino;
@@ -193,14 +456,34 @@ public:
     int32 RoundsBeforeSecSpawn = 10;
     int32 RoundsLeftBeforeSecSpawn;
 
-    void PrepareFirstTetromino();
-    void PrepareNextTetromino();
-    void PrepareOfficerTetromino();
+    FUpcomingPiece MakeRandomPiece() const;
+    FUpcomingPiece MakeOfficerPiece() const;
+    FUpcomingPiece PopUpcomingPiece();
+    void RefillUpcomingPieces();
+    void UpdatePiecePreview();
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combo Target")
-    FString ComboTarget;
+    UPROPERTY(Transient)
+    UPiecePreviewCache* PiecePreviewCache;
+
+    UPROPERTY(Transient)
+    UNextPiecePreviewWidget* NextPiecePreviewWidget;
+
+    // Token id the combo meter is chasing; INDEX_NONE until the tokens have loaded
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combo Target")
+    int32 ComboTargetToken = INDEX_NONE;
     void UpdateComboTarget();
 
+    // GetComboTargetName as of the last change to ComboTargetToken; W_MainMarket binds to it
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combo Target")
+    FString ComboTarget;
+
+    // Name of the combo target's ticker artwork ("<token>_circ"), made for the UI on request
+    UFUNCTION(BlueprintPure, Category = "Combo Target")
+    FString GetComboTargetName() const;
+
+    UFUNCTION(BlueprintPure, Category = "Combo Target")
+    UTexture2D* GetComboTargetTexture() const;
+
     UFUNCTION(BlueprintCallable, Category = "SEC Raid")
     void ClearOfficerBlocks();
 
@@ -217,8 +500,7 @@ public:
 
 private:
     TArray<AActor*> CurrentTetrominoBlocks;
-    FVector SpawnLocation;
-    FVector NextTetrominoSpawnLocation;
+    FVector SpawnLocation;              // board-local
     float BlockFallSpeed;
     bool bIsBlockFalling;
     bool bIsAnimating;
@@ -226,21 +508,106 @@ private:
     void OnAnimationComplete();
 
     TArray<TArray<AActor*>> Grid; // 2D array to represent the grid
-    FTimerHandle UpdateMarketValuesTimer;
-    FTimerHandle UpdateMarketEventsTimer;
-    FTimerHandle SpawnDeadlySecRowTimer;
-    FTimerHandle UpdateComboTargetTimer;
+    FSimTimerHandle UpdateMarketValuesTimer;
+    FSimTimerHandle UpdateMarketEventsTimer;
+    FSimTimerHandle SpawnDeadlySecRowTimer;
+    FSimTimerHandle UpdateComboTargetTimer;
     float BlockFallDelay;
 
-    void MoveTetromino(const FVector2D& Direction);
+    bool MoveTetromino(const FVector2D& Direction);
     void MoveTetrominoDown();
     void SetGrid(int32 x, int32 y, AActor* actor);
     AActor* IsGridOccupied(int32 x, int32 y) const;
+
+    // Cell <-> world mapping goes through this board's own transform so boards can be placed anywhere
+    static constexpr float CellSize = 100.0f;
+    static constexpr float BoardOffsetX = -1000.0f;
     FVector GridToWorld(int32 x, int32 y) const;
+    FIntPoint WorldToGrid(const FVector& WorldLocation) const;
+    FVector BoardToWorld(const FVector& LocalLocation) const;
 
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
-    FTimerHandle TetrominoFallTimerHandle;
+    FSimulationClock SimClock;
+    FSimTimerManager SimTimers;
+    FRandomStream BoardRandom;
+    FRandomStream GarbageRandom; // versus garbage rows only
+    void RunSimulationStep(uint64 Step);
+
+    // Frames hold the scalar state (SerializeRewindState) then one class id, anchor and tag set per cell;
+    // restoring hands every block back to the pool and takes it out again for its restored cell
+    FBoardRewindBuffer Rewind;
+    UPROPERTY(Transient)
+    TArray<UClass*> RewindClasses; // by id; 0 is an empty cell
+    TMap<const UClass*, uint8> RewindClassIds;
+    void SerializeRewindState(FArchive& Ar);
+    void RecordRewindFrame();
+    bool RestoreRewindFrame(int32 StepsBack);
+    uint8 GetRewindClassId(UClass* Class);
+
+    // Input callbacks only queue commands with their arrival time; each simulation step applies what is queued
+    // before anything else runs, so catch-up steps in one frame don't all see the same input
+    FBoardInputQueue InputQueue;
+    TArray<FBoardInputCommand> DrainedInput; // applied by the last step
+    void CreateDefaultInputActions();
+    void ProcessInputCommands(uint64 Step);
+    void OnMoveLeftPressed();
+    void OnMoveLeftReleased();
+    void OnMoveRightPressed();
+    void OnMoveRightReleased();
+    void OnRotatePressed();
+    void OnSoftDropPressed();
+    void OnSoftDropReleased();
+
+    // Callbacks land here; a client's board sends them to the server, which owns the game
+    void ReceiveBoardInput(EBoardCommand Command, bool bPressed);
+    void QueueBoardInput(EBoardCommand Command, bool bPressed, double Timestamp);
+    UFUNCTION(Server, Reliable)
+    void ServerBoardInput(uint8 Command, bool bPressed);
+
+    // Replication: the server publishes packed cells when the board generation moves on and the falling piece as
+    // shape, rotation and pivot; clients rebuild block actors from them and run no gameplay of their own
+    UPROPERTY(ReplicatedUsing = OnRep_NetKeyframe)
+    FBoardNetCells NetKeyframe;
+    UPROPERTY(ReplicatedUsing = OnRep_NetDelta)
+    FBoardNetCells NetDelta;
+    UPROPERTY(ReplicatedUsing = OnRep_NetPiece)
+    FBoardNetPiece NetPiece;
+    TArray<uint16> NetKeyframeCells;  // decoded NetKeyframe
+    uint32 NetKeyframeSequence = 0;   // which keyframe NetKeyframeCells holds
+    uint32 NetSequence = 0;
+    uint32 NetPublishedGeneration = 0;
+    int64 NetBytesSent = 0;
+    int32 NetUpdatesSent = 0;
+    TArray<uint16> NetShownCells;     // client: what the grid's actors show
+    FBoardNetPiece NetShownPiece;
+    UPROPERTY(Transient)
+    TArray<AActor*> NetPieceBlocks;   // client: the falling piece
+    int32 CurrentPieceShape = INDEX_NONE;
+    int32 CurrentPieceRotation = 0;
+    uint16 GetNetCellCode(int32 x, int32 y) const;
+    UClass* GetNetCellClass(uint16 Code) const;
+    void PublishNetBoard();
+    void PublishNetPiece();
+    void MakeNetPiece(FBoardNetPiece& OutPiece) const;
+    void ApplyNetBoard();
+    void ApplyNetPiece();
+    UFUNCTION()
+    void OnRep_NetKeyframe();
+    UFUNCTION()
+    void OnRep_NetDelta();
+    UFUNCTION()
+    void OnRep_NetPiece();
+    UFUNCTION()
+    void OnRep_Score();
+    UFUNCTION()
+    void OnRep_Combos();
+
+    int32 PendingGarbageRows = 0;
+    // False when the garbage pushed blocks out of the top and ended the game
+    bool ApplyPendingGarbage();
+
+    FSimTimerHandle TetrominoFallTimerHandle;
     float CurrentFallInterval;
     float DefaultFallInterval = 0.5f;
     float BullRunFallInterval = 0.7f;
@@ -249,10 +616,38 @@ private:
 
     void InitializeTetrominoShapesAndBlueprints();
 
-    FTetrisBlockValue* FindPointValueByName(const FString Input);
-    int32 FindPointValueIndexByName(const FString Input);
+    // Token list and the classes it names; PointValues, TetrominoBlueprints and SuperBlocks are built from it by id
+    UPROPERTY(Transient)
+    UTokenRegistry* TokenRegistry;
+    TSharedPtr<FStreamableHandle> TokenLoadHandle;
+    TMap<const UClass*, uint8> TokenIdByClass; // block and super block classes
+    void LoadTokenRegistry();
+    void OnTokenRegistryLoaded();
+    void LoadTokenAssets();
+    void OnTokenAssetsLoaded();
+    void StartBoard();
+    int32 GetTokenId(const AActor* Actor) const;
+
+    // UI changes collected during the frame, flushed from Tick
+    FBoardUIDelta PendingUIDelta;
+    void MarkTokenChanged(int32 TokenIndex);
+    void MarkScoreChanged();
+    void MarkNotchesChanged();
+    void FlushUIDelta();
+
+    FMarketEngine Market;
+    FRandomStream MarketRandom;
+    uint64 HighRiskTokenMask = 0;  // bit per token id
+    uint64 StablecoinTokenMask = 0;
+    int32 MarketStressTickCounter = 0;
+    void InitializeMarket();
+    int32 GetBlockScoreValue(int32 TokenIndex) const;
+
+    // one stream per PointValues entry, null where a token has no series
+    TArray<TUniquePtr<FHistoricalPriceStream>> PriceStreams;
+    double ReplayTime = 0.0;
+    void OpenHistoricalReplay();
 
-    UTexture2D* GetTexture(FString source);
     void SpawnNiagaraSystem(FString Source, FVector SpawnLoc, FLinearColor ExplosionColor1, FLinearColor ExplosionColor2);
     void UpdateGridAtLocation(FVector Location);
     void MoveBlocksDown();
@@ -274,12 +669,12 @@ private:
 
     // void MoveBlockDown(AActor* Block, int32 DropDistance);
     void MoveBlocksToDropDown();
-    TMap<AActor*, int32> BlocksToDrop;
-    FTimerHandle MoveBlocksTimerHandle;
+    TMap<TWeakObjectPtr<AActor>, int32> BlocksToDrop;
+    FSimTimerHandle MoveBlocksTimerHandle;
     float BlockMoveInterval = 0.2f;
 
     void MoveBlocksDownIncrementally();
-    TArray<AActor*> BlocksToMove;
+    TArray<TWeakObjectPtr<AActor>> BlocksToMove;
     TArray<int32> RowsToMove;
     bool CanMoveDown(int32 x, int32 y);
 
@@ -287,13 +682,14 @@ private:
     int32 DropY1;              // Tracks the current y-coordinate of the block
     int32 DropLoopIndex;       // Tracks the loop iteration
     int32 DropDistance;        // Stores how far the block should drop
-    FTimerHandle DropTimerHandle; // Timer handle for the drop operation
+    FSimTimerHandle DropTimerHandle; // Timer handle for the drop operation
     void HandleDrop();         // Function to handle the drop logic
     void HandleMultipleDrops();
     TArray<FDropState> DropsArray; // Tracks all active drops
     bool bAnyDropInProgress;
-    FTimerHandle CheckIfReadyToSpawnTetromino;
+    FSimTimerHandle CheckIfReadyToSpawnTetromino;
     void CheckIfReadyForNewTetromino();
+    void DealNextPiece();
     void CheckForBlocksToDrop();
 
     // glow super blocks
@@ -303,12 +699,17 @@ private:
     void UpdateSuperDuperGlowMaterial();
     void MakeSuperBlock();
     void MakeSuperDuperBlock();
-    FTimerHandle GlowTimerHandle;
+    void CheckForCombosIfSettled();
+    FSimTimerHandle GlowTimerHandle;
+    UPROPERTY(Transient)
     TArray<UMaterialInstanceDynamic*> GlowMaterials;
     float GlowFactorStart = 0.0;
     float GlowFactorEnd = 1.0f;
     float GlowPowerStart = 1.0f;
     float GlowPowerEnd = 5.0f;
+    float CurrentGlowFactor = 0.0f; // where the running glow animation is, for instanced blocks
+    float CurrentGlowPower = 1.0f;
+    bool IsBatchingSettledBlocks() const { return BoardStateQuad->IsRenderingBoard() || BlockInstances->IsRenderingBlocks(); }
     float AnimationDuration = 2.0f; // Duration in seconds
     FGlowBlockAnimationData TargetActors;
     TArray<FVector> InitialScales;
@@ -322,7 +723,57 @@ private:
     // debugging
     void PrintScreen(FString message, float showDuration = 5.f);
 
-    void IncrementScore(int32 TargetScore);
+    // score is added to the ledger during a pass and committed once per frame from Tick
+    FScoreLedger ScoreLedger;
+
+    void RegisterAudioCues();
+
+    // shakes, effects, sounds and popups requested this frame, executed from Tick
+    FPresentationCommandBuffer Presentation;
+    void FlushPresentation();
+
+    // stage timings and resource counts for the perf HUD
+    FBoardPerfCounters PerfCounters;
+    FBoardPerfSnapshot PerfSnapshot;
+    FBoardArenaStats PerfArenaStats; // totals at the last refresh
+    float PerfSnapshotAge = 0.0f;
+    float MemorySampleAge = 0.0f; // peaks for BlockchainBreakout.MemReport
+    TArray<TWeakObjectPtr<UNiagaraComponent>> ActiveNiagaraComponents;
+    void PruneNiagaraComponents();
+    void TrackNiagaraComponent(UNiagaraComponent* Component);
+    void RefreshPerfSnapshot();
+
+    UPROPERTY(Transient)
+    UBoardPerfHUDWidget* PerfHUDWidget;
+
+    FBoardSoakMonitor SoakMonitor;
+    bool bSoakExitWhenDone = false;
+    FRandomStream SoakRandom;
+    void TickSoakInput();
+    void FinishBoardSoak();
+    void ReportBoardSoak(bool bPassed);
+
+    // Simulation parity: each lock is predicted from the board before it and checked at the next lock
+    void PredictLockInSimulation();
+    void CheckSimulationParity();
+    FBreakoutSimConfig ParityConfig;
+    uint64 ParityExpectedHash = 0;
+    bool bParityPending = false;
+    int32 ParityMatched = 0;
+    int32 ParityMismatched = 0;
+    int32 ParitySkipped = 0;
+
+    bool bBombCheckPending = false;
+    double BombCheckDeadline = 0.0;
+    void FinishBombCheck(bool bPassed);
+
+    bool bEventLogStarted = false;
+    void RecordEvent(EGameplayEventType Type, int32 X = 0, int32 Y = 0, int64 Value = 0) const
+    {
+        FGameplayEventLog::Record(Type, (uint16)GetUniqueID(), X, Y, Value);
+    }
+    void AddScore(EScoreSource Source, int32 Value);
+    void CommitScore();
 
     UMaterialInstanceDynamic* GlowMaterialForBoard;
     UMaterialInstanceDynamic* BackgroundMaterialForBoard;
@@ -330,8 +781,8 @@ private:
     UClass* TetrisBoard;
     AActor* TetrisBoardInstance;
     void SetVictoryBoardMaterial(float ColorPickerValue, FVector BackgroundColor, float VictorySwitch);
-    FTimerHandle VictoryTimerHandle;
-    FTimerHandle BlinkBoardTimerHandle;
+    FSimTimerHandle VictoryTimerHandle;
+    FSimTimerHandle BlinkBoardTimerHandle;
     void BlinkBoardColors();
     void Blink();
     float BlinkDuration = 3.0f;
@@ -342,6 +793,22 @@ private:
     bool bIsClearing = false;
     void NextLevel();
 
+    // settled token blocks by PointValues index, kept in step with Grid by SetGrid
+    FTokenBitPlanes TokenPlanes;
+
+    // Zobrist hash of the settled cells, kept in step with Grid by SetGrid; a tag change on a settled block needs
+    // a RehashCell of its own
+    FBoardZobrist BoardHash;
+    void RehashCell(int32 x, int32 y);
+    // False (and the running hash replaced) when it has drifted from the grid
+    bool VerifyBoardHash();
+
+    // Fills the block pool and loads the effects the next level needs while the board blinks
+    void WarmUpNextLevel();
+
+    UPROPERTY(Transient)
+    TArray<UObject*> WarmAssets;
+
     UClass* BombBlockClass;
     void SpawnBombExplosion(AActor* Actor);
 };
\ No newline at end of file